@@ -0,0 +1,91 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Replay a branch trace through one or more branch predictors without
+# simulating a CPU. Record a trace by attaching a recorder to the CPU of
+# any other simulation, e.g.
+#
+#   system.cpu.branch_trace = BranchTraceRecorder(manager=system.cpu)
+#
+# and evaluate predictors on it with
+#
+#   gem5.opt configs/example/bpred_trace.py \
+#       --bp-type=TournamentBP --bp-type=LTAGE --bp-type=TAGE_SC_L_64KB \
+#       --host-threads=3 m5out/branches.trace.gz
+#
+# The misprediction rate of every predictor is reported in its replay
+# statistics group.
+
+import argparse
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, fatal
+
+addToPath('../')
+
+from common import ObjectList
+
+parser = argparse.ArgumentParser(
+    description="Replay a branch trace through branch predictors.")
+parser.add_argument("trace", help="branch trace recorded by a "
+                    "BranchTraceRecorder")
+parser.add_argument("--bp-type", action="append", default=[],
+                    choices=ObjectList.bp_list.get_names(),
+                    help="branch predictor to evaluate, may be repeated")
+parser.add_argument("--indirect-bp-type", default=None,
+                    choices=ObjectList.indirect_bp_list.get_names(),
+                    help="indirect branch predictor of all the predictors")
+parser.add_argument("--inst-shift-amt", type=int, default=2,
+                    help="number of bits to shift PCs by in the predictors, "
+                    "0 for ISAs with variable length instructions")
+parser.add_argument("--num-threads", type=int, default=1,
+                    help="number of hardware threads in the trace")
+parser.add_argument("--host-threads", type=int, default=1,
+                    help="number of host threads replaying predictors in "
+                    "parallel")
+
+args = parser.parse_args()
+
+if not args.bp_type:
+    fatal("At least one --bp-type is required.")
+
+predictors = []
+for bp_type in args.bp_type:
+    bp = ObjectList.bp_list.get(bp_type)()
+    bp.instShiftAmt = args.inst_shift_amt
+    if args.indirect_bp_type:
+        bp.indirectBranchPred = \
+            ObjectList.indirect_bp_list.get(args.indirect_bp_type)()
+    predictors.append(bp)
+
+root = Root(full_system=False)
+root.player = BranchTracePlayer(trace_file=args.trace,
+                                predictors=predictors,
+                                numThreads=args.num_threads,
+                                host_threads=args.host_threads)
+
+m5.instantiate()
+exit_event = m5.simulate()
+print('Exiting @ tick %i because %s' %
+      (m5.curTick(), exit_event.getCause()))
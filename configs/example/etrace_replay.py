@@ -33,7 +33,12 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
-# Basic elastic traces replay script that configures a Trace CPU
+# Basic elastic traces replay script that configures a Trace CPU. With
+# --num-cpus greater than one, --inst-trace-file and --data-trace-file take
+# comma-separated lists with one trace per CPU. The Trace CPUs share the
+# cache hierarchy below their L1s and memory, and replay in lockstep as
+# they are driven by the same event queue. Data traces can be protobuf
+# traces or packed traces made by util/pack_inst_dep_trace.py.
 
 import argparse
 
@@ -63,15 +68,20 @@ if args.cpu_type != "TraceCPU":
     fatal("This is a script for elastic trace replay simulation, use "\
             "--cpu-type=TraceCPU\n");
 
-if args.num_cpus > 1:
-    fatal("This script does not support multi-processor trace replay.\n")
+inst_trace_files = args.inst_trace_file.split(',')
+data_trace_files = args.data_trace_file.split(',')
+if len(inst_trace_files) != args.num_cpus or \
+   len(data_trace_files) != args.num_cpus:
+    fatal("Expected %d instruction and data trace files, one per Trace CPU, "
+          "got %d and %d.\n", args.num_cpus, len(inst_trace_files),
+          len(data_trace_files))
 
 # In this case FutureClass will be None as there is not fast forwarding or
 # switching
 (CPUClass, test_mem_mode, FutureClass) = Simulation.setCPUClass(args)
 CPUClass.numThreads = numThreads
 
-system = System(cpu = CPUClass(cpu_id=0),
+system = System(cpu = [CPUClass(cpu_id=i) for i in range(args.num_cpus)],
                 mem_mode = test_mem_mode,
                 mem_ranges = [AddrRange(args.mem_size)],
                 cache_line_size = args.cacheline_size)
@@ -103,9 +113,11 @@ for cpu in system.cpu:
 for cpu in system.cpu:
     cpu.createThreads()
 
-# Assign input trace files to the Trace CPU
-system.cpu.instTraceFile=args.inst_trace_file
-system.cpu.dataTraceFile=args.data_trace_file
+# Assign input trace files to the Trace CPUs
+for cpu, inst_trace, data_trace in \
+        zip(system.cpu, inst_trace_files, data_trace_files):
+    cpu.instTraceFile = inst_trace
+    cpu.dataTraceFile = data_trace
 
 # Configure the classic memory system args
 MemClass = Simulation.setMemClass(args)
@@ -49,6 +49,10 @@ class ArmTLB(BaseTLB):
     cxx_header = "arch/arm/tlb.hh"
     sys = Param.System(Parent.any, "system object parameter")
     size = Param.Int(64, "TLB size")
+    assoc = Param.Int(Self.size, "TLB associativity (size / assoc must be "
+        "a power of two); fully associative by default")
+    micro_tlb_size = Param.Int(0, "Number of recently hit translations "
+        "checked before the TLB sets are probed; disabled by default")
     is_stage2 = Param.Bool(False, "Is this a stage 2 TLB?")
 
     partial_levels = VectorParam.ArmLookupLevel([],
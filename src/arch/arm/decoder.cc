@@ -52,7 +52,8 @@ namespace gem5
 namespace ArmISA
 {
 
-GenericISA::BasicDecodeCache<Decoder, ExtMachInst> Decoder::defaultCache;
+thread_local GenericISA::BasicDecodeCache<Decoder, ExtMachInst>
+    Decoder::defaultCache;
 
 Decoder::Decoder(const ArmDecoderParams &params)
     : InstDecoder(params, &data),
@@ -86,8 +86,10 @@ class Decoder : public InstDecoder
 
     enums::DecoderFlavor decoderFlavor;
 
-    /// A cache of decoded instruction objects.
-    static GenericISA::BasicDecodeCache<Decoder, ExtMachInst> defaultCache;
+    /// A cache of decoded instruction objects, shared by the decoders
+    /// simulated by the same host thread.
+    static thread_local GenericISA::BasicDecodeCache<Decoder, ExtMachInst>
+        defaultCache;
     friend class GenericISA::BasicDecodeCache<Decoder, ExtMachInst>;
 
     /**
@@ -128,7 +130,8 @@ class Decoder : public InstDecoder
     StaticInstPtr
     decode(ExtMachInst mach_inst, Addr addr)
     {
-        StaticInstPtr si = defaultCache.decode(this, mach_inst, addr);
+        const StaticInstPtr &si =
+            defaultCache.decode(this, mach_inst, addr);
         DPRINTF(Decode, "Decode: Decoded %s instruction: %#x\n",
                 si->getName(), mach_inst);
         return si;
@@ -148,6 +151,8 @@ class Decoder : public InstDecoder
     void
     setContext(FPSCR fpscr)
     {
+        if (fpscrLen != fpscr.len || fpscrStride != fpscr.stride)
+            contextChanged();
         fpscrLen = fpscr.len;
         fpscrStride = fpscr.stride;
     }
@@ -155,6 +160,8 @@ class Decoder : public InstDecoder
     void
     setSveLen(uint8_t len)
     {
+        if (sveLen != len)
+            contextChanged();
         sveLen = len;
     }
 };
@@ -1512,6 +1512,8 @@ ISA::setMiscReg(int misc_reg, RegVal val)
           case MISCREG_DBGDSCRext:
             {
                 selfDebug->setMDBGen(val);
+                // Watchpoints are checked on translation
+                getMMUPtr(tc)->invalidateTranslationCaches();
                 DBGDS32 r = tc->readMiscReg(MISCREG_DBGDSCRint);
                 DBGDS32 v = val;
                 r.moe = v.moe;
@@ -1525,6 +1527,7 @@ ISA::setMiscReg(int misc_reg, RegVal val)
           case MISCREG_MDSCR_EL1:
             {
                 selfDebug->setMDSCRvals(val);
+                getMMUPtr(tc)->invalidateTranslationCaches();
             }
             break;
 
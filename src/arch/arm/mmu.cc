@@ -199,6 +199,18 @@ MMU::invalidateMiscReg()
     s1State.miscRegValid = false;
     s1State.computeAddrTop.flush();
     s2State.computeAddrTop.flush();
+    invalidateTranslationCaches();
+}
+
+bool
+MMU::translationCacheable(const RequestPtr &req, ThreadContext *tc,
+                          Mode mode) const
+{
+    // Self-hosted debug and the test interface check every access on
+    // its own, while SE mode translations follow the process page
+    // table which changes without any TLB maintenance.
+    return FullSystem && !test &&
+        !ArmISA::ISA::getSelfDebug(tc)->enabled();
 }
 
 Fault
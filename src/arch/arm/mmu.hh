@@ -297,6 +297,9 @@ class MMU : public BaseMMU
 
     void invalidateMiscReg();
 
+    bool translationCacheable(const RequestPtr &req, ThreadContext *tc,
+                              Mode mode) const override;
+
     template <typename OP>
     void
     flush(const OP &tlbi_op)
@@ -314,6 +317,7 @@ class MMU : public BaseMMU
     void
     flushStage1(const OP &tlbi_op)
     {
+        invalidateTranslationCaches();
         for (auto tlb : instruction) {
             static_cast<TLB*>(tlb)->flush(tlbi_op);
         }
@@ -329,6 +333,7 @@ class MMU : public BaseMMU
     void
     flushStage2(const OP &tlbi_op)
     {
+        invalidateTranslationCaches();
         itbStage2->flush(tlbi_op);
         dtbStage2->flush(tlbi_op);
     }
@@ -337,6 +342,7 @@ class MMU : public BaseMMU
     void
     iflush(const OP &tlbi_op)
     {
+        invalidateTranslationCaches();
         for (auto tlb : instruction) {
             static_cast<TLB*>(tlb)->flush(tlbi_op);
         }
@@ -349,6 +355,7 @@ class MMU : public BaseMMU
     void
     dflush(const OP &tlbi_op)
     {
+        invalidateTranslationCaches();
         for (auto tlb : data) {
             static_cast<TLB*>(tlb)->flush(tlbi_op);
         }
@@ -40,6 +40,8 @@
 
 #include "arch/arm/tlb.hh"
 
+#include <algorithm>
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
@@ -47,6 +49,7 @@
 #include "arch/arm/table_walker.hh"
 #include "arch/arm/tlbi_op.hh"
 #include "arch/arm/utility.hh"
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "cpu/thread_context.hh"
 #include "debug/TLB.hh"
@@ -60,11 +63,18 @@ using namespace ArmISA;
 
 TLB::TLB(const ArmTLBParams &p)
     : BaseTLB(p), table(new TlbEntry[p.size]), size(p.size),
+      assoc(p.assoc), numSets(p.assoc > 0 ? p.size / p.assoc : 0),
+      lastUsed(p.size, 0), lruClock(0),
+      microTlb(p.micro_tlb_size, -1), microTlbNext(0), numValid(0),
       isStage2(p.is_stage2),
       _walkCache(false),
       tableWalker(nullptr),
-      stats(*this), rangeMRU(1), vmid(0)
+      stats(*this), vmid(0)
 {
+    fatal_if(assoc <= 0 || size % assoc != 0 || !isPowerOf2(numSets),
+        "%s: TLB size (%d) must be a power of two multiple of the "
+        "associativity (%d)\n", name(), size, assoc);
+
     for (int lvl = LookupLevel::L0;
          lvl < LookupLevel::Num_ArmLookupLevel; lvl++) {
 
@@ -102,52 +112,117 @@ TLB::setTableWalker(TableWalker *table_walker)
     tableWalker->setTlb(this);
 }
 
+unsigned
+TLB::entryShift(const TlbEntry &entry)
+{
+    return floorLog2(entry.size + 1);
+}
+
+int
+TLB::setIndex(Addr va, unsigned shift) const
+{
+    // Fold the upper page number bits into the index so that large
+    // regions of equally aligned pages don't pile up in one set
+    const Addr page = va >> shift;
+    const unsigned set_bits = floorLog2(numSets);
+    return (page ^ (page >> set_bits) ^ shift) & (numSets - 1);
+}
+
+template <typename Visit>
+void
+TLB::forEachCandidate(Addr va, Visit visit)
+{
+    // One set per page size present, skipping sets already visited
+    // (with a fully associative TLB all page sizes share the one set)
+    std::array<int, 16> visited;
+    unsigned num_visited = 0;
+
+    for (const auto &page_shift : pageShifts) {
+        const int set = setIndex(va, page_shift.first);
+
+        if (std::find(visited.begin(), visited.begin() + num_visited, set) !=
+            visited.begin() + num_visited) {
+            continue;
+        }
+        if (num_visited < visited.size())
+            visited[num_visited++] = set;
+
+        for (int idx = set * assoc; idx < (set + 1) * assoc; idx++) {
+            if (visit(idx))
+                return;
+        }
+    }
+}
+
 TlbEntry*
 TLB::match(const Lookup &lookup_data)
 {
-    // Vector of TLB entry candidates.
-    // Only one of them will be assigned to retval and will
-    // be returned to the MMU (in case of a hit)
-    // The vector has one entry per lookup level as it stores
-    // both complete and partial matches
-    std::vector<std::pair<int, const TlbEntry*>> hits{
-        LookupLevel::Num_ArmLookupLevel, {0, nullptr}};
-
-    int x = 0;
-    while (x < size) {
-        if (table[x].match(lookup_data)) {
-            const TlbEntry &entry = table[x];
-            hits[entry.lookupLevel] = std::make_pair(x, &entry);
-
-            // This is a complete translation, no need to loop further
-            if (!entry.partial)
-                break;
+    // Recently hit complete translations first.  A complete translation
+    // takes priority over any partial one so a hit here is final
+    for (int idx : microTlb) {
+        if (idx >= 0 && !table[idx].partial &&
+            table[idx].match(lookup_data)) {
+            if (!lookup_data.functional) {
+                lastUsed[idx] = ++lruClock;
+                stats.microTlbHits++;
+            }
+            return &table[idx];
         }
-        ++x;
     }
 
-    // Loop over the list of TLB entries matching our translation
-    // request, starting from the highest lookup level (complete
-    // translation) and iterating backwards (using reverse iterators)
+    // The most recently used complete translation, if any
+    int complete = -1;
+    forEachCandidate(lookup_data.va, [&](int idx) {
+        const TlbEntry &entry = table[idx];
+        if (!entry.partial && entry.match(lookup_data) &&
+            (complete < 0 || lastUsed[idx] > lastUsed[complete])) {
+            complete = idx;
+        }
+        return false;
+    });
+
+    // Candidate entries, one per lookup level as they can be both
+    // complete and partial matches.  Only one of them will be
+    // returned to the MMU (in case of a hit).  Entries are ranked as
+    // in a scan from the most to the least recently used one that
+    // stops at the first complete translation: partial matches more
+    // recent than that translation count, and the least recently
+    // used one of each level is kept
+    std::array<int, LookupLevel::Num_ArmLookupLevel> hits;
+    hits.fill(-1);
+
+    forEachCandidate(lookup_data.va, [&](int idx) {
+        const TlbEntry &entry = table[idx];
+        if (entry.partial && entry.match(lookup_data) &&
+            (complete < 0 || lastUsed[idx] > lastUsed[complete])) {
+            int &hit = hits[entry.lookupLevel];
+            if (hit < 0 || lastUsed[idx] < lastUsed[hit])
+                hit = idx;
+        }
+        return false;
+    });
+
+    if (complete >= 0)
+        hits[table[complete].lookupLevel] = complete;
+
+    // Return the match from the highest lookup level (the complete
+    // translation if there is one)
     for (auto it = hits.rbegin(); it != hits.rend(); it++) {
-        const auto& [idx, entry] = *it;
-        if (!entry) {
+        const int idx = *it;
+        if (idx < 0) {
             // No match for the current LookupLevel
             continue;
         }
 
-        // Maintaining LRU array
-        // We only move the hit entry ahead when the position is higher
-        // than rangeMRU
-        if (idx > rangeMRU && !lookup_data.functional) {
-            TlbEntry tmp_entry = *entry;
-            for (int i = idx; i > 0; i--)
-                table[i] = table[i - 1];
-            table[0] = tmp_entry;
-            return &table[0];
-        } else {
-            return &table[idx];
+        if (!lookup_data.functional) {
+            lastUsed[idx] = ++lruClock;
+
+            if (!table[idx].partial && !microTlb.empty()) {
+                microTlb[microTlbNext] = idx;
+                microTlbNext = (microTlbNext + 1) % microTlb.size();
+            }
         }
+        return &table[idx];
     }
 
     return nullptr;
@@ -248,19 +323,49 @@ TLB::insert(TlbEntry &entry)
             entry.ap, static_cast<uint8_t>(entry.domain), entry.ns, entry.nstid,
             entry.isHyp);
 
-    if (table[size - 1].valid)
+    // Pick an invalid way of the entry's set or, failing that, the
+    // least recently used one
+    const unsigned shift = entryShift(entry);
+    const int set = setIndex(entry.vpn << entry.N, shift);
+    int victim = set * assoc;
+    for (int idx = set * assoc; idx < (set + 1) * assoc; idx++) {
+        if (!table[idx].valid) {
+            victim = idx;
+            break;
+        }
+        if (lastUsed[idx] < lastUsed[victim])
+            victim = idx;
+    }
+
+    TlbEntry &old_entry = table[victim];
+    if (old_entry.valid) {
         DPRINTF(TLB, " - Replacing Valid entry %#x, asn %d vmn %d ppn %#x "
                 "size: %#x ap:%d ns:%d nstid:%d g:%d isHyp:%d el: %d\n",
-                table[size-1].vpn << table[size-1].N, table[size-1].asid,
-                table[size-1].vmid, table[size-1].pfn << table[size-1].N,
-                table[size-1].size, table[size-1].ap, table[size-1].ns,
-                table[size-1].nstid, table[size-1].global, table[size-1].isHyp,
-                table[size-1].el);
+                old_entry.vpn << old_entry.N, old_entry.asid,
+                old_entry.vmid, old_entry.pfn << old_entry.N,
+                old_entry.size, old_entry.ap, old_entry.ns,
+                old_entry.nstid, old_entry.global, old_entry.isHyp,
+                old_entry.el);
+        invalidate(victim);
+    }
 
-    // inserting to MRU position and evicting the LRU one
-    for (int i = size - 1; i > 0; --i)
-        table[i] = table[i-1];
-    table[0] = entry;
+    table[victim] = entry;
+    lastUsed[victim] = ++lruClock;
+
+    if (entry.valid) {
+        numValid++;
+
+        auto page_shift = std::lower_bound(pageShifts.begin(),
+            pageShifts.end(), std::make_pair(shift, 0u));
+        if (page_shift == pageShifts.end() || page_shift->first != shift)
+            page_shift = pageShifts.insert(page_shift, {shift, 0});
+        page_shift->second++;
+
+        std::vector<int> &asid_entries = asidEntries[entry.asid];
+        asid_entries.push_back(victim);
+        if (asid_entries.size() > 2 * lastUsed.size())
+            compactAsidEntries(entry.asid);
+    }
 
     stats.inserts++;
     ppRefills->notify(1);
@@ -280,13 +385,71 @@ TLB::multiInsert(TlbEntry &entry)
     }
 }
 
+void
+TLB::invalidate(int idx)
+{
+    TlbEntry &entry = table[idx];
+    assert(entry.valid);
+
+    entry.valid = false;
+    numValid--;
+
+    const unsigned shift = entryShift(entry);
+    auto page_shift = std::lower_bound(pageShifts.begin(),
+        pageShifts.end(), std::make_pair(shift, 0u));
+    assert(page_shift != pageShifts.end() && page_shift->first == shift);
+    if (--page_shift->second == 0)
+        pageShifts.erase(page_shift);
+}
+
+const std::vector<int> &
+TLB::compactAsidEntries(uint16_t asid)
+{
+    std::vector<int> &asid_entries = asidEntries[asid];
+
+    // Drop evicted or invalidated entries and duplicates (from an entry
+    // being replaced by one with the same ASID)
+    std::sort(asid_entries.begin(), asid_entries.end());
+    asid_entries.erase(std::unique(asid_entries.begin(), asid_entries.end()),
+        asid_entries.end());
+    asid_entries.erase(std::remove_if(asid_entries.begin(),
+        asid_entries.end(), [this, asid](int idx) {
+            return !table[idx].valid || table[idx].asid != asid;
+        }), asid_entries.end());
+
+    return asid_entries;
+}
+
+void
+TLB::pruneAsidEntries(uint16_t asid)
+{
+    if (compactAsidEntries(asid).empty())
+        asidEntries.erase(asid);
+}
+
+void
+TLB::pruneAsidEntries()
+{
+    if (numValid == 0) {
+        asidEntries.clear();
+        return;
+    }
+
+    for (auto it = asidEntries.begin(); it != asidEntries.end(); ) {
+        if (compactAsidEntries(it->first).empty())
+            it = asidEntries.erase(it);
+        else
+            ++it;
+    }
+}
+
 void
 TLB::printTlb() const
 {
     int x = 0;
     TlbEntry *te;
     DPRINTF(TLB, "Current TLB contents:\n");
-    while (x < size) {
+    while (x < size && numValid != 0) {
         te = &table[x];
         if (te->valid)
             DPRINTF(TLB, " *  %s\n", te->print());
@@ -300,16 +463,17 @@ TLB::flushAll()
     DPRINTF(TLB, "Flushing all TLB entries\n");
     int x = 0;
     TlbEntry *te;
-    while (x < size) {
+    while (x < size && numValid != 0) {
         te = &table[x];
 
         if (te->valid) {
             DPRINTF(TLB, " -  %s\n", te->print());
-            te->valid = false;
+            invalidate(x);
             stats.flushedEntries++;
         }
         ++x;
     }
+    pruneAsidEntries();
 
     stats.flushTlb++;
 }
@@ -321,7 +485,7 @@ TLB::flush(const TLBIALL& tlbi_op)
             (tlbi_op.secureLookup ? "secure" : "non-secure"));
     int x = 0;
     TlbEntry *te;
-    while (x < size) {
+    while (x < size && numValid != 0) {
         te = &table[x];
         const bool el_match = te->checkELMatch(
             tlbi_op.targetEL, tlbi_op.inHost);
@@ -329,11 +493,12 @@ TLB::flush(const TLBIALL& tlbi_op)
             (te->vmid == vmid || tlbi_op.el2Enabled) && el_match) {
 
             DPRINTF(TLB, " -  %s\n", te->print());
-            te->valid = false;
+            invalidate(x);
             stats.flushedEntries++;
         }
         ++x;
     }
+    pruneAsidEntries();
 
     stats.flushTlb++;
 }
@@ -345,7 +510,7 @@ TLB::flush(const ITLBIALL& tlbi_op)
             (tlbi_op.secureLookup ? "secure" : "non-secure"));
     int x = 0;
     TlbEntry *te;
-    while (x < size) {
+    while (x < size && numValid != 0) {
         te = &table[x];
         const bool el_match = te->checkELMatch(
             tlbi_op.targetEL, tlbi_op.inHost);
@@ -354,11 +519,12 @@ TLB::flush(const ITLBIALL& tlbi_op)
             (te->vmid == vmid || tlbi_op.el2Enabled) && el_match) {
 
             DPRINTF(TLB, " -  %s\n", te->print());
-            te->valid = false;
+            invalidate(x);
             stats.flushedEntries++;
         }
         ++x;
     }
+    pruneAsidEntries();
 
     stats.flushTlb++;
 }
@@ -370,7 +536,7 @@ TLB::flush(const DTLBIALL& tlbi_op)
             (tlbi_op.secureLookup ? "secure" : "non-secure"));
     int x = 0;
     TlbEntry *te;
-    while (x < size) {
+    while (x < size && numValid != 0) {
         te = &table[x];
         const bool el_match = te->checkELMatch(
             tlbi_op.targetEL, tlbi_op.inHost);
@@ -379,11 +545,12 @@ TLB::flush(const DTLBIALL& tlbi_op)
             (te->vmid == vmid || tlbi_op.el2Enabled) && el_match) {
 
             DPRINTF(TLB, " -  %s\n", te->print());
-            te->valid = false;
+            invalidate(x);
             stats.flushedEntries++;
         }
         ++x;
     }
+    pruneAsidEntries();
 
     stats.flushTlb++;
 }
@@ -395,18 +562,19 @@ TLB::flush(const TLBIALLEL &tlbi_op)
             (tlbi_op.secureLookup ? "secure" : "non-secure"));
     int x = 0;
     TlbEntry *te;
-    while (x < size) {
+    while (x < size && numValid != 0) {
         te = &table[x];
         const bool el_match = te->checkELMatch(
             tlbi_op.targetEL, tlbi_op.inHost);
         if (te->valid && tlbi_op.secureLookup == !te->nstid && el_match) {
 
             DPRINTF(TLB, " -  %s\n", te->print());
-            te->valid = false;
+            invalidate(x);
             stats.flushedEntries++;
         }
         ++x;
     }
+    pruneAsidEntries();
 
     stats.flushTlb++;
 }
@@ -418,7 +586,7 @@ TLB::flush(const TLBIVMALL &tlbi_op)
             (tlbi_op.secureLookup ? "secure" : "non-secure"));
     int x = 0;
     TlbEntry *te;
-    while (x < size) {
+    while (x < size && numValid != 0) {
         te = &table[x];
         const bool el_match = te->checkELMatch(
             tlbi_op.targetEL, tlbi_op.inHost);
@@ -432,11 +600,12 @@ TLB::flush(const TLBIVMALL &tlbi_op)
             el_match && vmid_match) {
 
             DPRINTF(TLB, " -  %s\n", te->print());
-            te->valid = false;
+            invalidate(x);
             stats.flushedEntries++;
         }
         ++x;
     }
+    pruneAsidEntries();
 
     stats.flushTlb++;
 }
@@ -450,7 +619,7 @@ TLB::flush(const TLBIALLN &tlbi_op)
             (hyp ? "hyp" : "non-hyp"));
     int x = 0;
     TlbEntry *te;
-    while (x < size) {
+    while (x < size && numValid != 0) {
         te = &table[x];
         const bool el_match = te->checkELMatch(tlbi_op.targetEL, false);
 
@@ -458,10 +627,11 @@ TLB::flush(const TLBIALLN &tlbi_op)
 
             DPRINTF(TLB, " -  %s\n", te->print());
             stats.flushedEntries++;
-            te->valid = false;
+            invalidate(x);
         }
         ++x;
     }
+    pruneAsidEntries();
 
     stats.flushTlb++;
 }
@@ -505,10 +675,9 @@ TLB::flush(const TLBIASID &tlbi_op)
     DPRINTF(TLB, "Flushing TLB entries with asid: %#x (%s lookup)\n",
             tlbi_op.asid, (tlbi_op.secureLookup ? "secure" : "non-secure"));
 
-    int x = 0 ;
     TlbEntry *te;
 
-    while (x < size) {
+    for (int x : compactAsidEntries(tlbi_op.asid)) {
         te = &table[x];
 
         const bool el_match = te->checkELMatch(
@@ -521,12 +690,12 @@ TLB::flush(const TLBIASID &tlbi_op)
             tlbi_op.secureLookup == !te->nstid &&
             vmid_match && el_match) {
 
-            te->valid = false;
+            invalidate(x);
             DPRINTF(TLB, " -  %s\n", te->print());
             stats.flushedEntries++;
         }
-        ++x;
     }
+    pruneAsidEntries(tlbi_op.asid);
     stats.flushTlbAsid++;
 }
 
@@ -536,10 +705,9 @@ TLB::flush(const ITLBIASID &tlbi_op)
     DPRINTF(TLB, "Flushing ITLB entries with asid: %#x (%s lookup)\n",
             tlbi_op.asid, (tlbi_op.secureLookup ? "secure" : "non-secure"));
 
-    int x = 0 ;
     TlbEntry *te;
 
-    while (x < size) {
+    for (int x : compactAsidEntries(tlbi_op.asid)) {
         te = &table[x];
         if (te->type & TypeTLB::instruction &&
             te->valid && te->asid == tlbi_op.asid &&
@@ -547,12 +715,12 @@ TLB::flush(const ITLBIASID &tlbi_op)
             (te->vmid == vmid || tlbi_op.el2Enabled) &&
             te->checkELMatch(tlbi_op.targetEL, tlbi_op.inHost)) {
 
-            te->valid = false;
+            invalidate(x);
             DPRINTF(TLB, " -  %s\n", te->print());
             stats.flushedEntries++;
         }
-        ++x;
     }
+    pruneAsidEntries(tlbi_op.asid);
     stats.flushTlbAsid++;
 }
 
@@ -562,10 +730,9 @@ TLB::flush(const DTLBIASID &tlbi_op)
     DPRINTF(TLB, "Flushing DTLB entries with asid: %#x (%s lookup)\n",
             tlbi_op.asid, (tlbi_op.secureLookup ? "secure" : "non-secure"));
 
-    int x = 0 ;
     TlbEntry *te;
 
-    while (x < size) {
+    for (int x : compactAsidEntries(tlbi_op.asid)) {
         te = &table[x];
         if (te->type & TypeTLB::data &&
             te->valid && te->asid == tlbi_op.asid &&
@@ -573,12 +740,12 @@ TLB::flush(const DTLBIASID &tlbi_op)
             (te->vmid == vmid || tlbi_op.el2Enabled) &&
             te->checkELMatch(tlbi_op.targetEL, tlbi_op.inHost)) {
 
-            te->valid = false;
+            invalidate(x);
             DPRINTF(TLB, " -  %s\n", te->print());
             stats.flushedEntries++;
         }
-        ++x;
     }
+    pruneAsidEntries(tlbi_op.asid);
     stats.flushTlbAsid++;
 }
 
@@ -598,7 +765,6 @@ TLB::_flushMva(Addr mva, uint64_t asn, bool secure_lookup,
                bool ignore_asn, ExceptionLevel target_el, bool in_host,
                TypeTLB entry_type)
 {
-    TlbEntry *te;
     Lookup lookup_data;
 
     lookup_data.va = sext<56>(mva);
@@ -612,15 +778,23 @@ TLB::_flushMva(Addr mva, uint64_t asn, bool secure_lookup,
     lookup_data.inHost = in_host;
     lookup_data.mode = BaseMMU::Read;
 
-    te = lookup(lookup_data);
-    while (te != NULL) {
+    // Invalidating entries can remove page sizes from pageShifts, so
+    // collect the matching entries before invalidating any of them
+    std::vector<int> matching;
+    forEachCandidate(lookup_data.va, [&](int idx) {
+        if (table[idx].match(lookup_data))
+            matching.push_back(idx);
+        return false;
+    });
+
+    for (int idx : matching) {
+        TlbEntry *te = &table[idx];
         bool matching_type = (te->type & entry_type);
-        if (matching_type && secure_lookup == !te->nstid) {
+        if (te->valid && matching_type && secure_lookup == !te->nstid) {
             DPRINTF(TLB, " -  %s\n", te->print());
-            te->valid = false;
+            invalidate(idx);
             stats.flushedEntries++;
         }
-        te = lookup(lookup_data);
     }
 }
 
@@ -633,6 +807,8 @@ TLB::TlbStats::TlbStats(TLB &parent)
   : statistics::Group(&parent), tlb(parent),
     ADD_STAT(partialHits, statistics::units::Count::get(),
              "partial translation hits"),
+    ADD_STAT(microTlbHits, statistics::units::Count::get(),
+             "Hits on recently used translations in the micro TLB"),
     ADD_STAT(instHits, statistics::units::Count::get(), "Inst hits"),
     ADD_STAT(instMisses, statistics::units::Count::get(), "Inst misses"),
     ADD_STAT(readHits, statistics::units::Count::get(), "Read hits"),
@@ -691,6 +867,7 @@ TLB::TlbStats::TlbStats(TLB &parent)
     }
 
     partialHits.flags(statistics::nozero);
+    microTlbHits.flags(statistics::nozero);
 }
 
 void
@@ -41,6 +41,9 @@
 #ifndef __ARCH_ARM_TLB_HH__
 #define __ARCH_ARM_TLB_HH__
 
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "arch/arm/faults.hh"
 #include "arch/arm/pagetable.hh"
@@ -115,11 +118,54 @@ class TlbTestInterface
 class TLB : public BaseTLB
 {
   protected:
+    /** The entries, stored set by set: entry way of set s is at
+     *  table[s * assoc + way] */
     TlbEntry* table;
 
     /** TLB Size */
     int size;
 
+    /** Number of ways per set */
+    int assoc;
+
+    /** Number of sets (size / assoc) */
+    int numSets;
+
+    /** Last use of each entry for LRU replacement within a set */
+    std::vector<uint64_t> lastUsed;
+
+    /** Source of lastUsed values */
+    uint64_t lruClock;
+
+    /**
+     * Page sizes (as log2 of the page size) of the valid entries with a
+     * count of the valid entries of each size, sorted by page size.
+     * Entries are placed in the set indexed by their own page number so
+     * lookups probe one set per page size present in the TLB
+     */
+    std::vector<std::pair<unsigned, unsigned>> pageShifts;
+
+    /**
+     * Micro TLB: indices of the most recently hit complete translations.
+     * These are checked before any set is probed.  A stale index just
+     * fails to match as the entry is matched again on every use
+     */
+    std::vector<int> microTlb;
+
+    /** Next microTlb slot to replace */
+    unsigned microTlbNext;
+
+    /**
+     * Indices of the entries inserted with each ASID, used by the ASID
+     * flushes instead of scanning the whole table.  Indices are not
+     * removed on eviction or invalidation but are filtered out (and the
+     * list compacted) whenever the list is used or grows too large
+     */
+    std::unordered_map<uint16_t, std::vector<int>> asidEntries;
+
+    /** Number of valid entries */
+    int numValid;
+
     /** Indicates this TLB caches IPA->PA translations */
     bool isStage2;
 
@@ -145,6 +191,7 @@ class TLB : public BaseTLB
 
         // Access Stats
         mutable statistics::Scalar partialHits;
+        mutable statistics::Scalar microTlbHits;
         mutable statistics::Scalar instHits;
         mutable statistics::Scalar instMisses;
         mutable statistics::Scalar readHits;
@@ -169,7 +216,6 @@ class TLB : public BaseTLB
     /** PMU probe for TLB refills */
     probing::PMUUPtr ppRefills;
 
-    int rangeMRU; //On lookup, only move entries ahead when outside rangeMRU
     vmid_t vmid;
 
   public:
@@ -336,6 +382,32 @@ class TLB : public BaseTLB
     /** Helper function looking up for a matching TLB entry
      * Does not update stats; see lookup method instead */
     TlbEntry *match(const Lookup &lookup_data);
+
+    /** log2 of the page size of an entry */
+    static unsigned entryShift(const TlbEntry &entry);
+
+    /** The set holding entries of page size 1 << shift mapping va */
+    int setIndex(Addr va, unsigned shift) const;
+
+    /** Call visit(index) on each entry in the sets which can hold a
+     *  translation for va until visit returns true */
+    template <typename Visit>
+    void forEachCandidate(Addr va, Visit visit);
+
+    /** Invalidate a valid entry, updating the page size counts */
+    void invalidate(int idx);
+
+    /** Compact and return the (possibly stale) list of indices of entries
+     *  inserted with the given ASID */
+    const std::vector<int> &compactAsidEntries(uint16_t asid);
+
+    /** Compact the index list of an ASID after a flush, dropping the
+     *  list once it holds no valid entries */
+    void pruneAsidEntries(uint16_t asid);
+
+    /** Compact the index lists of all ASIDs after a flush, dropping the
+     *  lists which hold no valid entries */
+    void pruneAsidEntries();
 };
 
 } // namespace ArmISA
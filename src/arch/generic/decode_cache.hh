@@ -29,6 +29,7 @@
 #ifndef __ARCH_GENERIC_DECODE_CACHE_HH__
 #define __ARCH_GENERIC_DECODE_CACHE_HH__
 
+#include "base/compiler.hh"
 #include "base/types.hh"
 #include "cpu/decode_cache.hh"
 #include "cpu/static_inst_fwd.hh"
@@ -39,40 +40,43 @@ namespace gem5
 namespace GenericISA
 {
 
+/**
+ * A decode cache which can be shared by the decoders of an ISA. The
+ * instructions it hands out have plain reference counts, so a cache and
+ * its instructions must only be used by one simulation thread.
+ */
 template <typename Decoder, typename EMI>
 class BasicDecodeCache
 {
   private:
-    decode_cache::InstMap<EMI> instMap;
-    struct AddrMapEntry
-    {
-        StaticInstPtr inst;
-        EMI machInst;
-    };
+    using InstMap = decode_cache::InstMap<EMI>;
+    InstMap instMap;
+    /// Entries point into instMap, whose elements never move or go
+    /// away, so checking them doesn't touch the reference count of the
+    /// instruction.
+    using AddrMapEntry = const typename InstMap::value_type *;
     decode_cache::AddrMap<AddrMapEntry> decodePages;
 
   public:
     /// Decode a machine instruction.
     /// @param mach_inst The binary instruction to decode.
-    /// @retval A pointer to the corresponding StaticInst object.
-    StaticInstPtr
+    /// @retval A pointer to the corresponding StaticInst object. It
+    /// refers to the cache, which keeps the instruction alive, so looking
+    /// it up doesn't change its reference count.
+    const StaticInstPtr &
     decode(Decoder *const decoder, EMI mach_inst, Addr addr)
     {
-        auto &entry = decodePages.lookup(addr);
-        if (entry.inst && (entry.machInst == mach_inst))
-            return entry.inst;
-
-        entry.machInst = mach_inst;
+        AddrMapEntry &entry = decodePages.lookup(addr);
+        if (GEM5_LIKELY(entry && entry->first == mach_inst))
+            return entry->second;
 
         auto iter = instMap.find(mach_inst);
-        if (iter != instMap.end()) {
-            entry.inst = iter->second;
-            return entry.inst;
+        if (iter == instMap.end()) {
+            iter = instMap.emplace(
+                    mach_inst, decoder->decodeInst(mach_inst)).first;
         }
-
-        entry.inst = decoder->decodeInst(mach_inst);
-        instMap[mach_inst] = entry.inst;
-        return entry.inst;
+        entry = &*iter;
+        return iter->second;
     }
 };
 
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2011 Google
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arch/generic/decode_cache.hh"
+#include "cpu/static_inst.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+std::atomic<int> liveInsts(0);
+
+class TestInst : public StaticInst
+{
+  public:
+    const uint64_t machInst;
+
+    TestInst(uint64_t mach_inst) :
+        StaticInst("test", No_OpClass), machInst(mach_inst)
+    {
+        liveInsts++;
+    }
+
+    ~TestInst() { liveInsts--; }
+
+    Fault
+    execute(ExecContext *xc, Trace::InstRecord *traceData) const override
+    {
+        return NoFault;
+    }
+
+    void advancePC(PCStateBase &pc_state) const override {}
+
+    std::string
+    generateDisassembly(Addr pc,
+            const loader::SymbolTable *symtab) const override
+    {
+        return mnemonic;
+    }
+};
+
+class TestDecoder
+{
+  public:
+    std::atomic<int> decoded;
+
+    TestDecoder() : decoded(0) {}
+
+    StaticInstPtr
+    decodeInst(uint64_t mach_inst)
+    {
+        decoded++;
+        return new TestInst(mach_inst);
+    }
+};
+
+using TestDecodeCache = GenericISA::BasicDecodeCache<TestDecoder, uint64_t>;
+
+uint64_t
+testInst(const StaticInstPtr &inst)
+{
+    return static_cast<const TestInst *>(inst.get())->machInst;
+}
+
+} // anonymous namespace
+
+/** Machine instructions are only decoded the first time they are seen. */
+TEST(DecodeCacheTest, DecodeOnce)
+{
+    TestDecoder decoder;
+    {
+        TestDecodeCache cache;
+
+        StaticInstPtr a = cache.decode(&decoder, 1, 0x1000);
+        EXPECT_EQ(1, testInst(a));
+        EXPECT_EQ(a, cache.decode(&decoder, 1, 0x1000));
+        EXPECT_EQ(a, cache.decode(&decoder, 1, 0x7654000));
+        EXPECT_EQ(1, decoder.decoded);
+
+        // A different instruction at the same address.
+        StaticInstPtr b = cache.decode(&decoder, 2, 0x1000);
+        EXPECT_EQ(2, testInst(b));
+        EXPECT_EQ(2, decoder.decoded);
+        EXPECT_EQ(a, cache.decode(&decoder, 1, 0x1000));
+        EXPECT_EQ(2, decoder.decoded);
+    }
+
+    // The cache kept the instructions alive, and only it.
+    EXPECT_EQ(0, liveInsts);
+}
+
+/**
+ * Look up addresses spread over many chunks and directories, and come
+ * back to them after the recently used directories have been replaced.
+ */
+TEST(DecodeCacheTest, ManyPages)
+{
+    constexpr int num_insts = 64;
+    constexpr Addr num_addrs = 1 << 14;
+
+    TestDecoder decoder;
+    {
+        TestDecodeCache cache;
+        for (int pass = 0; pass < 2; pass++) {
+            for (Addr n = 0; n < num_addrs; n++) {
+                const Addr addr = (n % 4096) * 4 + (n / 4096 << 22);
+                const uint64_t mach_inst = n % num_insts;
+                EXPECT_EQ(mach_inst,
+                          testInst(cache.decode(&decoder, mach_inst, addr)));
+            }
+        }
+        EXPECT_EQ(num_insts, decoder.decoded);
+        EXPECT_EQ(num_insts, liveInsts);
+    }
+    EXPECT_EQ(0, liveInsts);
+}
+
+/**
+ * Decoders keep their cache in a thread_local, so that the instructions,
+ * whose reference counts are not atomic, never reach another simulation
+ * thread. Decode the same instructions from several threads at once and
+ * check that each thread got instructions of its own. Meant to also be
+ * run under ThreadSanitizer.
+ */
+TEST(DecodeCacheTest, PerThreadCaches)
+{
+    constexpr int num_threads = 4;
+    constexpr int num_insts = 64;
+    constexpr Addr num_addrs = 1 << 12;
+
+    TestDecoder decoder;
+    std::atomic<int> mismatches(0);
+    std::atomic<int> started(0);
+    std::atomic<int> finished(0);
+    std::vector<const StaticInst *> firsts(num_threads);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t]() {
+            static thread_local TestDecodeCache cache;
+
+            // Start all together to make the accesses overlap.
+            started++;
+            while (started < num_threads);
+
+            for (Addr n = 0; n < num_addrs; n++) {
+                const uint64_t mach_inst = n % num_insts;
+                StaticInstPtr inst = cache.decode(&decoder, mach_inst, n * 4);
+                if (testInst(inst) != mach_inst)
+                    mismatches++;
+                if (n == 0)
+                    firsts[t] = inst.get();
+            }
+
+            // Keep the caches alive until all threads are done, so the
+            // instructions compared below can't share an address.
+            finished++;
+            while (finished < num_threads);
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(0, mismatches);
+    EXPECT_EQ(num_threads * num_insts, decoder.decoded);
+    for (int t = 1; t < num_threads; t++)
+        EXPECT_NE(firsts[0], firsts[t]);
+    // The caches went away with their threads.
+    EXPECT_EQ(0, liveInsts);
+}
@@ -49,6 +49,15 @@ class InstDecoder : public SimObject
     bool instDone = false;
     bool outOfBytes = true;
 
+    /** Advanced by contextChanged() */
+    uint64_t _contextEpoch = 0;
+
+    /**
+     * Signal that the state the decoder uses besides the instruction
+     * bytes and the PC (e.g. the operating mode) has changed.
+     */
+    void contextChanged() { _contextEpoch++; }
+
   public:
     template <typename MoreBytesType>
     InstDecoder(const InstDecoderParams &params, MoreBytesType *mb_buf) :
@@ -90,8 +99,16 @@ class InstDecoder : public SimObject
     {
         instDone = old->instDone;
         outOfBytes = old->outOfBytes;
+        contextChanged();
     }
 
+    /**
+     * The context epoch changes whenever the same bytes at the same PC
+     * might decode differently than before, so decoded instructions
+     * cached outside of the decoder must be dropped.
+     */
+    uint64_t contextEpoch() const { return _contextEpoch; }
+
     void *moreBytesPtr() const { return _moreBytesPtr; }
     size_t moreBytesSize() const { return _moreBytesSize; }
     Addr pcMask() const { return _pcMask; }
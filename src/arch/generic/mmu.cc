@@ -80,6 +80,8 @@ BaseMMU::init()
 void
 BaseMMU::flushAll()
 {
+    invalidateTranslationCaches();
+
     for (auto tlb : instruction) {
         tlb->flushAll();
     }
@@ -96,6 +98,7 @@ BaseMMU::flushAll()
 void
 BaseMMU::demapPage(Addr vaddr, uint64_t asn)
 {
+    invalidateTranslationCaches();
     itb->demapPage(vaddr, asn);
     dtb->demapPage(vaddr, asn);
 }
@@ -169,6 +172,8 @@ BaseMMU::takeOverFrom(BaseMMU *old_mmu)
 
     itb->takeOverFrom(old_mmu->itb);
     dtb->takeOverFrom(old_mmu->dtb);
+
+    invalidateTranslationCaches();
 }
 
 } // namespace gem5
@@ -111,6 +111,32 @@ class BaseMMU : public SimObject
 
     void demapPage(Addr vaddr, uint64_t asn);
 
+    /**
+     * The translation epoch changes whenever a translation returned by
+     * this MMU might stop being valid: on TLB flushes and on writes to
+     * any state the translation depends on. Consumers caching
+     * translations outside of the MMU (e.g. a CPU's soft TLB) must
+     * drop them when the epoch changes.
+     */
+    uint64_t translationEpoch() const { return _translationEpoch; }
+
+    /** Invalidate translations cached outside of the MMU. */
+    void invalidateTranslationCaches() { _translationEpoch++; }
+
+    /**
+     * Check if the successful translation of req can be reused, until
+     * the translation epoch changes, by any naturally aligned access
+     * with the same flags and mode to the same page. This is only
+     * true for ISAs advancing the epoch on all the state changes
+     * affecting their translation.
+     */
+    virtual bool
+    translationCacheable(const RequestPtr &req, ThreadContext *tc,
+                         Mode mode) const
+    {
+        return false;
+    }
+
     virtual Fault
     translateAtomic(const RequestPtr &req, ThreadContext *tc,
                     Mode mode);
@@ -159,6 +185,9 @@ class BaseMMU : public SimObject
     BaseTLB* itb;
 
   protected:
+    /** Advanced by invalidateTranslationCaches() */
+    uint64_t _translationEpoch = 0;
+
     /**
      * It is possible from the MMU to traverse the entire hierarchy of
      * TLBs, starting from the DTB and ITB (generally speaking from the
@@ -90,6 +90,14 @@ class PCStateBase : public Serializable
     }
     void update(const PCStateBase *ptr) { update(*ptr); }
 
+    /**
+     * Force this PC to reflect a particular value, resetting all its other
+     * fields around it.
+     *
+     * @param val The value to set the PC to.
+     */
+    virtual void set(Addr val) = 0;
+
     virtual void output(std::ostream &os) const = 0;
 
     virtual bool
@@ -359,7 +367,7 @@ class SimplePCState : public PCStateWithNext
      * @param val The value to set the PC to.
      */
     void
-    set(Addr val)
+    set(Addr val) override
     {
         this->pc(val);
         this->npc(val + InstWidth);
@@ -402,7 +410,7 @@ class UPCState : public SimplePCState<InstWidth>
     }
 
     void
-    set(Addr val)
+    set(Addr val) override
     {
         Base::set(val);
         this->upc(0);
@@ -473,7 +481,7 @@ class DelaySlotPCState : public SimplePCState<InstWidth>
     void nnpc(Addr val) { _nnpc = val; }
 
     void
-    set(Addr val)
+    set(Addr val) override
     {
         Base::set(val);
         nnpc(val + 2 * InstWidth);
@@ -547,7 +555,7 @@ class DelaySlotUPCState : public DelaySlotPCState<InstWidth>
     }
 
     void
-    set(Addr val)
+    set(Addr val) override
     {
         Base::set(val);
         this->upc(0);
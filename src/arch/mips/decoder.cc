@@ -34,7 +34,8 @@ namespace gem5
 namespace MipsISA
 {
 
-GenericISA::BasicDecodeCache<Decoder, ExtMachInst> Decoder::defaultCache;
+thread_local GenericISA::BasicDecodeCache<Decoder, ExtMachInst>
+    Decoder::defaultCache;
 
 } // namespace MipsISA
 } // namespace gem5
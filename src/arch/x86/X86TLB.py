@@ -54,7 +54,15 @@ class X86TLB(BaseTLB):
     cxx_class = 'gem5::X86ISA::TLB'
     cxx_header = 'arch/x86/tlb.hh'
 
-    size = Param.Unsigned(64, "TLB size")
+    size = Param.Unsigned(64, "TLB size; the number of 4KiB page entries, "
+            "also holding larger pages without entries of their own")
+    large_page_entries = Param.Unsigned(0, "Number of separate 2MiB/4MiB "
+            "page entries, 0 to keep them with the 4KiB pages")
+    huge_page_entries = Param.Unsigned(0, "Number of separate 1GiB page "
+            "entries, 0 to keep them with the next smaller pages")
+    assoc = Param.Unsigned(0, "Associativity of each array of entries "
+            "(entries / assoc must be a power of two), 0 for fully "
+            "associative")
     system = Param.System(Parent.any, "system object")
     walker = Param.X86PagetableWalker(\
             X86PagetableWalker(), "page table walker")
@@ -243,7 +243,10 @@ class Decoder : public InstDecoder
     decode_cache::InstMap<ExtMachInst> *instMap = nullptr;
     typedef std::unordered_map<
             CacheKey, decode_cache::InstMap<ExtMachInst> *> InstCacheMap;
-    static InstCacheMap instCacheMap;
+    /// Per decoder, like addrCacheMap. The instructions have plain
+    /// reference counts, so they must not be shared with decoders that
+    /// another host thread may be simulating.
+    InstCacheMap instCacheMap;
 
     StaticInstPtr decodeInst(ExtMachInst mach_inst);
 
@@ -266,6 +269,13 @@ class Decoder : public InstDecoder
     void
     setM5Reg(HandyM5Reg m5Reg)
     {
+        if (cpl != m5Reg.cpl || mode != (X86Mode)(uint64_t)m5Reg.mode ||
+                submode != (X86SubMode)(uint64_t)m5Reg.submode ||
+                altOp != m5Reg.altOp || defOp != m5Reg.defOp ||
+                altAddr != m5Reg.altAddr || defAddr != m5Reg.defAddr ||
+                stack != m5Reg.stack) {
+            contextChanged();
+        }
         cpl = m5Reg.cpl;
         mode = (X86Mode)(uint64_t)m5Reg.mode;
         submode = (X86SubMode)(uint64_t)m5Reg.submode;
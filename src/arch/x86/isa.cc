@@ -277,6 +277,9 @@ ISA::setMiscRegNoEffect(int miscReg, RegVal val)
 void
 ISA::setMiscReg(int miscReg, RegVal val)
 {
+    // Control, segment and mode registers all affect translation.
+    tc->getMMUPtr()->invalidateTranslationCaches();
+
     RegVal newVal = val;
     switch(miscReg)
     {
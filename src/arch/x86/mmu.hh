@@ -39,10 +39,14 @@
 #define __ARCH_X86_MMU_HH__
 
 #include "arch/generic/mmu.hh"
+#include "arch/x86/ldstflags.hh"
 #include "arch/x86/page_size.hh"
+#include "arch/x86/regs/misc.hh"
+#include "arch/x86/regs/segment.hh"
 #include "arch/x86/tlb.hh"
-
+#include "cpu/thread_context.hh"
 #include "params/X86MMU.hh"
+#include "sim/full_system.hh"
 
 namespace gem5
 {
@@ -59,10 +63,24 @@ class MMU : public BaseMMU
     void
     flushNonGlobal()
     {
+        invalidateTranslationCaches();
         static_cast<TLB*>(itb)->flushNonGlobal();
         static_cast<TLB*>(dtb)->flushNonGlobal();
     }
 
+    bool
+    translationCacheable(const RequestPtr &req, ThreadContext *tc,
+                         Mode mode) const override
+    {
+        // Outside of long mode, segment limits are checked against
+        // each access. Accesses to the emulation memory segment don't
+        // go through paging at all.
+        HandyM5Reg m5Reg = tc->readMiscRegNoEffect(misc_reg::M5Reg);
+        int seg = req->getFlags() & SegmentFlagMask;
+        return FullSystem && m5Reg.prot && m5Reg.mode == LongMode &&
+            seg != segment_idx::Ms;
+    }
+
     Walker*
     getDataWalker()
     {
@@ -37,6 +37,7 @@
 
 #include "arch/x86/tlb.hh"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 
@@ -47,6 +48,7 @@
 #include "arch/x86/regs/misc.hh"
 #include "arch/x86/regs/msr.hh"
 #include "arch/x86/x86_traits.hh"
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "cpu/thread_context.hh"
 #include "debug/TLB.hh"
@@ -63,82 +65,130 @@ namespace gem5
 namespace X86ISA {
 
 TLB::TLB(const Params &p)
-    : BaseTLB(p), configAddress(0), size(p.size),
-      tlb(size), lruSeq(0), m5opRange(p.system->m5opRange()), stats(this)
+    : BaseTLB(p), configAddress(0),
+      size(p.size + p.large_page_entries + p.huge_page_entries),
+      lruSeq(0), m5opRange(p.system->m5opRange()), stats(this)
 {
-    if (!size)
-        fatal("TLBs must have a non-zero size.\n");
+    const unsigned num_entries[NumPageClasses] =
+        { p.size, p.large_page_entries, p.huge_page_entries };
+    // Large pages are indexed by the bits above 4MiB rather than 2MiB:
+    // legacy non-PAE paging maps 4MiB pages, and indexing those at bit 21
+    // would only ever find them from their lower half.
+    const unsigned page_shift[NumPageClasses] = { 12, 22, 30 };
+
+    // A page size without entries of its own shares the array of the
+    // next smaller one, which is then indexed above the larger page size.
+    // By default all page sizes share one array.
+    unsigned index_shift[NumPageClasses] = {};
+    for (int c = SmallPages; c < NumPageClasses; c++) {
+        classArray[c] = (c == SmallPages || num_entries[c]) ?
+            c : classArray[c - 1];
+        index_shift[classArray[c]] = page_shift[c];
+    }
 
-    for (int x = 0; x < size; x++) {
-        tlb[x].trieHandle = NULL;
-        freeList.push_back(&tlb[x]);
+    fatal_if(p.size == 0, "%s: The TLB must have entries.\n", name());
+    for (int c = SmallPages; c < NumPageClasses; c++) {
+        if (num_entries[c])
+            arrays[c].init(name(), num_entries[c], p.assoc, index_shift[c]);
     }
 
+    lastEntry.fill(nullptr);
+
     walker = p.walker;
     walker->setTLB(this);
 }
 
+TLB::PageClass
+TLB::pageClass(unsigned log_bytes)
+{
+    if (log_bytes < 21)
+        return SmallPages;
+    else if (log_bytes < 30)
+        return LargePages;
+    else
+        return HugePages;
+}
+
 void
-TLB::evictLRU()
+TLB::EntryArray::init(const std::string &name, unsigned size,
+                      unsigned max_assoc, unsigned index_shift)
 {
-    // Find the entry with the lowest (and hence least recently updated)
-    // sequence number.
+    entries.resize(size);
+    assoc = max_assoc ? std::min(size, max_assoc) : size;
+    numSets = size / assoc;
+    indexShift = index_shift;
+
+    fatal_if(size % assoc != 0 || !isPowerOf2(numSets),
+             "%s: TLB entries (%d) must be a power of two multiple of the "
+             "associativity (%d).\n", name, size, assoc);
+}
 
-    unsigned lru = 0;
-    for (unsigned i = 1; i < size; i++) {
-        if (tlb[i].lruSeq < tlb[lru].lruSeq)
-            lru = i;
+TlbEntry *
+TLB::EntryArray::lookup(Addr va)
+{
+    TlbEntry *way = set(va);
+    for (unsigned i = 0; i < assoc; i++, way++) {
+        if (way->valid && way->vaddr == (va & ~mask(way->logBytes)))
+            return way;
     }
+    return nullptr;
+}
 
-    assert(tlb[lru].trieHandle);
-    trie.remove(tlb[lru].trieHandle);
-    tlb[lru].trieHandle = NULL;
-    freeList.push_back(&tlb[lru]);
+TlbEntry *
+TLB::EntryArray::victim(Addr va)
+{
+    TlbEntry *way = set(va);
+    TlbEntry *lru = way;
+    for (unsigned i = 0; i < assoc; i++, way++) {
+        if (!way->valid)
+            return way;
+        if (way->lruSeq < lru->lruSeq)
+            lru = way;
+    }
+    return lru;
 }
 
 TlbEntry *
 TLB::insert(Addr vpn, const TlbEntry &entry)
 {
     // If somebody beat us to it, just use that existing entry.
-    TlbEntry *newEntry = trie.lookup(vpn);
+    TlbEntry *newEntry = lookup(vpn, false);
     if (newEntry) {
         assert(newEntry->vaddr == vpn);
         return newEntry;
     }
 
-    if (freeList.empty())
-        evictLRU();
-
-    newEntry = freeList.front();
-    freeList.pop_front();
-
+    newEntry = arrays[classArray[pageClass(entry.logBytes)]].victim(vpn);
     *newEntry = entry;
     newEntry->lruSeq = nextSeq();
     newEntry->vaddr = vpn;
-    newEntry->trieHandle =
-    trie.insert(vpn, TlbEntryTrie::MaxBits - entry.logBytes, newEntry);
+    newEntry->valid = true;
     return newEntry;
 }
 
 TlbEntry *
 TLB::lookup(Addr va, bool update_lru)
 {
-    TlbEntry *entry = trie.lookup(va);
-    if (entry && update_lru)
-        entry->lruSeq = nextSeq();
-    return entry;
+    for (auto &array : arrays) {
+        if (array.entries.empty())
+            continue;
+        TlbEntry *entry = array.lookup(va);
+        if (entry) {
+            if (update_lru)
+                entry->lruSeq = nextSeq();
+            return entry;
+        }
+    }
+    return nullptr;
 }
 
 void
 TLB::flushAll()
 {
     DPRINTF(TLB, "Invalidating all entries.\n");
-    for (unsigned i = 0; i < size; i++) {
-        if (tlb[i].trieHandle) {
-            trie.remove(tlb[i].trieHandle);
-            tlb[i].trieHandle = NULL;
-            freeList.push_back(&tlb[i]);
-        }
+    for (auto &array : arrays) {
+        for (auto &entry : array.entries)
+            entry.valid = false;
     }
 }
 
@@ -152,11 +202,10 @@ void
 TLB::flushNonGlobal()
 {
     DPRINTF(TLB, "Invalidating all non global entries.\n");
-    for (unsigned i = 0; i < size; i++) {
-        if (tlb[i].trieHandle && !tlb[i].global) {
-            trie.remove(tlb[i].trieHandle);
-            tlb[i].trieHandle = NULL;
-            freeList.push_back(&tlb[i]);
+    for (auto &array : arrays) {
+        for (auto &entry : array.entries) {
+            if (!entry.global)
+                entry.valid = false;
         }
     }
 }
@@ -164,12 +213,9 @@ TLB::flushNonGlobal()
 void
 TLB::demapPage(Addr va, uint64_t asn)
 {
-    TlbEntry *entry = trie.lookup(va);
-    if (entry) {
-        trie.remove(entry->trieHandle);
-        entry->trieHandle = NULL;
-        freeList.push_back(entry);
-    }
+    TlbEntry *entry = lookup(va, false);
+    if (entry)
+        entry->valid = false;
 }
 
 namespace
@@ -389,8 +435,15 @@ TLB::translate(const RequestPtr &req,
         // If paging is enabled, do the translation.
         if (m5Reg.paging) {
             DPRINTF(TLB, "Paging enabled.\n");
-            // The vaddr already has the segment base applied.
-            TlbEntry *entry = lookup(vaddr);
+            // The vaddr already has the segment base applied.  Try the
+            // entry last used for this kind of access before searching.
+            TlbEntry *entry = lastEntry[mode];
+            if (entry && entry->valid &&
+                entry->vaddr == (vaddr & ~mask(entry->logBytes))) {
+                entry->lruSeq = nextSeq();
+            } else {
+                entry = lookup(vaddr);
+            }
             if (mode == BaseMMU::Read) {
                 stats.rdAccesses++;
             } else {
@@ -434,6 +487,8 @@ TLB::translate(const RequestPtr &req,
                 }
             }
 
+            lastEntry[mode] = entry;
+
             DPRINTF(TLB, "Entry found with paddr %#x, "
                     "doing protection checks.\n", entry->paddr);
             // Do paging protection checks.
@@ -556,14 +611,20 @@ void
 TLB::serialize(CheckpointOut &cp) const
 {
     // Only store the entries in use.
-    uint32_t _size = size - freeList.size();
+    uint32_t _size = 0;
+    for (const auto &array : arrays) {
+        for (const auto &entry : array.entries)
+            _size += entry.valid;
+    }
     SERIALIZE_SCALAR(_size);
     SERIALIZE_SCALAR(lruSeq);
 
     uint32_t _count = 0;
-    for (uint32_t x = 0; x < size; x++) {
-        if (tlb[x].trieHandle != NULL)
-            tlb[x].serializeSection(cp, csprintf("Entry%d", _count++));
+    for (const auto &array : arrays) {
+        for (const auto &entry : array.entries) {
+            if (entry.valid)
+                entry.serializeSection(cp, csprintf("Entry%d", _count++));
+        }
     }
 }
 
@@ -580,12 +641,18 @@ TLB::unserialize(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(lruSeq);
 
     for (uint32_t x = 0; x < _size; x++) {
-        TlbEntry *newEntry = freeList.front();
-        freeList.pop_front();
-
-        newEntry->unserializeSection(cp, csprintf("Entry%d", x));
-        newEntry->trieHandle = trie.insert(newEntry->vaddr,
-            TlbEntryTrie::MaxBits - newEntry->logBytes, newEntry);
+        TlbEntry entry;
+        entry.unserializeSection(cp, csprintf("Entry%d", x));
+
+        // Entries are placed by their address, so one taken from a
+        // checkpoint of a TLB with other page size arrays may displace
+        // another.  Keep the checkpointed LRU order.
+        TlbEntry *newEntry =
+            arrays[classArray[pageClass(entry.logBytes)]].victim(entry.vaddr);
+        if (!newEntry->valid || newEntry->lruSeq < entry.lruSeq) {
+            *newEntry = entry;
+            newEntry->valid = true;
+        }
     }
 }
 
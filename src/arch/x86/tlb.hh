@@ -38,12 +38,12 @@
 #ifndef __ARCH_X86_TLB_HH__
 #define __ARCH_X86_TLB_HH__
 
-#include <list>
+#include <array>
+#include <string>
 #include <vector>
 
 #include "arch/generic/tlb.hh"
 #include "arch/x86/pagetable.hh"
-#include "base/trie.hh"
 #include "mem/request.hh"
 #include "params/X86TLB.hh"
 #include "sim/stats.hh"
@@ -62,8 +62,6 @@ namespace X86ISA
       protected:
         friend class Walker;
 
-        typedef std::list<TlbEntry *> EntryList;
-
         uint32_t configAddress;
 
       public:
@@ -78,9 +76,6 @@ namespace X86ISA
         void setConfigAddress(uint32_t addr);
 
       protected:
-
-        EntryList::iterator lookupIt(Addr va, bool update_lru = true);
-
         Walker * walker;
 
       public:
@@ -93,15 +88,62 @@ namespace X86ISA
         void demapPage(Addr va, uint64_t asn) override;
 
       protected:
+        /** Classes of page size, each with its own array of entries */
+        enum PageClass
+        {
+            SmallPages, // 4KiB
+            LargePages, // 2MiB and 4MiB
+            HugePages,  // 1GiB
+            NumPageClasses
+        };
+
+        static PageClass pageClass(unsigned log_bytes);
+
+        /** A set associative array of entries for one or more classes of
+         *  page size */
+        struct EntryArray
+        {
+            std::vector<TlbEntry> entries;
+            unsigned assoc;
+            unsigned numSets;
+            /** log2 of the largest page size held.  Pages are indexed by
+             *  the address bits above this */
+            unsigned indexShift;
+
+            void init(const std::string &name, unsigned size,
+                      unsigned max_assoc, unsigned index_shift);
+
+            /** The first way of the set which can hold va */
+            TlbEntry *
+            set(Addr va)
+            {
+                return &entries[((va >> indexShift) & (numSets - 1)) *
+                    assoc];
+            }
+
+            TlbEntry *lookup(Addr va);
+
+            /** An invalid or else the least recently used way of the set
+             *  which can hold va */
+            TlbEntry *victim(Addr va);
+        };
+
+        /** Total number of entries in all the arrays */
         uint32_t size;
 
-        std::vector<TlbEntry> tlb;
+        /** One array per page class, empty for classes sharing the array
+         *  of a smaller one */
+        std::array<EntryArray, NumPageClasses> arrays;
 
-        EntryList freeList;
+        /** The array holding the entries of each page class */
+        std::array<int, NumPageClasses> classArray;
 
-        TlbEntryTrie trie;
         uint64_t lruSeq;
 
+        /** The entry last used by translate for each mode, checked before
+         *  searching the arrays */
+        std::array<TlbEntry *, BaseMMU::Execute + 1> lastEntry;
+
         AddrRange m5opRange;
 
         struct TlbStats : public statistics::Group
@@ -122,8 +164,6 @@ namespace X86ISA
 
       public:
 
-        void evictLRU();
-
         uint64_t
         nextSeq()
         {
@@ -0,0 +1,105 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/recycling_pool.hh"
+
+#include <new>
+
+#include "base/cprintf.hh"
+#include "base/intmath.hh"
+
+namespace gem5
+{
+
+RecyclingPool::RecyclingPool(statistics::Group *parent, const char *name,
+                             const char *what)
+    : statistics::Group(parent, name),
+      ADD_STAT(hits, statistics::units::Count::get(),
+               csprintf("Number of %s allocated from the pool",
+                        what).c_str()),
+      ADD_STAT(misses, statistics::units::Count::get(),
+               csprintf("Number of %s allocated from the heap",
+                        what).c_str()),
+      ADD_STAT(hitRate, statistics::units::Ratio::get(),
+               csprintf("Fraction of %s allocated from the pool",
+                        what).c_str(),
+               hits / (hits + misses))
+{
+}
+
+RecyclingPool::~RecyclingPool()
+{
+    for (auto &free_list : freeLists) {
+        for (Header *header : free_list)
+            ::operator delete(header);
+    }
+}
+
+void *
+RecyclingPool::allocate(size_t size, RecyclingPool *pool)
+{
+    size_t size_class = divCeil(size, Granule);
+    Header *header = nullptr;
+
+    if (pool) {
+        if (size_class < pool->freeLists.size() &&
+                !pool->freeLists[size_class].empty()) {
+            header = pool->freeLists[size_class].back();
+            pool->freeLists[size_class].pop_back();
+            ++pool->hits;
+        } else {
+            ++pool->misses;
+        }
+    }
+
+    if (!header) {
+        header = static_cast<Header *>(
+            ::operator new(sizeof(Header) + size_class * Granule));
+        header->pool = pool;
+        header->sizeClass = size_class;
+    }
+
+    return header + 1;
+}
+
+void
+RecyclingPool::release(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    Header *header = static_cast<Header *>(ptr) - 1;
+    RecyclingPool *pool = header->pool;
+    if (!pool) {
+        ::operator delete(header);
+        return;
+    }
+
+    if (header->sizeClass >= pool->freeLists.size())
+        pool->freeLists.resize(header->sizeClass + 1);
+    pool->freeLists[header->sizeClass].push_back(header);
+}
+
+} // namespace gem5
@@ -0,0 +1,110 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_RECYCLING_POOL_HH__
+#define __BASE_RECYCLING_POOL_HH__
+
+#include <cstddef>
+#include <vector>
+
+#include "base/statistics.hh"
+
+namespace gem5
+{
+
+/**
+ * Recycling allocator for objects which are created and destroyed at a
+ * high rate, such as dynamic instructions or branch predictor history.
+ * Buffers are grouped into size classes and are put back on a per-class
+ * free list when they are released, so once a pool has warmed up it
+ * hands out memory without going to the heap.
+ *
+ * Each buffer is preceded by a small header naming the pool it came from
+ * so a class operator delete can return it without knowing the pool.
+ * Buffers allocated without a pool go straight to the heap. A pool must
+ * outlive every buffer allocated from it.
+ */
+class RecyclingPool : public statistics::Group
+{
+  public:
+    /**
+     * @param parent Stats group the pool's stats are reported under.
+     * @param name Name of the pool's stats group.
+     * @param what What the pool holds, used in the stat descriptions.
+     */
+    RecyclingPool(statistics::Group *parent, const char *name,
+                  const char *what);
+    ~RecyclingPool();
+
+    /** Allocates size bytes from pool, or from the heap if it is null. */
+    static void *allocate(size_t size, RecyclingPool *pool);
+
+    /** Returns a buffer from allocate() to the pool it came from. */
+    static void release(void *ptr);
+
+  private:
+    struct alignas(std::max_align_t) Header
+    {
+        RecyclingPool *pool;
+        size_t sizeClass;
+    };
+
+    /** Size class granularity, in bytes. */
+    static constexpr size_t Granule = 64;
+
+    /** Free buffers, indexed by size class. */
+    std::vector<std::vector<Header *>> freeLists;
+
+    statistics::Scalar hits;
+    statistics::Scalar misses;
+    statistics::Formula hitRate;
+};
+
+/**
+ * Base class for objects recycled through a RecyclingPool. Instances are
+ * created with new (pool) T(...) and destroyed with a plain delete,
+ * which hands the memory back to the pool.
+ */
+class Recyclable
+{
+  public:
+    static void *
+    operator new(size_t size, RecyclingPool &pool)
+    {
+        return RecyclingPool::allocate(size, &pool);
+    }
+
+    static void *
+    operator new(size_t size)
+    {
+        return RecyclingPool::allocate(size, nullptr);
+    }
+
+    static void operator delete(void *ptr) { RecyclingPool::release(ptr); }
+};
+
+} // namespace gem5
+
+#endif // __BASE_RECYCLING_POOL_HH__
@@ -0,0 +1,191 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "base/recycling_pool.hh"
+#include "base/stats/group.hh"
+#include "base/stats/info.hh"
+#include "sim/root.hh"
+
+using namespace gem5;
+
+// The stats code looks up the simulation root when resolving stat names,
+// which these tests never do, so there is no root object.
+Root *Root::_root = nullptr;
+
+namespace
+{
+
+/** Returns the value of the scalar stat called name in pool */
+double
+statValue(const RecyclingPool &pool, const std::string &name)
+{
+    for (auto *info : pool.getStats()) {
+        if (info->name == name)
+            return dynamic_cast<statistics::ScalarInfo *>(info)->value();
+    }
+    ADD_FAILURE() << "No stat named " << name;
+    return 0;
+}
+
+/** Allocates size bytes from pool and fills them in */
+void *
+allocFilled(RecyclingPool *pool, size_t size)
+{
+    void *buf = RecyclingPool::allocate(size, pool);
+    std::memset(buf, 0x5a, size);
+    return buf;
+}
+
+int liveObjects = 0;
+
+struct TestObject : public Recyclable
+{
+    uint64_t payload[12];
+
+    TestObject() { ++liveObjects; }
+    ~TestObject() { --liveObjects; }
+};
+
+} // anonymous namespace
+
+/** Buffers are aligned and new size classes are added as they are used */
+TEST(RecyclingPoolTest, Growth)
+{
+    statistics::Group root(nullptr);
+    RecyclingPool pool(&root, "pool", "buffers");
+
+    std::vector<void *> bufs;
+    for (size_t size : {1, 64, 65, 1000, 4096, 64}) {
+        void *buf = allocFilled(&pool, size);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(buf) %
+                  alignof(std::max_align_t), 0);
+        bufs.push_back(buf);
+    }
+    EXPECT_EQ(statValue(pool, "misses"), 6);
+    EXPECT_EQ(statValue(pool, "hits"), 0);
+
+    // Releasing the largest buffer first grows the free lists to its
+    // class, smaller ones then fit in.
+    for (auto it = bufs.rbegin(); it != bufs.rend(); ++it)
+        RecyclingPool::release(*it);
+
+    for (size_t size : {4096, 1000, 65, 64, 64, 1})
+        bufs.push_back(allocFilled(&pool, size));
+    EXPECT_EQ(statValue(pool, "misses"), 6);
+    EXPECT_EQ(statValue(pool, "hits"), 6);
+
+    for (size_t i = 6; i < bufs.size(); ++i)
+        RecyclingPool::release(bufs[i]);
+}
+
+/** Released buffers are handed out again, most recently released first */
+TEST(RecyclingPoolTest, Reuse)
+{
+    statistics::Group root(nullptr);
+    RecyclingPool pool(&root, "pool", "buffers");
+
+    void *a = allocFilled(&pool, 100);
+    void *b = allocFilled(&pool, 100);
+    RecyclingPool::release(a);
+    RecyclingPool::release(b);
+
+    EXPECT_EQ(allocFilled(&pool, 100), b);
+    // Sizes rounding up to the same class share buffers.
+    EXPECT_EQ(allocFilled(&pool, 128), a);
+    EXPECT_EQ(statValue(pool, "hits"), 2);
+    EXPECT_EQ(statValue(pool, "misses"), 2);
+
+    // Buffers of another class are not used for this one.
+    RecyclingPool::release(a);
+    void *c = allocFilled(&pool, 129);
+    EXPECT_NE(c, a);
+    EXPECT_EQ(statValue(pool, "misses"), 3);
+
+    RecyclingPool::release(b);
+    RecyclingPool::release(c);
+}
+
+/** Buffers go back to the pool they came from, whichever is used */
+TEST(RecyclingPoolTest, Release)
+{
+    statistics::Group root(nullptr);
+    RecyclingPool pool1(&root, "pool1", "buffers");
+    RecyclingPool pool2(&root, "pool2", "buffers");
+
+    void *a = allocFilled(&pool1, 32);
+    void *b = allocFilled(&pool2, 32);
+    RecyclingPool::release(a);
+    RecyclingPool::release(b);
+
+    EXPECT_EQ(allocFilled(&pool2, 32), b);
+    EXPECT_EQ(allocFilled(&pool1, 32), a);
+    EXPECT_EQ(statValue(pool1, "hits"), 1);
+    EXPECT_EQ(statValue(pool2, "hits"), 1);
+
+    RecyclingPool::release(a);
+    RecyclingPool::release(b);
+
+    // Buffers without a pool go back to the heap, and releasing null is
+    // a no-op.
+    void *heap = allocFilled(nullptr, 32);
+    RecyclingPool::release(heap);
+    RecyclingPool::release(nullptr);
+    EXPECT_EQ(allocFilled(&pool1, 32), a);
+    EXPECT_EQ(statValue(pool1, "hits"), 2);
+    EXPECT_EQ(statValue(pool1, "misses"), 1);
+    RecyclingPool::release(a);
+}
+
+/** Recyclable objects are created in a pool and deleted back to it */
+TEST(RecyclingPoolTest, Recyclable)
+{
+    statistics::Group root(nullptr);
+    RecyclingPool pool(&root, "pool", "objects");
+
+    TestObject *obj = new (pool) TestObject;
+    EXPECT_EQ(liveObjects, 1);
+    delete obj;
+    EXPECT_EQ(liveObjects, 0);
+
+    TestObject *obj2 = new (pool) TestObject;
+    EXPECT_EQ(obj2, obj);
+    EXPECT_EQ(statValue(pool, "hits"), 1);
+    EXPECT_EQ(statValue(pool, "misses"), 1);
+    delete obj2;
+
+    // Objects created without a pool don't touch it.
+    TestObject *heap_obj = new TestObject;
+    delete heap_obj;
+    EXPECT_EQ(liveObjects, 0);
+    EXPECT_EQ(statValue(pool, "hits"), 1);
+    EXPECT_EQ(statValue(pool, "misses"), 1);
+}
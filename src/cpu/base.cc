@@ -44,6 +44,7 @@
 #include "cpu/base.hh"
 
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 
@@ -348,6 +349,8 @@ BaseCPU::regProbePoints()
     ppRetiredLoads = pmuProbePoint("RetiredLoads");
     ppRetiredStores = pmuProbePoint("RetiredStores");
     ppRetiredBranches = pmuProbePoint("RetiredBranches");
+    ppRetiredBranchOutcomes = new ProbePointArg<RetiredBranch>(
+        getProbeManager(), "RetiredBranchOutcomes");
 
     ppSleeping = new ProbePointArg<bool>(this->getProbeManager(),
                                          "Sleeping");
@@ -371,6 +374,20 @@ BaseCPU::probeInstCommit(const StaticInstPtr &inst, Addr pc)
         ppRetiredBranches->notify(1);
 }
 
+void
+BaseCPU::probeBranchCommit(ThreadID tid, const StaticInstPtr &inst,
+                           const PCStateBase &pc)
+{
+    if (!inst->isControl() || !ppRetiredBranchOutcomes->hasListeners())
+        return;
+
+    std::unique_ptr<PCStateBase> next_pc(pc.clone());
+    inst->advancePC(*next_pc);
+
+    ppRetiredBranchOutcomes->notify(RetiredBranch{
+            tid, inst, pc.instAddr(), next_pc->instAddr(), pc.branching()});
+}
+
 BaseCPU::
 BaseCPUStats::BaseCPUStats(statistics::Group *parent)
     : statistics::Group(parent),
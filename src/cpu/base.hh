@@ -469,6 +469,31 @@ class BaseCPU : public ClockedObject
      */
     virtual void probeInstCommit(const StaticInstPtr &inst, Addr pc);
 
+    /** Outcome of a committed control instruction */
+    struct RetiredBranch
+    {
+        ThreadID tid;
+        StaticInstPtr inst;
+        /** Address of the branch */
+        Addr pc;
+        /** Address of the instruction executed after the branch */
+        Addr target;
+        bool taken;
+    };
+
+    /**
+     * Helper method to trigger the branch outcome probe for a
+     * committed instruction. Does nothing unless the instruction is a
+     * control instruction.
+     *
+     * @param tid Thread the instruction committed on
+     * @param inst Instruction that just committed
+     * @param pc PC state of the instruction after it executed, before
+     *           the thread moved on to the next instruction
+     */
+    void probeBranchCommit(ThreadID tid, const StaticInstPtr &inst,
+                           const PCStateBase &pc);
+
    protected:
     /**
      * Helper method to instantiate probe points belonging to this
@@ -498,6 +523,9 @@ class BaseCPU : public ClockedObject
     /** Retired branches (any type) */
     probing::PMUUPtr ppRetiredBranches;
 
+    /** Outcome and target of retired branches */
+    ProbePointArg<RetiredBranch> *ppRetiredBranchOutcomes;
+
     /** CPU cycle counter even if any thread Context is suspended*/
     probing::PMUUPtr ppAllCycles;
 
@@ -29,6 +29,7 @@
 #ifndef __CPU_DECODE_CACHE_HH__
 #define __CPU_DECODE_CACHE_HH__
 
+#include <memory>
 #include <unordered_map>
 
 #include "base/bitfield.hh"
@@ -47,11 +48,17 @@ template <typename EMI>
 using InstMap = std::unordered_map<EMI, StaticInstPtr>;
 
 /// A sparse map from an Addr to a Value, stored in page chunks.
-template<class Value, Addr CacheChunkShift = 12>
+///
+/// Like a two level page table, chunks are found through directories
+/// which directly index DirShift bits worth of consecutive chunks.
+template<class Value, Addr CacheChunkShift = 12, Addr DirShift = 10>
 class AddrMap
 {
   protected:
     static constexpr Addr CacheChunkBytes = 1ULL << CacheChunkShift;
+    static constexpr Addr DirEntries = 1ULL << DirShift;
+    static constexpr Addr DirSpanShift = CacheChunkShift + DirShift;
+    static constexpr unsigned RecentDirs = 16;
 
     static constexpr Addr
     chunkOffset(Addr addr)
@@ -59,74 +66,63 @@ class AddrMap
         return addr & (CacheChunkBytes - 1);
     }
 
-    static constexpr Addr
-    chunkStart(Addr addr)
-    {
-        return addr & ~(CacheChunkBytes - 1);
-    }
-
     // A chunk of cache entries.
     struct CacheChunk
     {
         Value items[CacheChunkBytes];
     };
-    // A map of cache chunks which allows a sparse mapping.
-    typedef typename std::unordered_map<Addr, CacheChunk *> ChunkMap;
-    typedef typename ChunkMap::iterator ChunkIt;
-    // Mini cache of recent lookups.
-    ChunkIt recent[2];
-    ChunkMap chunkMap;
-
-    /// Update the mini cache of recent lookups.
-    /// @param recentest The most recent result;
-    void
-    update(ChunkIt recentest)
+
+    // The chunks covering a DirSpanShift aligned range of addresses.
+    struct Directory
     {
-        recent[1] = recent[0];
-        recent[0] = recentest;
+        const Addr key;
+        std::unique_ptr<CacheChunk> chunks[DirEntries];
+
+        Directory(Addr _key) : key(_key) {}
+    };
+
+    // All the directories.
+    std::unordered_map<Addr, std::unique_ptr<Directory>> dirMap;
+    // Directories looked up recently, indexed by the low bits of their
+    // keys. This replaces a hash map lookup on most accesses.
+    Directory *recentDirs[RecentDirs] = {};
+
+    /// Find the directory covering the addresses with the given key,
+    /// adding it if it doesn't exist yet.
+    Directory *
+    getDir(Addr key)
+    {
+        Directory *&recent = recentDirs[key % RecentDirs];
+        if (GEM5_LIKELY(recent && recent->key == key))
+            return recent;
+
+        auto &entry = dirMap[key];
+        if (!entry)
+            entry = std::make_unique<Directory>(key);
+        recent = entry.get();
+        return recent;
     }
 
-    /// Attempt to find the CacheChunk which goes with a particular
-    /// address. First check the small cache of recent results, then
-    /// actually look in the hash map.
+    /// Find the CacheChunk which goes with a particular address,
+    /// adding it if it doesn't exist yet.
     /// @param addr The address to look up.
     CacheChunk *
     getChunk(Addr addr)
     {
-        Addr chunk_addr = chunkStart(addr);
-
-        // Check against recent lookups.
-        if (recent[0] != chunkMap.end()) {
-            if (recent[0]->first == chunk_addr)
-                return recent[0]->second;
-            if (recent[1] != chunkMap.end() &&
-                    recent[1]->first == chunk_addr) {
-                update(recent[1]);
-                // recent[1] has just become recent[0].
-                return recent[0]->second;
-            }
-        }
-
-        // Actually look in the hash_map.
-        ChunkIt it = chunkMap.find(chunk_addr);
-        if (it != chunkMap.end()) {
-            update(it);
-            return it->second;
-        }
-
-        // Didn't find an existing chunk, so add a new one.
-        CacheChunk *newChunk = new CacheChunk;
-        typename ChunkMap::value_type to_insert(chunk_addr, newChunk);
-        update(chunkMap.insert(to_insert).first);
-        return newChunk;
+        Directory *dir = getDir(addr >> DirSpanShift);
+        auto &chunk =
+            dir->chunks[(addr >> CacheChunkShift) & (DirEntries - 1)];
+        if (GEM5_UNLIKELY(!chunk))
+            chunk = std::make_unique<CacheChunk>();
+        return chunk.get();
     }
 
   public:
     /// Constructor
-    AddrMap()
-    {
-        recent[0] = recent[1] = chunkMap.end();
-    }
+    AddrMap() {}
+
+    AddrMap(const AddrMap &) = delete;
+    AddrMap &operator=(const AddrMap &) = delete;
 
     Value &
     lookup(Addr addr)
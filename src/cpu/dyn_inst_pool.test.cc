@@ -0,0 +1,154 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "base/stats/group.hh"
+#include "base/stats/info.hh"
+#include "cpu/dyn_inst_pool.hh"
+#include "sim/root.hh"
+
+using namespace gem5;
+
+// The stats code looks up the simulation root when resolving stat names,
+// which these tests never do, so there is no root object.
+Root *Root::_root = nullptr;
+
+namespace
+{
+
+/** Returns the value of the scalar stat called name in pool */
+double
+statValue(const DynInstPool &pool, const std::string &name)
+{
+    for (auto *info : pool.getStats()) {
+        if (info->name == name)
+            return dynamic_cast<statistics::ScalarInfo *>(info)->value();
+    }
+    ADD_FAILURE() << "No stat named " << name;
+    return 0;
+}
+
+/**
+ * Allocates an instruction with num_regs register slots after it in the
+ * same buffer, as O3's DynInst::operator new does.
+ */
+void *
+allocInst(DynInstPool &pool, size_t num_regs)
+{
+    void *buf = DynInstPool::allocate(128 + num_regs * 8, &pool);
+    std::memset(buf, 0xa5, 128 + num_regs * 8);
+    return buf;
+}
+
+} // anonymous namespace
+
+/** Squashed instructions are recycled by the next fetched ones */
+TEST(DynInstPoolTest, Reuse)
+{
+    statistics::Group root(nullptr);
+    DynInstPool pool(&root);
+
+    std::vector<void *> in_flight;
+    for (int i = 0; i < 32; ++i)
+        in_flight.push_back(allocInst(pool, 4));
+    EXPECT_EQ(statValue(pool, "misses"), 32);
+    EXPECT_EQ(statValue(pool, "hits"), 0);
+
+    std::vector<void *> first = in_flight;
+    for (int round = 0; round < 100; ++round) {
+        for (void *inst : in_flight)
+            DynInstPool::release(inst);
+        for (void *&inst : in_flight)
+            inst = allocInst(pool, 4);
+    }
+
+    // No buffer was allocated beyond the first window of instructions.
+    std::sort(first.begin(), first.end());
+    std::sort(in_flight.begin(), in_flight.end());
+    EXPECT_EQ(first, in_flight);
+    EXPECT_EQ(statValue(pool, "misses"), 32);
+    EXPECT_EQ(statValue(pool, "hits"), 3200);
+
+    for (void *inst : in_flight)
+        DynInstPool::release(inst);
+}
+
+/** Instructions with different register layouts don't share buffers */
+TEST(DynInstPoolTest, SizeClasses)
+{
+    statistics::Group root(nullptr);
+    DynInstPool pool(&root);
+
+    void *small = allocInst(pool, 2);
+    void *large = allocInst(pool, 40);
+    DynInstPool::release(small);
+    DynInstPool::release(large);
+
+    // A large instruction doesn't get the small buffer, and vice versa.
+    void *large2 = allocInst(pool, 40);
+    void *small2 = allocInst(pool, 2);
+    EXPECT_EQ(large2, large);
+    EXPECT_EQ(small2, small);
+
+    // Sizes within the same class share buffers.
+    DynInstPool::release(small2);
+    void *small3 = allocInst(pool, 3);
+    EXPECT_EQ(small3, small);
+
+    // A class without free buffers grows from the heap.
+    void *large3 = allocInst(pool, 40);
+    EXPECT_NE(large3, large2);
+    EXPECT_EQ(statValue(pool, "misses"), 3);
+    EXPECT_EQ(statValue(pool, "hits"), 3);
+
+    DynInstPool::release(small3);
+    DynInstPool::release(large2);
+    DynInstPool::release(large3);
+}
+
+/** Instructions not owned by a CPU, like the bubble, use the heap */
+TEST(DynInstPoolTest, NoPool)
+{
+    statistics::Group root(nullptr);
+    DynInstPool pool(&root);
+
+    void *bubble = DynInstPool::allocate(128, nullptr);
+    ASSERT_NE(bubble, nullptr);
+    DynInstPool::release(bubble);
+    DynInstPool::release(nullptr);
+
+    // Heap buffers don't end up on the pool's free lists.
+    void *inst = allocInst(pool, 0);
+    EXPECT_EQ(statValue(pool, "hits"), 0);
+    EXPECT_EQ(statValue(pool, "misses"), 1);
+    DynInstPool::release(inst);
+}
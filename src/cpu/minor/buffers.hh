@@ -45,9 +45,10 @@
 #define __CPU_MINOR_BUFFERS_HH__
 
 #include <iostream>
-#include <queue>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "base/logging.hh"
 #include "base/named.hh"
@@ -349,6 +350,21 @@ class SelfStallingPipeline : public MinorBuffer<ElemType, ReportTraits>
     /** There's data (not a bubble) at the end of the pipe */
     bool isPopable() { return !BubbleTraits::isBubble(front()); }
 
+    /** The number of advances before the oldest data in the pipe reaches
+     *  the end.  0 if the pipe is stalled or empty */
+    unsigned int
+    advancesToPopable() const
+    {
+        if (stalled || occupancy == 0)
+            return 0;
+
+        for (int i = this->past - 1; i >= 0; i--) {
+            if (!BubbleTraits::isBubble((*this)[-i]))
+                return this->past - i;
+        }
+        return 0;
+    }
+
     /** Try to advance the pipeline.  If we're stalled, don't advance.  If
      *  we're not stalled, advance then check to see if we become stalled
      *  (a non-bubble at the end of the pipe) */
@@ -404,7 +420,17 @@ template <typename ElemType,
 class Queue : public Named, public Reservable
 {
   private:
-      std::deque<ElemType> queue;
+    /** Ring of element slots, sized for the queue's capacity up front.
+     *  Elements are constructed in their slot on push and destroyed on pop
+     *  so that they release anything they refer to, but the storage is
+     *  only reallocated if the queue is pushed beyond its capacity */
+    std::vector<std::optional<ElemType>> slots;
+
+    /** Index in slots of the head element */
+    unsigned int head;
+
+    /** Number of elements in the queue */
+    unsigned int numElems;
 
     /** Number of slots currently reserved for future (reservation
      *  respecting) pushes */
@@ -420,11 +446,41 @@ class Queue : public Named, public Reservable
     Queue(const std::string &name, const std::string &data_name,
         unsigned int capacity_) :
         Named(name),
+        slots(capacity_ == 0 ? 1 : capacity_),
+        head(0),
+        numElems(0),
         numReservedSlots(0),
         capacity(capacity_),
         dataName(data_name)
     { }
 
+  private:
+    /** The slot holding the i'th element from the head */
+    std::optional<ElemType> &
+    slot(unsigned int i)
+    {
+        return slots[(head + i) % slots.size()];
+    }
+
+    const std::optional<ElemType> &
+    slot(unsigned int i) const
+    {
+        return slots[(head + i) % slots.size()];
+    }
+
+    /** Double the number of slots, keeping the elements in order */
+    void
+    grow()
+    {
+        std::vector<std::optional<ElemType>> new_slots(slots.size() * 2);
+        for (unsigned int i = 0; i < numElems; i++) {
+            new_slots[i] = std::move(slot(i));
+            slot(i).reset();
+        }
+        slots.swap(new_slots);
+        head = 0;
+    }
+
   public:
     /** Push an element into the buffer if it isn't a bubble.  Bubbles are
      *  just discarded.  It is assummed that any push into a queue with
@@ -434,9 +490,12 @@ class Queue : public Named, public Reservable
     {
         if (!BubbleTraits::isBubble(data)) {
             freeReservation();
-            queue.push_back(data);
+            if (numElems == slots.size())
+                grow();
+            slot(numElems).emplace(data);
+            numElems++;
 
-            if (queue.size() > capacity) {
+            if (numElems > capacity) {
                 warn("%s: No space to push data into queue of capacity"
                     " %u, pushing anyway\n", name(), capacity);
             }
@@ -473,7 +532,7 @@ class Queue : public Named, public Reservable
     unsigned int totalSpace() const { return capacity; }
 
     /** Number of slots already occupied in this buffer */
-    unsigned int occupiedSpace() const { return queue.size(); }
+    unsigned int occupiedSpace() const { return numElems; }
 
     /** Number of slots which are reserved. */
     unsigned int reservedSpace() const { return numReservedSlots; }
@@ -483,7 +542,7 @@ class Queue : public Named, public Reservable
     unsigned int
     remainingSpace() const
     {
-        int ret = capacity - queue.size();
+        int ret = capacity - numElems;
 
         return (ret < 0 ? 0 : ret);
     }
@@ -492,21 +551,33 @@ class Queue : public Named, public Reservable
     unsigned int
     unreservedRemainingSpace() const
     {
-        int ret = capacity - (queue.size() + numReservedSlots);
+        int ret = capacity - (numElems + numReservedSlots);
 
         return (ret < 0 ? 0 : ret);
     }
 
     /** Head value.  Like std::queue::front */
-    ElemType &front() { return queue.front(); }
+    ElemType &front() { assert(numElems != 0); return *slot(0); }
 
-    const ElemType &front() const { return queue.front(); }
+    const ElemType &
+    front() const
+    {
+        assert(numElems != 0);
+        return *slot(0);
+    }
 
     /** Pop the head item.  Like std::queue::pop */
-    void pop() { queue.pop_front(); }
+    void
+    pop()
+    {
+        assert(numElems != 0);
+        slot(0).reset();
+        head = (head + 1) % slots.size();
+        numElems--;
+    }
 
     /** Is the queue empty? */
-    bool empty() const { return queue.empty(); }
+    bool empty() const { return numElems == 0; }
 
     void
     minorTrace() const
@@ -523,7 +594,7 @@ class Queue : public Named, public Reservable
         int num_printed = 1;
         /* Bodge to rotate queue to report elements */
         while (num_printed <= num_occupied) {
-            ReportTraits::reportData(data, queue[num_printed - 1]);
+            ReportTraits::reportData(data, *slot(num_printed - 1));
             num_printed++;
 
             if (num_printed <= num_total)
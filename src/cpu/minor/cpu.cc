@@ -51,7 +51,8 @@ MinorCPU::MinorCPU(const BaseMinorCPUParams &params) :
     BaseCPU(params),
     threadPolicy(params.threadPolicy),
     lctConfidenceLevelLimit(params.lctConfLvlLimit),
-    stats(this)
+    stats(this),
+    dynInstPool(this)
 {
     /* This is only written for one thread at the moment */
     minor::MinorThread *thread;
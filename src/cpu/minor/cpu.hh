@@ -47,6 +47,7 @@
 #include "base/compiler.hh"
 #include "base/random.hh"
 #include "cpu/base.hh"
+#include "cpu/dyn_inst_pool.hh"
 #include "cpu/minor/activity.hh"
 #include "cpu/minor/stats.hh"
 #include "cpu/simple_thread.hh"
@@ -172,6 +173,9 @@ class MinorCPU : public BaseCPU
     /** Processor-specific statistics */
     minor::MinorStats stats;
 
+    /** Recycling allocator for this CPU's MinorDynInsts */
+    DynInstPool dynInstPool;
+
     /** Stats interface from SimObject (by way of BaseCPU) */
     void regStats() override;
 
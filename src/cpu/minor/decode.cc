@@ -199,8 +199,8 @@ Decode::evaluate()
                         static_inst->fetchMicroop(
                                 decode_info.microopPC->microPC());
 
-                    output_inst =
-                        new MinorDynInst(static_micro_inst, inst->id);
+                    output_inst = new (cpu.dynInstPool)
+                        MinorDynInst(static_micro_inst, inst->id);
                     set(output_inst->pc, decode_info.microopPC);
                     output_inst->fault = NoFault;
 
@@ -52,6 +52,7 @@
 #include "base/named.hh"
 #include "base/refcnt.hh"
 #include "base/types.hh"
+#include "cpu/dyn_inst_pool.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/minor/buffers.hh"
 #include "cpu/static_inst.hh"
@@ -246,6 +247,23 @@ class MinorDynInst : public RefCounted
         flatDestRegIdx(si ? si->numDestRegs() : 0), predictedValue(0)
     { }
 
+    /** Instructions are recycled through their CPU's DynInstPool. The
+     *  plain form is for instructions that belong to no CPU, such as
+     *  the bubble. */
+    static void *
+    operator new(size_t size, DynInstPool &pool)
+    {
+        return DynInstPool::allocate(size, &pool);
+    }
+
+    static void *
+    operator new(size_t size)
+    {
+        return DynInstPool::allocate(size, nullptr);
+    }
+
+    static void operator delete(void *ptr) { DynInstPool::release(ptr); }
+
   public:
     /** The BubbleIF interface. */
     bool isBubble() const { return id.fetchSeqNum == 0; }
@@ -98,7 +98,10 @@ Execute::Execute(const std::string &name_,
             ExecuteThreadInfo(params.executeCommitLimit)),
     interruptPriority(0),
     issuePriority(0),
-    commitPriority(0)
+    commitPriority(0),
+    fuOnlyCycles(0),
+    skippingCycles(false),
+    lastEvaluateCycle(0)
 {
     if (commitLimit < 1) {
         fatal("%s: executeCommitLimit must be >= 1 (%d)\n", name_,
@@ -275,6 +278,7 @@ Execute::tryToBranch(MinorDynInstPtr inst, Fault fault, BranchData &branch)
     BranchData::Reason reason = BranchData::NoBranch;
 
     if (fault == NoFault) {
+        cpu.probeBranchCommit(inst->id.threadId, inst->staticInst, *target);
         inst->staticInst->advancePC(*target);
         thread->pcState(*target);
 
@@ -1555,6 +1559,26 @@ Execute::isInbetweenInsts(ThreadID thread_id) const
 void
 Execute::evaluate()
 {
+    /* Catch up the FU pipelines over any cycles skipped since the last
+     *  evaluate.  Only the FU pipelines would have changed in those cycles */
+    if (skippingCycles) {
+        Cycles skipped = cpu.curCycle() - lastEvaluateCycle - Cycles(1);
+
+        assert(skipped <= fuOnlyCycles);
+        DPRINTF(Activity, "Advancing FU pipelines over %d skipped cycles\n",
+            skipped);
+
+        for (Cycles i(0); i < skipped; ++i) {
+            for (unsigned int fu_index = 0; fu_index < numFuncUnits;
+                fu_index++)
+            {
+                funcUnits[fu_index]->advance();
+            }
+        }
+        skippingCycles = false;
+    }
+    lastEvaluateCycle = cpu.curCycle();
+
     if (!inp.outputWire->isBubble())
         inputBuffer[inp.outputWire->threadId].setTail(*inp.outputWire);
 
@@ -1640,11 +1664,13 @@ Execute::evaluate()
      * clock cycle */
     std::vector<MinorDynInstPtr> next_issuable_insts;
     bool can_issue_next = false;
+    bool have_input = false;
 
     for (ThreadID tid = 0; tid < cpu.numThreads; tid++) {
         /* Find the next issuable instruction for each thread and see if it can
            be issued */
         if (getInput(tid)) {
+            have_input = true;
             unsigned int input_index = executeInfo[tid].inputIndex;
             MinorDynInstPtr inst = getInput(tid)->insts[input_index];
             if (inst->isFault()) {
@@ -1730,6 +1756,28 @@ Execute::evaluate()
     if (need_to_tick)
         cpu.wakeupOnEvent(Pipeline::ExecuteStageId);
 
+    /* If the only thing keeping Execute ticking is instructions moving down
+     *  FU pipelines, find how many cycles can pass before one of them
+     *  reaches the end of its pipeline.  Instructions waiting on the
+     *  scoreboard can become issuable without FU pipelines advancing, so
+     *  only do this if there is no input */
+    fuOnlyCycles = Cycles(0);
+    if (!becoming_stalled && num_issued == 0 && !can_issue_next &&
+        !head_inst_might_commit && !interrupted && !have_input &&
+        branch.isBubble() && !lsq.needsToTick())
+    {
+        unsigned int skippable = 0;
+
+        for (unsigned int i = 0; i < numFuncUnits; i++) {
+            unsigned int advances = funcUnits[i]->advancesToPopable();
+
+            if (advances != 0 && (skippable == 0 || advances < skippable))
+                skippable = advances;
+        }
+
+        fuOnlyCycles = Cycles(skippable);
+    }
+
     /* Note activity of following buffer */
     if (!branch.isBubble())
         cpu.activityRecorder->activity();
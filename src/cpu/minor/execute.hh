@@ -227,6 +227,19 @@ class Execute : public Named
     ThreadID issuePriority;
     ThreadID commitPriority;
 
+    /** The number of cycles after this one for which the only change in
+     *  Execute will be instructions moving down unstalled FU pipelines.
+     *  0 if Execute must be evaluated next cycle.  Set by evaluate */
+    Cycles fuOnlyCycles;
+
+    /** The pipeline has stopped ticking to skip over fuOnlyCycles.  The
+     *  FU pipelines will be advanced over the skipped cycles on the next
+     *  evaluate */
+    bool skippingCycles;
+
+    /** Cycle of the last evaluate */
+    Cycles lastEvaluateCycle;
+
   protected:
     friend std::ostream &operator <<(std::ostream &os, DrainState state);
 
@@ -365,6 +378,14 @@ class Execute : public Named
     /** Pass on input/buffer data to the output if you can */
     void evaluate();
 
+    /** The number of cycles which can be skipped after this one as
+     *  nothing other than FU pipeline advance will happen in them */
+    Cycles skippableCycles() const { return fuOnlyCycles; }
+
+    /** Note that the pipeline will skip skippableCycles() cycles (or fewer
+     *  if it is woken by some other event) */
+    void skipCycles() { skippingCycles = true; }
+
     void minorTrace() const;
 
     /** ECE565-CA Project: Flush the Execute stage */
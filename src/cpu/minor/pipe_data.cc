@@ -163,6 +163,16 @@ operator <<(std::ostream &os, const BranchData &branch)
     return os;
 }
 
+void
+BranchData::reset()
+{
+    reason = NoBranch;
+    threadId = InvalidThreadID;
+    newStreamSeqNum = 0;
+    newPredictionSeqNum = 0;
+    inst = MinorDynInst::bubble();
+}
+
 void
 ForwardLineData::setFault(Fault fault_)
 {
@@ -214,6 +224,19 @@ ForwardLineData::freeLine()
     }
 }
 
+void
+ForwardLineData::reset()
+{
+    bubbleFlag = true;
+    lineBaseAddr = 0;
+    fetchAddr = 0;
+    lineWidth = 0;
+    fault = NoFault;
+    id = InstId();
+    line = nullptr;
+    packet = nullptr;
+}
+
 void
 ForwardLineData::reportData(std::ostream &os) const
 {
@@ -260,6 +283,15 @@ ForwardInstData::bubbleFill()
         insts[i] = MinorDynInst::bubble();
 }
 
+void
+ForwardInstData::reset()
+{
+    for (auto &inst : insts)
+        inst = NULL;
+    numInsts = 0;
+    threadId = InvalidThreadID;
+}
+
 void
 ForwardInstData::resize(unsigned int width)
 {
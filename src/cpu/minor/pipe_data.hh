@@ -159,6 +159,10 @@ class BranchData /* : public ReportIF, public BubbleIF */
         return *this;
     }
 
+    /** Make this a bubble in place, keeping the target's storage for
+     *  reuse */
+    void reset();
+
     /** BubbleIF interface */
     static BranchData bubble() { return BranchData(); }
     bool isBubble() const { return reason == NoBranch; }
@@ -267,6 +271,10 @@ class ForwardLineData /* : public ReportIF, public BubbleIF */
      *  constructors/assignment */
     void freeLine();
 
+    /** Make this a bubble in place, keeping the PC's storage for reuse.
+     *  Like the destructor, this does not free the line */
+    void reset();
+
     /** BubbleIF interface */
     static ForwardLineData bubble() { return ForwardLineData(); }
     bool isBubble() const { return bubbleFlag; }
@@ -312,6 +320,9 @@ class ForwardInstData /* : public ReportIF, public BubbleIF */
     /** Fill with bubbles from 0 to width() - 1 */
     void bubbleFill();
 
+    /** Make this an empty bubble in place, dropping all insts */
+    void reset();
+
     /** BubbleIF interface */
     bool isBubble() const;
 
@@ -320,6 +331,27 @@ class ForwardInstData /* : public ReportIF, public BubbleIF */
 };
 
 } // namespace minor
+
+/** Reset pipeline data in place as latches advance, rather than
+ *  destroying and reconstructing it every cycle */
+template <>
+struct TimeBufferSlot<minor::BranchData>
+{
+    static void reset(minor::BranchData *elem) { elem->reset(); }
+};
+
+template <>
+struct TimeBufferSlot<minor::ForwardLineData>
+{
+    static void reset(minor::ForwardLineData *elem) { elem->reset(); }
+};
+
+template <>
+struct TimeBufferSlot<minor::ForwardInstData>
+{
+    static void reset(minor::ForwardInstData *elem) { elem->reset(); }
+};
+
 } // namespace gem5
 
 #endif /* __CPU_MINOR_PIPE_DATA_HH__ */
@@ -59,6 +59,8 @@ Pipeline::Pipeline(MinorCPU &cpu_, const BaseMinorCPUParams &params) :
     Ticked(cpu_, &(cpu_.BaseCPU::baseStats.numCycles)),
     cpu(cpu_),
     allow_idling(params.enableIdling),
+    skipWakeupEvent([this]{ cpu.wakeupOnEvent(Pipeline::ExecuteStageId); },
+        cpu_.name() + ".skipWakeupEvent"),
     f1ToF2(cpu.name() + ".f1ToF2", "lines",
         params.fetch1ToFetch2ForwardDelay),
     f2ToF1(cpu.name() + ".f2ToF1", "prediction",
@@ -145,6 +147,11 @@ Pipeline::evaluate()
     /** We tick the CPU to update the BaseCPU cycle counters */
     cpu.tick();
 
+    /* Any skip is over, whether or not something else woke the pipeline
+     *  early */
+    if (skipWakeupEvent.scheduled())
+        cpu.deschedule(skipWakeupEvent);
+
     /* Note that it's important to evaluate the stages in order to allow
      *  'immediate', 0-time-offset TimeBuffer activity to be visible from
      *  later stages to earlier ones in the same cycle */
@@ -172,6 +179,23 @@ Pipeline::evaluate()
         if (!activityRecorder.active() && !needToSignalDrained) {
             DPRINTF(Quiesce, "Suspending as the processor is idle\n");
             stop();
+        } else if (!needToSignalDrained &&
+            activityRecorder.getActivityCount() == 1 &&
+            activityRecorder.getStageActive(Pipeline::ExecuteStageId) &&
+            execute.skippableCycles() != 0)
+        {
+            /* The only activity is Execute advancing its FU pipelines.
+             *  Stop until the first instruction reaches the end of its
+             *  FU pipeline (or a memory response or other event wakes
+             *  the pipeline) and let Execute catch up the FU pipelines
+             *  then */
+            Cycles skip = execute.skippableCycles();
+
+            DPRINTF(Quiesce, "Skipping %d cycles of FU pipeline advance\n",
+                skip);
+            execute.skipCycles();
+            stop();
+            cpu.schedule(skipWakeupEvent, cpu.clockEdge(skip));
         }
 
         /* Deactivate all stages.  Note that the stages *could*
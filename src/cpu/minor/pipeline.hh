@@ -78,6 +78,10 @@ class Pipeline : public Ticked
     /** Allow cycles to be skipped when the pipeline is idle */
     bool allow_idling;
 
+    /** Restarts the pipeline after skipping cycles in which only Execute's
+     *  FU pipelines would advance */
+    EventFunctionWrapper skipWakeupEvent;
+
     Latch<ForwardLineData> f1ToF2;
     Latch<BranchData> f2ToF1;
     Latch<ForwardInstData> f2ToD;
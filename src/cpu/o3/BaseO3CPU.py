@@ -54,6 +54,9 @@ class SMTQueuePolicy(ScopedEnum):
 class CommitPolicy(ScopedEnum):
     vals = [ 'RoundRobin', 'OldestReady' ]
 
+class MemDepPredType(ScopedEnum):
+    vals = [ 'StoreSet', 'StoreDistance' ]
+
 class BaseO3CPU(BaseCPU):
     type = 'BaseO3CPU'
     cxx_class = 'gem5::o3::CPU'
@@ -87,6 +90,9 @@ class BaseO3CPU(BaseCPU):
     fetchBufferSize = Param.Unsigned(64, "Fetch buffer size in bytes")
     fetchQueueSize = Param.Unsigned(32, "Fetch queue size in micro-ops "
                                     "per-thread")
+    fetchTargetQueueSize = Param.Unsigned(0, "Number of fetch blocks the "
+        "BTB runs ahead of fetch by to prefetch their cache lines, 0 "
+        "disables fetch directed prefetching")
 
     renameToDecodeDelay = Param.Cycles(1, "Rename to decode delay")
     iewToDecodeDelay = Param.Cycles(1, "Issue/Execute/Writeback to decode "
@@ -137,6 +143,10 @@ class BaseO3CPU(BaseCPU):
             "should be invalidated")
     LFSTSize = Param.Unsigned(1024, "Last fetched store table size")
     SSITSize = Param.Unsigned(1024, "Store set ID table size")
+    memDepPred = Param.MemDepPredType('StoreSet',
+            "Memory dependence predictor used by the IQ")
+    storeDistTableSize = Param.Unsigned(1024,
+            "Load PC table size of the store distance predictor")
 
     numRobs = Param.Unsigned(1, "Number of Reorder Buffers");
 
@@ -151,6 +161,9 @@ class BaseO3CPU(BaseCPU):
     # most ISAs don't use condition-code regs, so default is 0
     numPhysCCRegs = Param.Unsigned(0, "Number of physical cc registers")
     numIQEntries = Param.Unsigned(64, "Number of instruction queue entries")
+    iqDependMatrix = Param.Bool(False, "Track IQ register dependences in a "
+                                "bit matrix rather than per-register linked "
+                                "lists; issue decisions are unchanged")
     numROBEntries = Param.Unsigned(192, "Number of reorder buffer entries")
 
     smtNumFetchingThreads = Param.Unsigned(1, "SMT Number of Fetching Threads")
@@ -170,3 +183,10 @@ class BaseO3CPU(BaseCPU):
                                                        Parent.numThreads),
                                        "Branch Predictor")
     needsTSO = Param.Bool(False, "Enable TSO Memory model")
+    threadedStages = Param.Bool(False, "Evaluate decode on a second host "
+        "thread while fetch ticks. Cycles where fetch squashes, or with "
+        "the Decode debug flag on, tick on one thread. Simulated results "
+        "are unchanged")
+    stageDigest = Param.Bool(False, "Fold what fetch and decode send each "
+        "cycle into the stageDigest stat, to compare runs with and "
+        "without threadedStages")
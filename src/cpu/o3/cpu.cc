@@ -52,6 +52,7 @@
 #include "cpu/simple_thread.hh"
 #include "cpu/thread_context.hh"
 #include "debug/Activity.hh"
+#include "debug/Decode.hh"
 #include "debug/Drain.hh"
 #include "debug/O3CPU.hh"
 #include "debug/Quiesce.hh"
@@ -77,6 +78,7 @@ CPU::CPU(const BaseO3CPUParams &params)
                 false, Event::CPU_Tick_Pri),
       threadExitEvent([this]{ exitThreads(); }, "O3CPU exit threads",
                 false, Event::CPU_Exit_Pri),
+      dynInstPool(this),
 #ifndef NDEBUG
       instcount(0),
 #endif
@@ -86,6 +88,11 @@ CPU::CPU(const BaseO3CPUParams &params)
       rename(this, params),
       iew(this, params),
       commit(this, params),
+      threadedStages(params.threadedStages),
+      stageBarrier(2),
+      stopStageThread(false),
+      foldStageDigest(params.stageDigest),
+      stageDigest(0),
 
       regFile(params.numPhysIntRegs,
               params.numPhysFloatRegs,
@@ -123,6 +130,11 @@ CPU::CPU(const BaseO3CPUParams &params)
             "More workload items (%d) than threads (%d) on CPU %s.",
             params.workload.size(), params.numThreads, name());
 
+    fatal_if(threadedStages && (params.fetchToDecodeDelay < 1 ||
+                                params.decodeToFetchDelay < 1),
+            "threadedStages needs fetch to decode and decode to fetch "
+            "delays of at least one cycle on CPU %s.", name());
+
     if (!params.switched_out) {
         _status = Running;
     } else {
@@ -311,6 +323,8 @@ CPU::regProbePoints()
     ppDataAccessComplete = new ProbePointArg<
         std::pair<DynInstPtr, PacketPtr>>(
                 getProbeManager(), "DataAccessComplete");
+    ppPipeTrace = new ProbePointArg<const DynInst *>(
+            getProbeManager(), "PipeTrace");
 
     fetch.regProbePoints();
     rename.regProbePoints();
@@ -318,6 +332,15 @@ CPU::regProbePoints()
     commit.regProbePoints();
 }
 
+CPU::~CPU()
+{
+    if (stageThread.joinable()) {
+        stopStageThread = true;
+        stageBarrier.wait();
+        stageThread.join();
+    }
+}
+
 CPU::CPUStats::CPUStats(CPU *cpu)
     : statistics::Group(cpu),
       ADD_STAT(timesIdled, statistics::units::Count::get(),
@@ -368,7 +391,10 @@ CPU::CPUStats::CPUStats(CPU *cpu)
       ADD_STAT(miscRegfileReads, statistics::units::Count::get(),
                "number of misc regfile reads"),
       ADD_STAT(miscRegfileWrites, statistics::units::Count::get(),
-               "number of misc regfile writes")
+               "number of misc regfile writes"),
+      ADD_STAT(stageDigest, statistics::units::Unspecified::get(),
+               "Digest of the instructions and signals sent by fetch and "
+               "decode, set with stageDigest")
 {
     // Register any of the O3CPU's stats here.
     timesIdled
@@ -443,6 +469,9 @@ CPU::CPUStats::CPUStats(CPU *cpu)
 
     miscRegfileWrites
         .prereq(miscRegfileWrites);
+
+    stageDigest
+        .prereq(stageDigest);
 }
 
 void
@@ -457,10 +486,26 @@ CPU::tick()
 
 //    activity = false;
 
-    //Tick each of the stages
-    fetch.tick();
+    // Tick each of the stages. Fetch and decode only see each other's
+    // output a cycle later, so with threadedStages decode evaluates on
+    // stageThread while fetch ticks here, and its updates to the
+    // instruction list and the activity recorder are applied once both
+    // are done. The later stages call into each other within a cycle
+    // and tick one after the other.
+    if (overlapStages()) {
+        stageBarrier.wait();
+        fetch.tick();
+        stageBarrier.wait();
+
+        decode.updateCPU();
+    } else {
+        fetch.tick();
 
-    decode.tick();
+        decode.tick();
+    }
+
+    if (foldStageDigest)
+        updateStageDigest();
 
     rename.tick();
 
@@ -503,6 +548,72 @@ CPU::tick()
     tryDrain();
 }
 
+bool
+CPU::overlapStages()
+{
+    // A squash in fetch marks instructions decode holds, and decode's
+    // trace output would interleave with the rest.
+    if (!threadedStages || fetch.squashPending() || debug::Decode)
+        return false;
+
+    if (!stageThread.joinable())
+        stageThread = std::thread([this]() { stageThreadLoop(); });
+
+    return true;
+}
+
+void
+CPU::stageThreadLoop()
+{
+    curEventQueue(eventQueue());
+
+    while (true) {
+        stageBarrier.wait();
+        if (stopStageThread)
+            return;
+
+        decode.evaluate();
+
+        stageBarrier.wait();
+    }
+}
+
+void
+CPU::updateStageDigest()
+{
+    auto fold = [this](uint64_t value) {
+        stageDigest = (stageDigest ^ value) * 0x100000001b3ULL;
+    };
+
+    fold(curCycle());
+
+    const FetchStruct &to_decode = fetchQueue[0];
+    for (int i = 0; i < to_decode.size; ++i) {
+        fold(to_decode.insts[i]->seqNum);
+        fold(to_decode.insts[i]->pcState().instAddr());
+    }
+
+    const DecodeStruct &to_rename = decodeQueue[0];
+    for (int i = 0; i < to_rename.size; ++i) {
+        fold(to_rename.insts[i]->seqNum);
+        fold(to_rename.insts[i]->readyToIssue());
+    }
+
+    const TimeStruct &to_fetch = timeBuffer[0];
+    for (ThreadID tid = 0; tid < numThreads; ++tid) {
+        fold(to_fetch.decodeInfo[tid].squash);
+        fold(to_fetch.decodeInfo[tid].doneSeqNum);
+        fold(to_fetch.decodeBlock[tid]);
+        fold(to_fetch.decodeUnblock[tid]);
+    }
+
+    fold(activityRec.active());
+    fold(removeInstsThisCycle);
+
+    // Keep the digest exact as a double.
+    cpuStats.stageDigest = stageDigest >> 11;
+}
+
 void
 CPU::init()
 {
@@ -1235,6 +1346,7 @@ CPU::instDone(ThreadID tid, const DynInstPtr &inst)
     cpuStats.committedOps[tid]++;
 
     probeInstCommit(inst->staticInst, inst->pcState().instAddr());
+    probeBranchCommit(tid, inst->staticInst, inst->pcState());
 }
 
 void
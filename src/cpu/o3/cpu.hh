@@ -47,9 +47,11 @@
 #include <list>
 #include <queue>
 #include <set>
+#include <thread>
 #include <vector>
 
 #include "arch/generic/pcstate.hh"
+#include "base/barrier.hh"
 #include "base/statistics.hh"
 #include "config/the_isa.hh"
 #include "cpu/o3/comm.hh"
@@ -66,8 +68,10 @@
 #include "cpu/o3/thread_state.hh"
 #include "cpu/activity.hh"
 #include "cpu/base.hh"
+#include "cpu/dyn_inst_pool.hh"
 #include "cpu/simple_thread.hh"
 #include "cpu/timebuf.hh"
+#include "debug/O3PipeView.hh"
 #include "params/BaseO3CPU.hh"
 #include "sim/process.hh"
 
@@ -171,9 +175,28 @@ class CPU : public BaseCPU
     /** Constructs a CPU with the given parameters. */
     CPU(const BaseO3CPUParams &params);
 
+    ~CPU();
+
     ProbePointArg<PacketPtr> *ppInstAccessComplete;
     ProbePointArg<std::pair<DynInstPtr, PacketPtr> > *ppDataAccessComplete;
 
+    /**
+     * Notified with every instruction that was timestamped by the
+     * pipeline stages, just before it is destroyed.
+     */
+    ProbePointArg<const DynInst *> *ppPipeTrace;
+
+    /**
+     * Should the stages record per-stage ticks on the instructions that
+     * pass through them? This is the case when O3PipeView tracing is
+     * enabled or when a listener is attached to ppPipeTrace.
+     */
+    bool
+    recordStageTicks() const
+    {
+        return debug::O3PipeView || ppPipeTrace->hasListeners();
+    }
+
     /** Register probe points. */
     void regProbePoints() override;
 
@@ -373,6 +396,11 @@ class CPU : public BaseCPU
     void dumpInsts();
 
   public:
+    /** Recycling allocator for this CPU's DynInsts. It is declared ahead
+     *  of everything that can hold an instruction so it is destroyed last.
+     */
+    DynInstPool dynInstPool;
+
 #ifndef NDEBUG
     /** Count of total number of dynamic instructions in flight. */
     int instcount;
@@ -414,6 +442,37 @@ class CPU : public BaseCPU
     /** The commit stage. */
     Commit commit;
 
+    /** Whether decode evaluates on stageThread while fetch ticks. */
+    const bool threadedStages;
+
+    /** Host thread evaluating decode with threadedStages, started on the
+     *  first cycle that overlaps the two stages.
+     */
+    std::thread stageThread;
+
+    /** Marks the start and the end of each overlapped cycle. */
+    Barrier stageBarrier;
+
+    /** Tells stageThread to exit at the start of the next cycle. */
+    bool stopStageThread;
+
+    /** Whether to fold the stage outputs into stageDigest every cycle. */
+    const bool foldStageDigest;
+
+    /** Running digest of what fetch and decode sent each cycle. */
+    uint64_t stageDigest;
+
+    /** Loop of stageThread, evaluating decode once per cycle. */
+    void stageThreadLoop();
+
+    /** Returns if decode can evaluate on stageThread this cycle, starting
+     *  the thread if needed.
+     */
+    bool overlapStages();
+
+    /** Folds this cycle's fetch and decode outputs into stageDigest. */
+    void updateStageDigest();
+
     /** The register file. */
     PhysRegFile regFile;
 
@@ -614,6 +673,9 @@ class CPU : public BaseCPU
         //number of misc
         statistics::Scalar miscRegfileReads;
         statistics::Scalar miscRegfileWrites;
+
+        /** Digest of the fetch and decode outputs, with stageDigest. */
+        statistics::Scalar stageDigest;
     } cpuStats;
 
   public:
@@ -48,7 +48,6 @@
 #include "cpu/o3/limits.hh"
 #include "debug/Activity.hh"
 #include "debug/Decode.hh"
-#include "debug/O3PipeView.hh"
 #include "params/BaseO3CPU.hh"
 #include "sim/full_system.hh"
 
@@ -64,6 +63,7 @@ namespace o3
 
 Decode::Decode(CPU *_cpu, const BaseO3CPUParams &params)
     : cpu(_cpu),
+      statusChanged(false),
       renameToDecodeDelay(params.renameToDecodeDelay),
       iewToDecodeDelay(params.iewToDecodeDelay),
       commitToDecodeDelay(params.commitToDecodeDelay),
@@ -326,16 +326,11 @@ Decode::squash(const DynInstPtr &inst, ThreadID tid)
 
     // Clear the instruction list and skid buffer in case they have any
     // insts in them.
-    while (!insts[tid].empty()) {
-        insts[tid].pop();
-    }
-
-    while (!skidBuffer[tid].empty()) {
-        skidBuffer[tid].pop();
-    }
+    dropInsts(insts[tid]);
+    dropInsts(skidBuffer[tid]);
 
     // Squash instructions up until this one
-    cpu->removeInstsUntil(squash_seq_num, tid);
+    pendingSquashes.emplace_back(squash_seq_num, tid);
 }
 
 unsigned
@@ -374,17 +369,21 @@ Decode::squash(ThreadID tid)
 
     // Clear the instruction list and skid buffer in case they have any
     // insts in them.
-    while (!insts[tid].empty()) {
-        insts[tid].pop();
-    }
-
-    while (!skidBuffer[tid].empty()) {
-        skidBuffer[tid].pop();
-    }
+    dropInsts(insts[tid]);
+    dropInsts(skidBuffer[tid]);
 
     return squash_count;
 }
 
+void
+Decode::dropInsts(std::queue<DynInstPtr> &queue)
+{
+    while (!queue.empty()) {
+        droppedInsts.push_back(std::move(queue.front()));
+        queue.pop();
+    }
+}
+
 void
 Decode::skidInsert(ThreadID tid)
 {
@@ -542,6 +541,13 @@ Decode::checkSignalsAndUpdate(ThreadID tid)
 
 void
 Decode::tick()
+{
+    evaluate();
+    updateCPU();
+}
+
+void
+Decode::evaluate()
 {
     wroteToTimeBuffer = false;
 
@@ -564,7 +570,13 @@ Decode::tick()
         decode(status_change, tid);
     }
 
-    if (status_change) {
+    statusChanged = status_change;
+}
+
+void
+Decode::updateCPU()
+{
+    if (statusChanged) {
         updateStatus();
     }
 
@@ -573,6 +585,12 @@ Decode::tick()
 
         cpu->activityThisCycle();
     }
+
+    for (const auto &squash : pendingSquashes)
+        cpu->removeInstsUntil(squash.first, squash.second);
+    pendingSquashes.clear();
+
+    droppedInsts.clear();
 }
 
 void
@@ -666,6 +684,8 @@ Decode::decodeInsts(ThreadID tid)
 
             --insts_available;
 
+            droppedInsts.push_back(std::move(inst));
+
             continue;
         }
 
@@ -687,11 +707,9 @@ Decode::decodeInsts(ThreadID tid)
         ++stats.decodedInsts;
         --insts_available;
 
-#if TRACING_ON
-        if (debug::O3PipeView) {
+        if (cpu->recordStageTicks()) {
             inst->decodeTick = curTick() - inst->fetchTick;
         }
-#endif
 
         // Ensure that if it was predicted as a branch, it really is a
         // branch.
@@ -42,6 +42,8 @@
 #define __CPU_O3_DECODE_HH__
 
 #include <queue>
+#include <utility>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "cpu/o3/comm.hh"
@@ -136,6 +138,18 @@ class Decode
      */
     void tick();
 
+    /** Does the work of tick() that only touches decode and its time
+     * buffer wires, leaving the updates to state shared with fetch
+     * pending. It can run on another host thread while fetch ticks.
+     */
+    void evaluate();
+
+    /** Applies the updates evaluate() left pending: stage activity,
+     * squashing the CPU's instruction list and releasing the instructions
+     * decode dropped.
+     */
+    void updateCPU();
+
     /** Determines what to do based on decode's current status.
      * @param status_change decode() sets this variable if there was a status
      * change (ie switching from from blocking to unblocking).
@@ -196,6 +210,9 @@ class Decode
      */
     void squash(const DynInstPtr &inst, ThreadID tid);
 
+    /** Moves all instructions in a queue to the dropped instructions. */
+    void dropInsts(std::queue<DynInstPtr> &queue);
+
   public:
     /** Squashes due to commit signalling a squash. Changes status to
      * squashing and clears block/unblock signals as needed.
@@ -246,6 +263,20 @@ class Decode
      */
     bool wroteToTimeBuffer;
 
+    /** Whether any thread changed status this cycle. */
+    bool statusChanged;
+
+    /** Instructions to squash in the CPU's list, as the sequence number
+     * to squash after and the thread.
+     */
+    std::vector<std::pair<InstSeqNum, ThreadID>> pendingSquashes;
+
+    /** Instructions decode stopped referencing this cycle. They are
+     * released in updateCPU() so that the last reference to an
+     * instruction is never dropped while fetch may be ticking.
+     */
+    std::vector<DynInstPtr> droppedInsts;
+
     /** Source of possible stalls. */
     struct Stalls
     {
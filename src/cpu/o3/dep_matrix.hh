@@ -0,0 +1,289 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_DEP_MATRIX_HH__
+#define __CPU_O3_DEP_MATRIX_HH__
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/** Bit-matrix alternative to DependencyGraph, with the same interface.
+ * Each physical register owns a row of bits, and each waiting
+ * (register, consumer) pair owns a column, so waking up the consumers
+ * of a register scans a handful of words instead of walking and freeing
+ * a linked list. Columns come from a free list that grows on demand and
+ * is recycled, so steady-state operation does not touch the heap.
+ * Consumers are returned by pop() in column order rather than in LIFO
+ * order, which the IQ does not depend on as readiness is tracked in
+ * age-ordered queues.
+ */
+template <class DynInstPtr>
+class DependencyMatrix
+{
+  public:
+    /** Default construction.  Must call resize() prior to use. */
+    DependencyMatrix()
+        : numEntries(0), numWords(0), nodesTraversed(0), nodesRemoved(0)
+    { }
+
+    /** Resize the matrix to have num_entries registers. */
+    void resize(int num_entries);
+
+    /** Clears all of the rows. */
+    void reset();
+
+    /** Inserts an instruction to be dependent on the given index. */
+    void insert(RegIndex idx, const DynInstPtr &new_inst);
+
+    /** Sets the producing instruction of a given register. */
+    void setInst(RegIndex idx, const DynInstPtr &new_inst)
+    { producers[idx] = new_inst; }
+
+    /** Clears the producing instruction. */
+    void clearInst(RegIndex idx)
+    { producers[idx] = NULL; }
+
+    /** Removes an instruction from a single row. */
+    void remove(RegIndex idx, const DynInstPtr &inst_to_remove);
+
+    /** Removes and returns a dependent of a specific register. */
+    DynInstPtr pop(RegIndex idx);
+
+    /** Checks if the entire matrix is empty. */
+    bool empty() const { return freeCols.size() == consumers.size(); }
+
+    /** Checks if there are any dependents on a specific register. */
+    bool empty(RegIndex idx) const { return !rowCount[idx]; }
+
+    /** Debugging function to dump out the matrix. */
+    void dump();
+
+  private:
+    /** Returns the first word of the row of register idx. */
+    uint64_t *row(RegIndex idx) { return &matrix[size_t(idx) * numWords]; }
+
+    /** Returns a free column, growing the matrix if there is none. */
+    unsigned allocCol();
+
+    /** Returns a column to the free list. */
+    void freeCol(unsigned col);
+
+    /** Number of rows; identical to the number of registers. */
+    int numEntries;
+
+    /** Number of 64-bit words per row. */
+    size_t numWords;
+
+    /** numEntries rows of numWords words, row major. */
+    std::vector<uint64_t> matrix;
+
+    /** Number of bits set in each row. */
+    std::vector<unsigned> rowCount;
+
+    /** Consumer instruction of each column. */
+    std::vector<DynInstPtr> consumers;
+
+    /** Columns not currently in use. */
+    std::vector<unsigned> freeCols;
+
+    /** Producing instruction of each register. */
+    std::vector<DynInstPtr> producers;
+
+  public:
+    // Debug variable, kept for parity with DependencyGraph.
+    uint64_t nodesTraversed;
+    // Debug variable, kept for parity with DependencyGraph.
+    uint64_t nodesRemoved;
+};
+
+template <class DynInstPtr>
+void
+DependencyMatrix<DynInstPtr>::resize(int num_entries)
+{
+    numEntries = num_entries;
+    rowCount.assign(numEntries, 0);
+    producers.resize(numEntries);
+    matrix.assign(size_t(numEntries) * numWords, 0);
+}
+
+template <class DynInstPtr>
+void
+DependencyMatrix<DynInstPtr>::reset()
+{
+    std::fill(matrix.begin(), matrix.end(), 0);
+    std::fill(rowCount.begin(), rowCount.end(), 0);
+
+    freeCols.clear();
+    for (unsigned col = consumers.size(); col-- > 0; ) {
+        consumers[col] = NULL;
+        freeCols.push_back(col);
+    }
+
+    for (auto &producer : producers)
+        producer = NULL;
+}
+
+template <class DynInstPtr>
+unsigned
+DependencyMatrix<DynInstPtr>::allocCol()
+{
+    if (freeCols.empty()) {
+        // Double the number of columns, relaying out the rows.
+        size_t new_words = numWords ? numWords * 2 : 1;
+        std::vector<uint64_t> new_matrix(size_t(numEntries) * new_words, 0);
+        for (int r = 0; r < numEntries; ++r) {
+            std::copy_n(&matrix[size_t(r) * numWords], numWords,
+                        &new_matrix[size_t(r) * new_words]);
+        }
+        matrix.swap(new_matrix);
+
+        unsigned old_cols = consumers.size();
+        consumers.resize(new_words * 64);
+        for (unsigned col = consumers.size(); col-- > old_cols; )
+            freeCols.push_back(col);
+        numWords = new_words;
+    }
+
+    unsigned col = freeCols.back();
+    freeCols.pop_back();
+    return col;
+}
+
+template <class DynInstPtr>
+void
+DependencyMatrix<DynInstPtr>::freeCol(unsigned col)
+{
+    consumers[col] = NULL;
+    freeCols.push_back(col);
+}
+
+template <class DynInstPtr>
+void
+DependencyMatrix<DynInstPtr>::insert(RegIndex idx,
+                                     const DynInstPtr &new_inst)
+{
+    unsigned col = allocCol();
+    consumers[col] = new_inst;
+    row(idx)[col / 64] |= uint64_t(1) << (col % 64);
+    ++rowCount[idx];
+}
+
+template <class DynInstPtr>
+void
+DependencyMatrix<DynInstPtr>::remove(RegIndex idx,
+                                     const DynInstPtr &inst_to_remove)
+{
+    // As with DependencyGraph, a consumer whose source became ready
+    // before it was squashed may legitimately be absent.
+    if (!rowCount[idx])
+        return;
+
+    nodesRemoved++;
+
+    uint64_t *words = row(idx);
+    for (size_t w = 0; w < numWords; ++w) {
+        uint64_t bits = words[w];
+        while (bits) {
+            int bit = findLsbSet(bits);
+            unsigned col = w * 64 + bit;
+            if (consumers[col] == inst_to_remove) {
+                words[w] &= ~(uint64_t(1) << bit);
+                --rowCount[idx];
+                freeCol(col);
+                return;
+            }
+            bits &= bits - 1;
+            nodesTraversed++;
+        }
+    }
+
+    panic("Instruction not found in dependency matrix row %d.\n", idx);
+}
+
+template <class DynInstPtr>
+DynInstPtr
+DependencyMatrix<DynInstPtr>::pop(RegIndex idx)
+{
+    DynInstPtr inst = NULL;
+    if (!rowCount[idx])
+        return inst;
+
+    uint64_t *words = row(idx);
+    size_t w = 0;
+    while (!words[w])
+        ++w;
+
+    int bit = findLsbSet(words[w]);
+    unsigned col = w * 64 + bit;
+    words[w] &= ~(uint64_t(1) << bit);
+    --rowCount[idx];
+
+    inst = std::move(consumers[col]);
+    freeCol(col);
+    return inst;
+}
+
+template <class DynInstPtr>
+void
+DependencyMatrix<DynInstPtr>::dump()
+{
+    for (int i = 0; i < numEntries; ++i) {
+        if (producers[i]) {
+            cprintf("dependMatrix[%i]: producer: %s [sn:%lli] consumer: ",
+                    i, producers[i]->pcState(), producers[i]->seqNum);
+        } else {
+            cprintf("dependMatrix[%i]: No producer. consumer: ", i);
+        }
+
+        uint64_t *words = row(i);
+        for (size_t w = 0; w < numWords; ++w) {
+            for (uint64_t bits = words[w]; bits; bits &= bits - 1) {
+                const DynInstPtr &inst =
+                    consumers[w * 64 + findLsbSet(bits)];
+                cprintf("%s [sn:%lli] ", inst->pcState(), inst->seqNum);
+            }
+        }
+
+        cprintf("\n");
+    }
+    cprintf("columns in use: %i\n", consumers.size() - freeCols.size());
+}
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_DEP_MATRIX_HH__
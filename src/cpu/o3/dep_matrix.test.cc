@@ -0,0 +1,98 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "cpu/inst_seq.hh"
+#include "cpu/o3/dep_matrix.hh"
+#include "cpu/op_class.hh"
+
+using namespace gem5;
+using namespace gem5::o3;
+
+namespace
+{
+
+struct FakeInst
+{
+    InstSeqNum seqNum;
+    OpClass opClass;
+};
+
+typedef FakeInst *FakeInstPtr;
+
+} // anonymous namespace
+
+/** Consumers of a register are woken up and removed */
+TEST(DependencyMatrixTest, InsertPopRemove)
+{
+    DependencyMatrix<FakeInstPtr> matrix;
+    matrix.resize(4);
+    FakeInst a{1, IntAluOp}, b{2, IntAluOp}, c{3, IntAluOp};
+
+    EXPECT_TRUE(matrix.empty());
+    matrix.insert(0, &a);
+    matrix.insert(0, &b);
+    matrix.insert(1, &c);
+    EXPECT_FALSE(matrix.empty());
+    EXPECT_FALSE(matrix.empty(0));
+    EXPECT_TRUE(matrix.empty(2));
+
+    matrix.remove(0, &a);
+    EXPECT_EQ(matrix.pop(0), &b);
+    EXPECT_TRUE(matrix.empty(0));
+    EXPECT_EQ(matrix.pop(0), nullptr);
+    EXPECT_EQ(matrix.pop(1), &c);
+    EXPECT_TRUE(matrix.empty());
+}
+
+/** Columns are added as needed and recycled afterwards */
+TEST(DependencyMatrixTest, GrowthAndReuse)
+{
+    DependencyMatrix<FakeInstPtr> matrix;
+    matrix.resize(8);
+    std::vector<FakeInst> insts(300);
+    for (int round = 0; round < 3; ++round) {
+        for (size_t i = 0; i < insts.size(); ++i) {
+            insts[i].seqNum = i;
+            matrix.insert(i % 8, &insts[i]);
+        }
+        std::vector<bool> seen(insts.size(), false);
+        for (RegIndex reg = 0; reg < 8; ++reg) {
+            while (!matrix.empty(reg)) {
+                FakeInstPtr inst = matrix.pop(reg);
+                EXPECT_EQ(inst->seqNum % 8, reg);
+                EXPECT_FALSE(seen[inst->seqNum]);
+                seen[inst->seqNum] = true;
+            }
+        }
+        EXPECT_TRUE(std::all_of(seen.begin(), seen.end(),
+                                [](bool s) { return s; }));
+        EXPECT_TRUE(matrix.empty());
+    }
+}
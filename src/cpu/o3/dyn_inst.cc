@@ -107,14 +107,14 @@ DynInst::DynInst(const Arrays &arrays, const StaticInstPtr &_staticInst,
 {}
 
 /*
- * This custom "new" operator uses the default "new" operator to allocate space
+ * This custom "new" operator uses the CPU's DynInstPool to allocate space
  * for a DynInst, but also pads out the number of bytes to make room for some
  * extra structures the DynInst needs. We save time and improve performance by
- * only going to the heap once to get space for all these structures.
+ * only going to the allocator once to get space for all these structures.
  *
  * When a DynInst is allocated with new, the compiler will call this "new"
  * operator with "count" set to the number of bytes it needs to store the
- * DynInst. We ultimately call into the default new operator to get those
+ * DynInst. We ultimately call into the pool to get those
  * bytes, but before we do, we pad out "count" so that there will be extra
  * space for some structures the DynInst needs. We take into account both the
  * absolute size of these structures, and also what alignment they need.
@@ -123,6 +123,9 @@ DynInst::DynInst(const Arrays &arrays, const StaticInstPtr &_staticInst,
  * extra structures, we construct the extra bits using placement new. This
  * constructs the structures in place in the space we created for them.
  *
+ * The pool recycles the buffer: operator delete hands it back once the last
+ * reference to the instruction is dropped.
+ *
  * Next, we return the buffer as the result of our operator. The compiler takes
  * that buffer and constructs the DynInst in the beginning of it using the
  * DynInst constructor.
@@ -134,7 +137,7 @@ DynInst::DynInst(const Arrays &arrays, const StaticInstPtr &_staticInst,
  * and are then consumed in the DynInst constructor.
  */
 void *
-DynInst::operator new(size_t count, Arrays &arrays)
+DynInst::operator new(size_t count, Arrays &arrays, DynInstPool &pool)
 {
     // Convenience variables for brevity.
     const auto num_dests = arrays.numDests;
@@ -167,8 +170,9 @@ DynInst::operator new(size_t count, Arrays &arrays)
     // Figure out how much space we need in total.
     size_t total_size = ready_src_idx + ready_src_idx_size;
 
-    // Actually allocate it.
-    uint8_t *buf = (uint8_t *)::operator new(total_size);
+    // Actually allocate it. The pool's size classes keep instructions with
+    // different array layouts apart, so recycled buffers always fit.
+    uint8_t *buf = (uint8_t *)DynInstPool::allocate(total_size, &pool);
 
     // Fill in "arrays" with pointers to all the arrays.
     arrays.flatDestIdx = (RegId *)(buf + flat_dest_idx);
@@ -187,8 +191,20 @@ DynInst::operator new(size_t count, Arrays &arrays)
     return buf;
 }
 
+void
+DynInst::operator delete(void *ptr)
+{
+    DynInstPool::release(ptr);
+}
+
 DynInst::~DynInst()
 {
+    // Hand the stage ticks to any pipeline trace listener while the
+    // instruction is still intact. A fetchTick of -1 means fetch did not
+    // timestamp this instruction.
+    if (fetchTick != -1 && cpu->ppPipeTrace->hasListeners())
+        cpu->ppPipeTrace->notify(this);
+
     /*
      * The buffer this DynInst occupies also holds some of the structures it
      * points to. We need to call their destructors manually to make sure that
@@ -52,6 +52,7 @@
 #include "base/trace.hh"
 #include "config/the_isa.hh"
 #include "cpu/checker/cpu.hh"
+#include "cpu/dyn_inst_pool.hh"
 #include "cpu/exec_context.hh"
 #include "cpu/exetrace.hh"
 #include "cpu/inst_res.hh"
@@ -95,7 +96,9 @@ class DynInst : public ExecContext, public RefCounted
         uint8_t *readySrcIdx;
     };
 
-    static void *operator new(size_t count, Arrays &arrays);
+    static void *operator new(size_t count, Arrays &arrays,
+                              DynInstPool &pool);
+    static void operator delete(void *ptr);
 
     /** BaseDynInst constructor given a binary instruction. */
     DynInst(const Arrays &arrays, const StaticInstPtr &staticInst,
@@ -983,10 +986,12 @@ class DynInst : public ExecContext, public RefCounted
     uint64_t htmDepth = 0;
 
   public:
-#if TRACING_ON
     // Value -1 indicates that particular phase
     // hasn't happened (yet).
-    /** Tick records used for the pipeline activity viewer. */
+    /**
+     * Tick records used for the pipeline activity viewer and the
+     * PipeTrace probe. Only set when CPU::recordStageTicks() is true.
+     */
     Tick fetchTick = -1;      // instruction fetch is completed.
     int32_t decodeTick = -1;  // instruction enters decode phase
     int32_t renameTick = -1;  // instruction enters rename phase
@@ -995,7 +1000,6 @@ class DynInst : public ExecContext, public RefCounted
     int32_t completeTick = -1;
     int32_t commitTick = -1;
     int32_t storeTick = -1;
-#endif
 
     /* Values used by LoadToUse stat */
     Tick firstIssue = -1;
@@ -61,7 +61,6 @@
 #include "debug/Drain.hh"
 #include "debug/Fetch.hh"
 #include "debug/O3CPU.hh"
-#include "debug/O3PipeView.hh"
 #include "mem/packet.hh"
 #include "params/BaseO3CPU.hh"
 #include "sim/byteswap.hh"
@@ -97,6 +96,8 @@ Fetch::Fetch(CPU *_cpu, const BaseO3CPUParams &params)
       fetchBufferSize(params.fetchBufferSize),
       fetchBufferMask(fetchBufferSize - 1),
       fetchQueueSize(params.fetchQueueSize),
+      fetchTargetQueueSize(params.fetchTargetQueueSize),
+      outstandingPrefetches(0),
       numThreads(params.numThreads),
       numFetchingThreads(params.smtNumFetchingThreads),
       icachePort(this, _cpu),
@@ -124,6 +125,7 @@ Fetch::Fetch(CPU *_cpu, const BaseO3CPUParams &params)
         fetchOffset[i] = 0;
         macroop[i] = nullptr;
         delayedCommit[i] = false;
+        btbBubbles[i] = 0;
         memReq[i] = nullptr;
         stalls[i] = {false, false};
         fetchBuffer[i] = NULL;
@@ -131,6 +133,10 @@ Fetch::Fetch(CPU *_cpu, const BaseO3CPUParams &params)
         fetchBufferValid[i] = false;
         lastIcacheStall[i] = 0;
         issuePipelinedIfetch[i] = false;
+        fetchTargetValid[i] = false;
+        fetchTargetNextPC[i] = 0;
+        fetchTargetBlockPC[i] = 0;
+        lastPrefetchLine[i] = MaxAddr;
     }
 
     branchPred = params.branchPred;
@@ -208,7 +214,23 @@ Fetch::FetchStatGroup::FetchStatGroup(CPU *cpu, Fetch *fetch)
     ADD_STAT(rate, statistics::units::Rate<
                     statistics::units::Count, statistics::units::Cycle>::get(),
              "Number of inst fetches per cycle",
-             insts / cpu->baseStats.numCycles)
+             insts / cpu->baseStats.numCycles),
+    ADD_STAT(fetchTargets, statistics::units::Count::get(),
+             "Number of fetch blocks the BTB predicted ahead of fetch"),
+    ADD_STAT(fetchTargetHits, statistics::units::Count::get(),
+             "Number of fetch blocks fetch moved on to as predicted"),
+    ADD_STAT(fetchTargetResyncs, statistics::units::Count::get(),
+             "Number of times fetch left the predicted fetch blocks"),
+    ADD_STAT(fetchTargetAccuracy, statistics::units::Ratio::get(),
+             "Fraction of fetch blocks which were predicted ahead",
+             fetchTargetHits / (fetchTargetHits + fetchTargetResyncs)),
+    ADD_STAT(icachePrefetches, statistics::units::Count::get(),
+             "Number of fetch directed prefetches sent to the Icache"),
+    ADD_STAT(icachePrefetchesDropped, statistics::units::Count::get(),
+             "Number of fetch directed prefetches which were dropped"),
+    ADD_STAT(btbStallCycles, statistics::units::Cycle::get(),
+             "Number of cycles fetch waited for the BTB to provide a "
+             "taken branch's target")
 {
         icacheStallCycles
             .prereq(icacheStallCycles);
@@ -257,6 +279,18 @@ Fetch::FetchStatGroup::FetchStatGroup(CPU *cpu, Fetch *fetch)
             .flags(statistics::total);
         rate
             .flags(statistics::total);
+        fetchTargets
+            .prereq(fetchTargets);
+        fetchTargetHits
+            .prereq(fetchTargetHits);
+        fetchTargetResyncs
+            .prereq(fetchTargetResyncs);
+        fetchTargetAccuracy
+            .prereq(fetchTargets);
+        icachePrefetches
+            .prereq(icachePrefetches);
+        icachePrefetchesDropped
+            .prereq(icachePrefetchesDropped);
 }
 void
 Fetch::setTimeBuffer(TimeBuffer<TimeStruct> *time_buffer)
@@ -302,12 +336,14 @@ Fetch::clearStates(ThreadID tid)
     fetchOffset[tid] = 0;
     macroop[tid] = NULL;
     delayedCommit[tid] = false;
+    btbBubbles[tid] = 0;
     memReq[tid] = NULL;
     stalls[tid].decode = false;
     stalls[tid].drain = false;
     fetchBufferPC[tid] = 0;
     fetchBufferValid[tid] = false;
     fetchQueue[tid].clear();
+    flushFetchTargets(tid);
 
     // TODO not sure what to do with priorityList for now
     // priorityList.push_back(tid);
@@ -330,6 +366,7 @@ Fetch::resetStage()
         macroop[tid] = NULL;
 
         delayedCommit[tid] = false;
+        btbBubbles[tid] = 0;
         memReq[tid] = NULL;
 
         stalls[tid].decode = false;
@@ -339,6 +376,7 @@ Fetch::resetStage()
         fetchBufferValid[tid] = false;
 
         fetchQueue[tid].clear();
+        flushFetchTargets(tid);
 
         priorityList.push_back(tid);
     }
@@ -350,6 +388,14 @@ Fetch::resetStage()
 void
 Fetch::processCacheCompletion(PacketPtr pkt)
 {
+    if (pkt->req->isPrefetch()) {
+        // Prefetches only warm up the cache, there's nothing to fetch.
+        assert(outstandingPrefetches);
+        --outstandingPrefetches;
+        delete pkt;
+        return;
+    }
+
     ThreadID tid = cpu->contextToThread(pkt->req->contextId());
 
     DPRINTF(Fetch, "[tid:%i] Waking up from cache miss.\n", tid);
@@ -443,7 +489,7 @@ Fetch::isDrained() const
      * cycle if the finish translation event is scheduled, so make
      * sure that's not the case.
      */
-    return !finishTranslationEvent.scheduled();
+    return !finishTranslationEvent.scheduled() && !outstandingPrefetches;
 }
 
 void
@@ -545,6 +591,8 @@ Fetch::lookupAndUpdateNextPC(const DynInstPtr &inst, PCStateBase &next_pc)
 
     if (predict_taken) {
         ++fetchStats.predictedBranches;
+        // Slower BTB levels take a while to redirect fetch.
+        btbBubbles[tid] = branchPred->BTBLatency(tid);
     }
 
     return predict_taken;
@@ -557,6 +605,8 @@ Fetch::fetchCacheLine(Addr vaddr, ThreadID tid, Addr pc)
 
     assert(!cpu->switchedOut());
 
+    consumeFetchTarget(tid, vaddr);
+
     // @todo: not sure if these should block translation.
     //AlphaDep
     if (cacheBlocked) {
@@ -706,6 +756,143 @@ Fetch::finishTranslation(const Fault &fault, const RequestPtr &mem_req)
     _status = updateFetchStatus();
 }
 
+void
+Fetch::pushFetchTarget(ThreadID tid)
+{
+    const Addr start_pc = fetchTargetNextPC[tid];
+    FetchTarget target;
+    target.blockPC = fetchBufferAlignPC(start_pc);
+    target.nextPC = branchPred->predictFetchBlock(
+            start_pc, target.blockPC + fetchBufferSize, tid);
+    target.prefetched = false;
+
+    DPRINTF(Fetch, "[tid:%i] Fetch target %#x predicted to continue at "
+            "%#x.\n", tid, target.blockPC, target.nextPC);
+
+    fetchTargetQueue[tid].push_back(target);
+    fetchTargetNextPC[tid] = target.nextPC;
+    ++fetchStats.fetchTargets;
+}
+
+void
+Fetch::consumeFetchTarget(ThreadID tid, Addr fetch_addr)
+{
+    const Addr block_pc = fetchBufferAlignPC(fetch_addr);
+    if (!fetchTargetQueueSize ||
+            (fetchTargetValid[tid] && fetchTargetBlockPC[tid] == block_pc)) {
+        return;
+    }
+
+    auto &queue = fetchTargetQueue[tid];
+    if (fetchTargetValid[tid]) {
+        if (queue.empty())
+            pushFetchTarget(tid);
+        if (queue.front().blockPC == block_pc) {
+            queue.pop_front();
+            ++fetchStats.fetchTargetHits;
+            fetchTargetBlockPC[tid] = block_pc;
+            return;
+        }
+
+        DPRINTF(Fetch, "[tid:%i] Fetch went to %#x instead of the "
+                "predicted fetch target %#x.\n", tid, block_pc,
+                queue.front().blockPC);
+        ++fetchStats.fetchTargetResyncs;
+    }
+
+    // Restart the queue at the block fetch is in.
+    queue.clear();
+    fetchTargetNextPC[tid] = fetch_addr;
+    pushFetchTarget(tid);
+    queue.pop_front();
+    fetchTargetValid[tid] = true;
+    fetchTargetBlockPC[tid] = block_pc;
+}
+
+void
+Fetch::flushFetchTargets(ThreadID tid)
+{
+    fetchTargetQueue[tid].clear();
+    fetchTargetValid[tid] = false;
+}
+
+void
+Fetch::prefetchFetchTargets()
+{
+    if (cacheBlocked)
+        return;
+
+    const Addr line_mask = ~Addr(cacheBlkSize - 1);
+    for (auto tid : *activeThreads) {
+        if (stalls[tid].drain)
+            continue;
+
+        for (auto &target : fetchTargetQueue[tid]) {
+            if (target.prefetched)
+                continue;
+            target.prefetched = true;
+
+            // Skip lines fetch is about to access or which were just
+            // prefetched, e.g. because of a loop.
+            const Addr line = target.blockPC & line_mask;
+            if (line == (fetchTargetBlockPC[tid] & line_mask) ||
+                    line == lastPrefetchLine[tid]) {
+                continue;
+            }
+            lastPrefetchLine[tid] = line;
+
+            DPRINTF(Fetch, "[tid:%i] Prefetching cache line %#x for fetch "
+                    "target %#x.\n", tid, line, target.blockPC);
+
+            RequestPtr mem_req = std::make_shared<Request>(
+                line, cacheBlkSize, Request::INST_FETCH | Request::PREFETCH,
+                cpu->instRequestorId(), target.blockPC,
+                cpu->thread[tid]->contextId());
+            mem_req->taskId(cpu->taskId());
+
+            // Only one I-cache access is started per cycle.
+            ++outstandingPrefetches;
+            cpu->mmu->translateTiming(mem_req, cpu->thread[tid]->getTC(),
+                                      new PrefetchTranslation(this),
+                                      BaseMMU::Execute);
+            return;
+        }
+    }
+}
+
+void
+Fetch::finishPrefetchTranslation(const Fault &fault,
+                                 const RequestPtr &mem_req)
+{
+    assert(outstandingPrefetches);
+
+    // Prefetches are only a hint, so anything out of the ordinary just
+    // drops them.
+    if (fault != NoFault || cacheBlocked || mem_req->isUncacheable() ||
+            !cpu->system->isMemAddr(mem_req->getPaddr())) {
+        --outstandingPrefetches;
+        ++fetchStats.icachePrefetchesDropped;
+        return;
+    }
+
+    PacketPtr pf_pkt = new Packet(mem_req, MemCmd::SoftPFReq);
+    pf_pkt->allocate();
+
+    if (!icachePort.sendTimingReq(pf_pkt)) {
+        // Wait for the retry before the next access, but don't bother
+        // retrying the prefetch itself.
+        DPRINTF(Fetch, "Out of MSHRs, dropping prefetch of %#x.\n",
+                mem_req->getVaddr());
+        delete pf_pkt;
+        --outstandingPrefetches;
+        ++fetchStats.icachePrefetchesDropped;
+        cacheBlocked = true;
+        return;
+    }
+
+    ++fetchStats.icachePrefetches;
+}
+
 void
 Fetch::doSquash(const PCStateBase &new_pc, const DynInstPtr squashInst,
         ThreadID tid)
@@ -746,6 +933,8 @@ Fetch::doSquash(const PCStateBase &new_pc, const DynInstPtr squashInst,
 
     // Empty fetch queue
     fetchQueue[tid].clear();
+    flushFetchTargets(tid);
+    btbBubbles[tid] = 0;
 
     // microops are being squashed, it is not known wheather the
     // youngest non-squashed microop was  marked delayed commit
@@ -890,6 +1079,17 @@ Fetch::tick()
         }
     }
 
+    // Let the BTB run ahead and prefetch the blocks it predicts.
+    if (fetchTargetQueueSize) {
+        for (auto tid : *activeThreads) {
+            if (fetchTargetValid[tid] &&
+                    fetchTargetQueue[tid].size() < fetchTargetQueueSize) {
+                pushFetchTarget(tid);
+            }
+        }
+        prefetchFetchTargets();
+    }
+
     // Send instructions enqueued into the fetch queue to decode.
     // Limit rate by fetchWidth.  Stall if decode is stalled.
     unsigned insts_to_decode = 0;
@@ -1039,6 +1239,18 @@ Fetch::checkSignalsAndUpdate(ThreadID tid)
     return false;
 }
 
+bool
+Fetch::squashPending()
+{
+    for (auto tid : *activeThreads) {
+        if (fromCommit->commitInfo[tid].squash ||
+            fromDecode->decodeInfo[tid].squash) {
+            return true;
+        }
+    }
+    return false;
+}
+
 DynInstPtr
 Fetch::buildInst(ThreadID tid, StaticInstPtr staticInst,
         StaticInstPtr curMacroop, const PCStateBase &this_pc,
@@ -1052,7 +1264,7 @@ Fetch::buildInst(ThreadID tid, StaticInstPtr staticInst,
     arrays.numDests = staticInst->numDestRegs();
 
     // Create a new DynInst from the instruction fetched.
-    DynInstPtr instruction = new (arrays) DynInst(
+    DynInstPtr instruction = new (arrays, cpu->dynInstPool) DynInst(
             arrays, staticInst, curMacroop, this_pc, next_pc, seq, cpu);
     instruction->setTid(tid);
 
@@ -1131,6 +1343,12 @@ Fetch::fetch(bool &status_change)
 
         fetchStatus[tid] = Running;
         status_change = true;
+    } else if (fetchStatus[tid] == Running && btbBubbles[tid]) {
+        DPRINTF(Fetch, "[tid:%i] Waiting on the BTB for the target of the "
+                "last taken branch.\n", tid);
+        --btbBubbles[tid];
+        ++fetchStats.btbStallCycles;
+        return;
     } else if (fetchStatus[tid] == Running) {
         // Align the fetch PC so its at the start of a fetch buffer segment.
         Addr fetchBufferBlockPC = fetchBufferAlignPC(fetchAddr);
@@ -1276,11 +1494,9 @@ Fetch::fetch(bool &status_change)
             ppFetch->notify(instruction);
             numInst++;
 
-#if TRACING_ON
-            if (debug::O3PipeView) {
+            if (cpu->recordStageTicks()) {
                 instruction->fetchTick = curTick();
             }
-#endif
 
             set(next_pc, this_pc);
 
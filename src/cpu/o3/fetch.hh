@@ -122,6 +122,27 @@ class Fetch
         }
     };
 
+    /** Translation of a cache line fetch directed prefetch. */
+    class PrefetchTranslation : public BaseMMU::Translation
+    {
+      protected:
+        Fetch *fetch;
+
+      public:
+        PrefetchTranslation(Fetch *_fetch) : fetch(_fetch) {}
+
+        void markDelayed() {}
+
+        void
+        finish(const Fault &fault, const RequestPtr &req,
+            gem5::ThreadContext *tc, BaseMMU::Mode mode)
+        {
+            assert(mode == BaseMMU::Execute);
+            fetch->finishPrefetchTranslation(fault, req);
+            delete this;
+        }
+    };
+
   private:
     /* Event to delay delivery of a fetch translation result in case of
      * a fault and the nop to carry the fault cannot be generated
@@ -300,6 +321,38 @@ class Fetch
     bool fetchCacheLine(Addr vaddr, ThreadID tid, Addr pc);
     void finishTranslation(const Fault &fault, const RequestPtr &mem_req);
 
+    /**
+     * @{
+     * @name Fetch directed instruction prefetching
+     *
+     * The BTB runs ahead of fetch one fetch block per cycle, queueing
+     * the blocks it predicts fetch will go to in the fetch target queue.
+     * While fetch works through the queue, the cache lines of the blocks
+     * further down it are prefetched, so an I-cache miss is overlapped
+     * with fetching the blocks in front of it.
+     */
+
+    /** Predicts the block after the last queued one and queues it. */
+    void pushFetchTarget(ThreadID tid);
+
+    /**
+     * Tells the fetch target queue fetch has moved on to the block
+     * holding fetch_addr. The queue is restarted from there if that
+     * isn't the block at its head.
+     */
+    void consumeFetchTarget(ThreadID tid, Addr fetch_addr);
+
+    /** Drops the queued fetch blocks, e.g. after a squash. */
+    void flushFetchTargets(ThreadID tid);
+
+    /** Prefetches the cache line of the oldest queued fetch block which
+     * hasn't been prefetched yet. */
+    void prefetchFetchTargets();
+
+    void finishPrefetchTranslation(const Fault &fault,
+                                   const RequestPtr &mem_req);
+    /** @} */
+
 
     /** Check if an interrupt is pending and that we need to handle
      */
@@ -342,6 +395,11 @@ class Fetch
      */
     bool checkSignalsAndUpdate(ThreadID tid);
 
+    /** Returns if commit or decode signal a squash to any active thread
+     * this cycle, which makes fetch squash instructions decode may hold.
+     */
+    bool squashPending();
+
     /** Does the actual fetching of instructions and passing them on to the
      * next stage.
      * @param status_change fetch() sets this variable if there was a status
@@ -422,6 +480,9 @@ class Fetch
     /** Can the fetch stage redirect from an interrupt on this instruction? */
     bool delayedCommit[MaxThreads];
 
+    /** Cycles left until the BTB provides the last taken branch's target. */
+    unsigned btbBubbles[MaxThreads];
+
     /** Memory request used to access cache. */
     RequestPtr memReq[MaxThreads];
 
@@ -493,6 +554,38 @@ class Fetch
     /** Queue of fetched instructions. Per-thread to prevent HoL blocking. */
     std::deque<DynInstPtr> fetchQueue[MaxThreads];
 
+    /** A fetch block predicted by the BTB. */
+    struct FetchTarget
+    {
+        /** Fetch buffer aligned address of the block. */
+        Addr blockPC;
+        /** Where fetch is predicted to go after the block. */
+        Addr nextPC;
+        /** Whether a prefetch has been considered for the block. */
+        bool prefetched;
+    };
+
+    /** The maximum number of blocks in a fetch target queue. */
+    const unsigned fetchTargetQueueSize;
+
+    /** The fetch target queues, oldest block first. */
+    std::deque<FetchTarget> fetchTargetQueue[MaxThreads];
+
+    /** Whether the fetch target queue follows the fetch stream. */
+    bool fetchTargetValid[MaxThreads];
+
+    /** Where the BTB continues predicting fetch blocks from. */
+    Addr fetchTargetNextPC[MaxThreads];
+
+    /** The block fetch last moved on to. */
+    Addr fetchTargetBlockPC[MaxThreads];
+
+    /** The cache line last prefetched for a thread. */
+    Addr lastPrefetchLine[MaxThreads];
+
+    /** Number of prefetches being translated or sent to the I-cache. */
+    unsigned outstandingPrefetches;
+
     /** Whether or not the fetch buffer data is valid. */
     bool fetchBufferValid[MaxThreads];
 
@@ -586,6 +679,21 @@ class Fetch
         statistics::Formula branchRate;
         /** Number of instruction fetched per cycle. */
         statistics::Formula rate;
+        /** Number of fetch blocks predicted ahead of fetch. */
+        statistics::Scalar fetchTargets;
+        /** Number of fetch blocks fetch moved on to as predicted. */
+        statistics::Scalar fetchTargetHits;
+        /** Number of times fetch left the predicted fetch blocks. */
+        statistics::Scalar fetchTargetResyncs;
+        /** Fraction of fetch blocks which were predicted ahead. */
+        statistics::Formula fetchTargetAccuracy;
+        /** Number of fetch directed prefetches sent to the I-cache. */
+        statistics::Scalar icachePrefetches;
+        /** Number of fetch directed prefetches dropped, e.g. because the
+         * translation faulted or the cache was blocked. */
+        statistics::Scalar icachePrefetchesDropped;
+        /** Total number of cycles spent waiting on slow BTB levels. */
+        statistics::Scalar btbStallCycles;
     } fetchStats;
 };
 
@@ -42,6 +42,7 @@
 #ifndef __CPU_O3_INST_QUEUE_HH__
 #define __CPU_O3_INST_QUEUE_HH__
 
+#include <deque>
 #include <list>
 #include <map>
 #include <queue>
@@ -52,6 +53,7 @@
 #include "cpu/inst_seq.hh"
 #include "cpu/o3/comm.hh"
 #include "cpu/o3/dep_graph.hh"
+#include "cpu/o3/dep_matrix.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/o3/mem_dep_unit.hh"
@@ -317,8 +319,10 @@ class InstructionQueue
     // Instruction lists, ready queues, and ordering
     //////////////////////////////////////
 
-    /** List of all the instructions in the IQ (some of which may be issued). */
-    std::list<DynInstPtr> instList[MaxThreads];
+    /** List of all the instructions in the IQ (some of which may be issued),
+     *  in program order. Commit pops from the front and squash truncates
+     *  the back. */
+    std::deque<DynInstPtr> instList[MaxThreads];
 
     /** List of instructions that are ready to be executed. */
     std::list<DynInstPtr> instsToExecute;
@@ -402,7 +406,77 @@ class InstructionQueue
      */
     void moveToYoungerInst(ListOrderIt age_order_it);
 
+    /** Register dependence tracking. Exactly one of these is in use,
+     *  selected by the iqDependMatrix parameter; the helpers below
+     *  dispatch to it. */
     DependencyGraph<DynInstPtr> dependGraph;
+    DependencyMatrix<DynInstPtr> dependMatrix;
+    const bool useDependMatrix;
+
+    void
+    depInsert(RegIndex idx, const DynInstPtr &inst)
+    {
+        if (useDependMatrix)
+            dependMatrix.insert(idx, inst);
+        else
+            dependGraph.insert(idx, inst);
+    }
+
+    void
+    depRemove(RegIndex idx, const DynInstPtr &inst)
+    {
+        if (useDependMatrix)
+            dependMatrix.remove(idx, inst);
+        else
+            dependGraph.remove(idx, inst);
+    }
+
+    DynInstPtr
+    depPop(RegIndex idx)
+    {
+        return useDependMatrix ? dependMatrix.pop(idx) :
+                                 dependGraph.pop(idx);
+    }
+
+    void
+    depSetInst(RegIndex idx, const DynInstPtr &inst)
+    {
+        if (useDependMatrix)
+            dependMatrix.setInst(idx, inst);
+        else
+            dependGraph.setInst(idx, inst);
+    }
+
+    void
+    depClearInst(RegIndex idx)
+    {
+        if (useDependMatrix)
+            dependMatrix.clearInst(idx);
+        else
+            dependGraph.clearInst(idx);
+    }
+
+    bool
+    depEmpty() const
+    {
+        return useDependMatrix ? dependMatrix.empty() : dependGraph.empty();
+    }
+
+    bool
+    depEmpty(RegIndex idx) const
+    {
+        return useDependMatrix ? dependMatrix.empty(idx) :
+                                 dependGraph.empty(idx);
+    }
+
+    void
+    depDump()
+    {
+        if (useDependMatrix)
+            dependMatrix.dump();
+        else
+            dependGraph.dump();
+    }
 
     //////////////////////////////////////
     // Various parameters
@@ -52,7 +52,6 @@
 #include "debug/HtmCpu.hh"
 #include "debug/IEW.hh"
 #include "debug/LSQUnit.hh"
-#include "debug/O3PipeView.hh"
 #include "mem/packet.hh"
 #include "mem/request.hh"
 
@@ -1162,12 +1161,10 @@ LSQUnit::completeStore(typename StoreQueue::iterator store_idx)
             "idx:%i\n",
             store_inst->seqNum, store_idx.idx() - 1, storeQueue.head() - 1);
 
-#if TRACING_ON
-    if (debug::O3PipeView) {
+    if (cpu->recordStageTicks()) {
         store_inst->storeTick =
             curTick() - store_inst->fetchTick;
     }
-#endif
 
     if (isStalled() &&
         store_inst->seqNum == stallingStoreIsn) {
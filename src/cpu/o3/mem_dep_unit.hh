@@ -51,7 +51,7 @@
 #include "cpu/inst_seq.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/o3/limits.hh"
-#include "cpu/o3/store_set.hh"
+#include "cpu/o3/mem_dep_pred.hh"
 #include "debug/MemDepUnit.hh"
 
 namespace gem5
@@ -96,7 +96,8 @@ class MemDepUnit
     /** Empty constructor. Must call init() prior to using in this case. */
     MemDepUnit();
 
-    /** Constructs a MemDepUnit with given parameters. */
+    /** Constructs a MemDepUnit with given parameters. init() must still
+     *  be called, as it creates the predictor. */
     MemDepUnit(const BaseO3CPUParams &params);
 
     /** Frees up any memory allocated. */
@@ -241,7 +242,12 @@ class MemDepUnit
      *  this unit what instruction the newly added instruction is dependent
      *  upon.
      */
-    StoreSet depPred;
+    std::unique_ptr<MemDepPredictor> depPred;
+
+    /** Creates the predictor selected by the memDepPred parameter. Only
+     *  called by init(). */
+    static std::unique_ptr<MemDepPredictor>
+    makeDepPred(const BaseO3CPUParams &params);
 
     /** Sequence numbers of outstanding load barriers. */
     std::unordered_set<InstSeqNum> loadBarrierSNs;
@@ -59,3 +59,7 @@ class ElasticTrace(ProbeListenerObject):
     # Whether to trace virtual addresses for memory accesses
     traceVirtAddr = Param.Bool(False, "Set to true if virtual addresses are " \
                                 "to be traced.")
+    # Whether to compress and write the traces on a background thread
+    asyncWrite = Param.Bool(False, "Set to true to serialize trace records "
+                            "into memory and leave compressing and writing "
+                            "them to a background thread.")
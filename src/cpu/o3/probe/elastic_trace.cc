@@ -37,6 +37,8 @@
 
 #include "cpu/o3/probe/elastic_trace.hh"
 
+#include <algorithm>
+
 #include "base/callback.hh"
 #include "base/output.hh"
 #include "base/trace.hh"
@@ -56,6 +58,8 @@ ElasticTrace::ElasticTrace(const ElasticTraceParams &params)
        regEtraceListenersEvent([this]{ regEtraceListeners(); }, name()),
        firstWin(true),
        lastClearedSeqNum(0),
+       depTrace(2 * params.depWindowSize),
+       traceInfoPool(2 * params.depWindowSize),
        depWindowSize(params.depWindowSize),
        dataTraceStream(nullptr),
        instTraceStream(nullptr),
@@ -81,9 +85,17 @@ ElasticTrace::ElasticTrace(const ElasticTraceParams &params)
                 "trace file path to dataDepTraceFile");
     std::string filename = simout.resolve(name() + "." +
                                             params.instFetchTraceFile);
-    instTraceStream = new ProtoOutputStream(filename);
+    instTraceStream = new ProtoOutputStream(filename, params.asyncWrite);
     filename = simout.resolve(name() + "." + params.dataDepTraceFile);
-    dataTraceStream = new ProtoOutputStream(filename);
+    dataTraceStream = new ProtoOutputStream(filename, params.asyncWrite);
+
+    // All records live in a pool sized by the window, so the maps indexing
+    // them never need to grow beyond it either.
+    freeTraceInfo.reserve(traceInfoPool.size());
+    for (auto &record : traceInfoPool)
+        freeTraceInfo.push_back(&record);
+    traceInfoMap.reserve(traceInfoPool.size());
+
     // Create a protobuf message for the header and write it to the stream
     ProtoMessage::PacketHeader inst_pkt_header;
     inst_pkt_header.set_obj_id(name());
@@ -197,7 +209,7 @@ ElasticTrace::recordExecTick(const DynInstConstPtr& dyn_inst)
     if (itr_exec_info != tempStore.end()) {
         exec_info_ptr = itr_exec_info->second;
     } else {
-        exec_info_ptr = new InstExecInfo;
+        exec_info_ptr = allocExecInfo();
         tempStore[dyn_inst->seqNum] = exec_info_ptr;
     }
 
@@ -238,7 +250,7 @@ ElasticTrace::updateRegDep(const DynInstConstPtr& dyn_inst)
     // Since this is the first probe activated in the pipeline, create
     // a new execution info object to track this instruction as it
     // progresses through the pipeline.
-    InstExecInfo* exec_info_ptr = new InstExecInfo;
+    InstExecInfo* exec_info_ptr = allocExecInfo();
     tempStore[seq_num] = exec_info_ptr;
 
     // Loop through the source registers and look up the dependency map. If
@@ -264,7 +276,11 @@ ElasticTrace::updateRegDep(const DynInstConstPtr& dyn_inst)
                 // replay.
                 if (seq_num - last_writer < depWindowSize) {
                     // Record a physical register dependency.
-                    exec_info_ptr->physRegDepSet.insert(last_writer);
+                    auto &dep_set = exec_info_ptr->physRegDepSet;
+                    auto pos = std::lower_bound(dep_set.begin(),
+                                                dep_set.end(), last_writer);
+                    if (pos == dep_set.end() || *pos != last_writer)
+                        dep_set.insert(pos, last_writer);
                 }
             }
 
@@ -396,7 +412,7 @@ ElasticTrace::addDepTraceRecord(const DynInstConstPtr& head_inst,
                                 InstExecInfo* exec_info_ptr, bool commit)
 {
     // Create a record to assign dynamic intruction related fields.
-    TraceInfo* new_record = new TraceInfo;
+    TraceInfo* new_record = allocTraceInfo();
     // Add to map for sequence number look up to retrieve the TraceInfo pointer
     traceInfoMap[head_inst->seqNum] = new_record;
 
@@ -444,7 +460,7 @@ ElasticTrace::addDepTraceRecord(const DynInstConstPtr& head_inst,
     }
 
     // Assign the register dependencies stored in the execution info object
-    std::set<InstSeqNum>::const_iterator dep_set_it;
+    std::vector<InstSeqNum>::const_iterator dep_set_it;
     for (dep_set_it = (exec_info_ptr->physRegDepSet).begin();
          dep_set_it != (exec_info_ptr->physRegDepSet).end();
          ++dep_set_it) {
@@ -519,6 +535,35 @@ ElasticTrace::addDepTraceRecord(const DynInstConstPtr& head_inst,
     }
 }
 
+ElasticTrace::InstExecInfo*
+ElasticTrace::allocExecInfo()
+{
+    if (freeExecInfo.empty())
+        return new InstExecInfo;
+
+    InstExecInfo* exec_info_ptr = freeExecInfo.back();
+    freeExecInfo.pop_back();
+    exec_info_ptr->executeTick = MaxTick;
+    exec_info_ptr->toCommitTick = MaxTick;
+    exec_info_ptr->physRegDepSet.clear();
+    return exec_info_ptr;
+}
+
+ElasticTrace::TraceInfo*
+ElasticTrace::allocTraceInfo()
+{
+    // depTrace is written out as soon as it holds twice depWindowSize
+    // records, so the pool can only run dry if that invariant is broken.
+    panic_if(freeTraceInfo.empty(), "%s: Ran out of trace records.\n",
+             name());
+
+    TraceInfo* record = freeTraceInfo.back();
+    freeTraceInfo.pop_back();
+    record->robDepList.clear();
+    record->physRegDepList.clear();
+    return record;
+}
+
 void
 ElasticTrace::updateCommitOrderDep(TraceInfo* new_record,
                                     bool find_load_not_store)
@@ -526,15 +571,15 @@ ElasticTrace::updateCommitOrderDep(TraceInfo* new_record,
     assert(new_record->isStore());
     // Iterate in reverse direction to search for the last committed
     // load/store that completed earlier than the new record
-    depTraceRevItr from_itr(depTrace.end());
-    depTraceRevItr until_itr(depTrace.begin());
-    TraceInfo* past_record = *from_itr;
+    depTraceItr from_itr = depTrace.end();
+    depTraceItr until_itr = depTrace.begin();
     uint32_t num_go_back = 0;
 
     // The execution time of this store is when it is sent, that is committed
     Tick execute_tick = curTick();
     // Search for store-after-load or store-after-store order dependency
     while (num_go_back < depWindowSize && from_itr != until_itr) {
+        TraceInfo* past_record = *--from_itr;
         if (find_load_not_store) {
             // Check if previous inst is a load completed earlier by comparing
             // with execute tick
@@ -554,8 +599,6 @@ ElasticTrace::updateCommitOrderDep(TraceInfo* new_record,
                 return;
             }
         }
-        ++from_itr;
-        past_record = *from_itr;
         ++num_go_back;
     }
 }
@@ -565,9 +608,8 @@ ElasticTrace::updateIssueOrderDep(TraceInfo* new_record)
 {
     // Interate in reverse direction to search for the last committed
     // record that completed earlier than the new record
-    depTraceRevItr from_itr(depTrace.end());
-    depTraceRevItr until_itr(depTrace.begin());
-    TraceInfo* past_record = *from_itr;
+    depTraceItr from_itr = depTrace.end();
+    depTraceItr until_itr = depTrace.begin();
 
     uint32_t num_go_back = 0;
     Tick execute_tick = 0;
@@ -590,6 +632,7 @@ ElasticTrace::updateIssueOrderDep(TraceInfo* new_record)
     // Once we find it, we update both the new record and the record it depends
     // on and return.
     while (num_go_back < depWindowSize && from_itr != until_itr) {
+        TraceInfo* past_record = *--from_itr;
         // Check if a previous inst is a load sent earlier, or a store sent
         // earlier, or a comp inst completed earlier by comparing with execute
         // tick
@@ -600,8 +643,6 @@ ElasticTrace::updateIssueOrderDep(TraceInfo* new_record)
             assignRobDep(past_record, new_record);
             return;
         }
-        ++from_itr;
-        past_record = *from_itr;
         ++num_go_back;
     }
 }
@@ -664,8 +705,8 @@ ElasticTrace::clearTempStoreUntil(const DynInstConstPtr& head_inst)
         auto itr_exec_info = tempStore.find(temp_sn);
         if (itr_exec_info != tempStore.end()) {
             InstExecInfo* exec_info_ptr = itr_exec_info->second;
-            // Free allocated memory for the info object
-            delete exec_info_ptr;
+            // Keep the info object for reuse
+            freeExecInfo.push_back(exec_info_ptr);
             // Remove entry from temporary store
             tempStore.erase(itr_exec_info);
         }
@@ -792,10 +833,8 @@ ElasticTrace::writeDepTrace(uint32_t num_to_write)
     // List of physical register RAW dependencies - optional, repeated
     // Weight of a node equal to no. of filtered nodes before it - optional
     uint16_t num_filtered_nodes = 0;
-    depTraceItr dep_trace_itr(depTrace.begin());
-    depTraceItr dep_trace_itr_start = dep_trace_itr;
     while (num_to_write > 0) {
-        TraceInfo* temp_ptr = *dep_trace_itr;
+        TraceInfo* temp_ptr = depTrace.front();
         assert(temp_ptr->type != Record::INVALID);
         // If no node dependends on a comp node then there is no reason to
         // track the comp node in the dependency graph. We filter out such
@@ -843,20 +882,18 @@ ElasticTrace::writeDepTrace(uint32_t num_to_write)
             if (temp_ptr->robDepList.empty()) {
                 DPRINTFR(ElasticTrace, "\thas no order (rob) dependencies\n");
             }
-            while (!temp_ptr->robDepList.empty()) {
+            for (InstSeqNum dep : temp_ptr->robDepList) {
                 DPRINTFR(ElasticTrace, "\thas order (rob) dependency on %lli\n",
-                         temp_ptr->robDepList.front());
-                dep_pkt.add_rob_dep(temp_ptr->robDepList.front());
-                temp_ptr->robDepList.pop_front();
+                         dep);
+                dep_pkt.add_rob_dep(dep);
             }
             if (temp_ptr->physRegDepList.empty()) {
                 DPRINTFR(ElasticTrace, "\thas no register dependencies\n");
             }
-            while (!temp_ptr->physRegDepList.empty()) {
+            for (InstSeqNum dep : temp_ptr->physRegDepList) {
                 DPRINTFR(ElasticTrace, "\thas register dependency on %lli\n",
-                         temp_ptr->physRegDepList.front());
-                dep_pkt.add_reg_dep(temp_ptr->physRegDepList.front());
-                temp_ptr->physRegDepList.pop_front();
+                         dep);
+                dep_pkt.add_reg_dep(dep);
             }
             if (num_filtered_nodes != 0) {
                 // Set the weight of this node as the no. of filtered nodes
@@ -874,12 +911,11 @@ ElasticTrace::writeDepTrace(uint32_t num_to_write)
             ++stats.numFilteredNodes;
             ++num_filtered_nodes;
         }
-        dep_trace_itr++;
+        depTrace.pop_front();
         traceInfoMap.erase(temp_ptr->instNum);
-        delete temp_ptr;
+        freeTraceInfo.push_back(temp_ptr);
         num_to_write--;
     }
-    depTrace.erase(dep_trace_itr_start, dep_trace_itr);
 }
 
 ElasticTrace::ElasticTraceStats::ElasticTraceStats(statistics::Group *parent)
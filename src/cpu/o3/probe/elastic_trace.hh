@@ -46,10 +46,11 @@
 #ifndef __CPU_O3_PROBE_ELASTIC_TRACE_HH__
 #define __CPU_O3_PROBE_ELASTIC_TRACE_HH__
 
-#include <set>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "base/circular_queue.hh"
 #include "base/statistics.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/reg_class.hh"
@@ -209,9 +210,10 @@ class ElasticTrace : public ProbeListenerObject
         Tick toCommitTick;
         /**
          * Set of instruction sequence numbers that this instruction depends on
-         * due to Read After Write data dependency based on physical register.
+         * due to Read After Write data dependency based on physical register,
+         * kept sorted and free of duplicates.
          */
-        std::set<InstSeqNum> physRegDepSet;
+        std::vector<InstSeqNum> physRegDepSet;
         /** @} */
 
         /** Constructor */
@@ -230,6 +232,12 @@ class ElasticTrace : public ProbeListenerObject
      */
     std::unordered_map<InstSeqNum, InstExecInfo*> tempStore;
 
+    /**
+     * InstExecInfo objects no longer in the temporary store, kept for reuse
+     * so that tracing does not allocate for every instruction.
+     */
+    std::vector<InstExecInfo*> freeExecInfo;
+
     /**
      * The last cleared instruction sequence number used to free up the memory
      * allocated in the temporary store.
@@ -272,9 +280,9 @@ class ElasticTrace : public ProbeListenerObject
         /* If instruction was committed, as against squashed. */
         bool commit;
         /* List of order dependencies. */
-        std::list<InstSeqNum> robDepList;
+        std::vector<InstSeqNum> robDepList;
         /* List of physical register RAW dependencies. */
-        std::list<InstSeqNum> physRegDepList;
+        std::vector<InstSeqNum> physRegDepList;
         /**
          * Computational delay after the last dependent inst. completed.
          * A value of -1 which means instruction has no dependencies.
@@ -324,9 +332,17 @@ class ElasticTrace : public ProbeListenerObject
      * dependencies are stored in the graph before  the dependent itself is
      * added. This facilitates creating a tree data structure during replay,
      * i.e. adding children as records are read from the trace in an efficient
-     * manner.
+     * manner. It never holds more than twice depWindowSize records.
      */
-    std::vector<TraceInfo*> depTrace;
+    CircularQueue<TraceInfo*> depTrace;
+
+    /**
+     * Storage for all TraceInfo records and the list of those not currently
+     * in depTrace. Both are sized once, from depWindowSize, so tracing does
+     * not allocate records however long it runs.
+     */
+    std::vector<TraceInfo> traceInfoPool;
+    std::vector<TraceInfo*> freeTraceInfo;
 
     /**
      * Map where the instruction sequence number is mapped to the pointer to
@@ -335,10 +351,7 @@ class ElasticTrace : public ProbeListenerObject
     std::unordered_map<InstSeqNum, TraceInfo*> traceInfoMap;
 
     /** Typedef of iterator to the instruction dependency trace. */
-    typedef typename std::vector<TraceInfo*>::iterator depTraceItr;
-
-    /** Typedef of the reverse iterator to the instruction dependency trace. */
-    typedef typename std::reverse_iterator<depTraceItr> depTraceRevItr;
+    typedef typename CircularQueue<TraceInfo*>::iterator depTraceItr;
 
     /**
      * The maximum distance for a dependency and is set by a top level
@@ -384,6 +397,12 @@ class ElasticTrace : public ProbeListenerObject
     void addDepTraceRecord(const DynInstConstPtr& head_inst,
                            InstExecInfo* exec_info_ptr, bool commit);
 
+    /** Get a reset InstExecInfo object, reusing a free one if possible. */
+    InstExecInfo* allocExecInfo();
+
+    /** Get a reset TraceInfo record from the pool. */
+    TraceInfo* allocTraceInfo();
+
     /**
      * Clear entries in the temporary store of execution info objects to free
      * allocated memory until the present instruction being added to the trace.
@@ -0,0 +1,300 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/o3/probe/pipe_trace.hh"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "cpu/o3/dyn_inst.hh"
+#include "sim/core.hh"
+#include "sim/sim_exit.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+PipeTrace::Block::Block(unsigned size)
+    : fetchTick(size), seqNum(size), pc(size), disasm(size), upc(size)
+{
+    for (auto &col : stageTick)
+        col.resize(size);
+}
+
+PipeTrace::PipeTrace(const PipeTraceParams &params)
+    : ProbeListenerObject(params),
+      blockSize(params.blockSize),
+      maxPendingBlocks(params.maxPendingBlocks),
+      compressionLevel(params.compressionLevel),
+      file(nullptr),
+      stopping(false),
+      flushed(false)
+{
+    fatal_if(blockSize == 0 || blockSize > (1 << 24),
+             "%s: blockSize must be between 1 and 2^24 records.\n", name());
+    fatal_if(maxPendingBlocks == 0,
+             "%s: maxPendingBlocks must be non-zero.\n", name());
+    fatal_if(compressionLevel > 9,
+             "%s: compressionLevel must be between 0 and 9.\n", name());
+
+    std::string filename = simout.resolve(ProbeListenerObject::name() +
+                                          "." + params.traceFile);
+    file = std::fopen(filename.c_str(), "wb");
+    fatal_if(!file, "%s: Can't open trace file %s.\n", name(), filename);
+
+    FileHeader header;
+    std::memcpy(header.magic, Magic, sizeof(header.magic));
+    header.version = Version;
+    header.numStages = NumStages;
+    header.tickFreq = sim_clock::Frequency;
+    std::fwrite(&header, sizeof(header), 1, file);
+
+    current = getFreeBlock();
+    writer = std::thread([this]() { writerLoop(); });
+
+    registerExitCallback([this]() { flush(); });
+}
+
+PipeTrace::~PipeTrace()
+{
+    flush();
+}
+
+void
+PipeTrace::regProbeListeners()
+{
+    typedef ProbeListenerArg<PipeTrace, const DynInst *> InstListener;
+    listeners.push_back(new InstListener(this, "PipeTrace",
+                &PipeTrace::traceInst));
+}
+
+uint32_t
+PipeTrace::disasmId(const DynInst *inst)
+{
+    // Intern by the text itself: a StaticInst can be shared by several
+    // PCs, and ISAs with PC-relative operands regenerate the text for
+    // each PC.
+    const std::string &text =
+        inst->staticInst->disassemble(inst->pcState().instAddr());
+    auto it = disasmIds.find(text);
+    if (it != disasmIds.end())
+        return it->second;
+
+    uint32_t id = disasmIds.size();
+    disasmIds.emplace(text, id);
+
+    uint32_t len = text.size();
+    current->strings.append(reinterpret_cast<const char *>(&len),
+                            sizeof(len));
+    current->strings.append(text);
+    current->numStrings++;
+    return id;
+}
+
+void
+PipeTrace::traceInst(const DynInst *const &inst)
+{
+    if (flushed)
+        return;
+
+    Block &b = *current;
+    const unsigned n = b.numRecords;
+    const Tick fetch = inst->fetchTick;
+
+    b.fetchTick[n] = fetch;
+    b.seqNum[n] = inst->seqNum;
+    b.pc[n] = inst->pcState().instAddr();
+    b.upc[n] = inst->pcState().microPC();
+    b.disasm[n] = disasmId(inst);
+
+    b.stageTick[Decode][n] = inst->decodeTick;
+    b.stageTick[Rename][n] = inst->renameTick;
+    b.stageTick[Dispatch][n] = inst->dispatchTick;
+    b.stageTick[Issue][n] = inst->issueTick;
+    b.stageTick[Complete][n] = inst->completeTick;
+    b.stageTick[Retire][n] = inst->commitTick;
+    b.stageTick[Store][n] = inst->storeTick;
+
+    if (++b.numRecords == blockSize)
+        submitBlock();
+}
+
+std::unique_ptr<PipeTrace::Block>
+PipeTrace::getFreeBlock()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (freeBlocks.empty())
+        return std::make_unique<Block>(blockSize);
+
+    auto block = std::move(freeBlocks.back());
+    freeBlocks.pop_back();
+    return block;
+}
+
+void
+PipeTrace::submitBlock()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        // Stall the simulation rather than buffer without bound if the
+        // writer can't keep up.
+        cv.wait(lock, [this]() { return pending.size() < maxPendingBlocks; });
+        pending.push_back(std::move(current));
+    }
+    cv.notify_all();
+    current = getFreeBlock();
+}
+
+void
+PipeTrace::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        cv.wait(lock, [this]() { return stopping || !pending.empty(); });
+        if (pending.empty())
+            return;
+
+        auto block = std::move(pending.front());
+        pending.pop_front();
+        lock.unlock();
+        cv.notify_all();
+
+        writeBlock(*block);
+        block->numRecords = 0;
+        block->numStrings = 0;
+        block->strings.clear();
+
+        lock.lock();
+        freeBlocks.push_back(std::move(block));
+    }
+}
+
+namespace
+{
+
+template <class T>
+uint8_t *
+appendColumn(uint8_t *dst, const std::vector<T> &col, unsigned n)
+{
+    std::memcpy(dst, col.data(), n * sizeof(T));
+    return dst + n * sizeof(T);
+}
+
+/** Compress src into dst, resizing dst, and return the compressed size. */
+uint32_t
+compressInto(std::vector<uint8_t> &dst, const uint8_t *src, size_t len,
+             int level)
+{
+    uLongf zlen = compressBound(len);
+    if (dst.size() < zlen)
+        dst.resize(zlen);
+    int ret = compress2(dst.data(), &zlen, src, len, level);
+    panic_if(ret != Z_OK, "PipeTrace: zlib compression failed (%d).\n", ret);
+    return zlen;
+}
+
+} // anonymous namespace
+
+void
+PipeTrace::writeBlock(const Block &b)
+{
+    const unsigned n = b.numRecords;
+
+    BlockHeader header = {};
+    header.numRecords = n;
+    header.numStrings = b.numStrings;
+    header.stringBytes = b.strings.size();
+    header.minFetchTick = MaxTick;
+    header.minSeqNum = -1;
+    for (unsigned i = 0; i < n; i++) {
+        header.minFetchTick = std::min<uint64_t>(header.minFetchTick,
+                                                 b.fetchTick[i]);
+        header.maxFetchTick = std::max<uint64_t>(header.maxFetchTick,
+                                                 b.fetchTick[i]);
+        header.minSeqNum = std::min<uint64_t>(header.minSeqNum, b.seqNum[i]);
+        header.maxSeqNum = std::max<uint64_t>(header.maxSeqNum, b.seqNum[i]);
+    }
+
+    // Lay the records out column by column. Fetch ticks and sequence
+    // numbers are stored as deltas, which turns them into mostly small,
+    // repeating values that compress well.
+    rawBuf.resize(n * RecordBytes);
+    uint64_t *deltas = reinterpret_cast<uint64_t *>(rawBuf.data());
+    uint64_t prev_tick = 0;
+    uint64_t prev_sn = 0;
+    for (unsigned i = 0; i < n; i++) {
+        deltas[i] = b.fetchTick[i] - prev_tick;
+        deltas[n + i] = b.seqNum[i] - prev_sn;
+        prev_tick = b.fetchTick[i];
+        prev_sn = b.seqNum[i];
+    }
+    uint8_t *dst = rawBuf.data() + 2 * n * sizeof(uint64_t);
+    dst = appendColumn(dst, b.pc, n);
+    dst = appendColumn(dst, b.disasm, n);
+    dst = appendColumn(dst, b.upc, n);
+    for (const auto &col : b.stageTick)
+        dst = appendColumn(dst, col, n);
+    assert(dst == rawBuf.data() + rawBuf.size());
+
+    header.stringZBytes = compressInto(zStrings,
+            reinterpret_cast<const uint8_t *>(b.strings.data()),
+            b.strings.size(), compressionLevel);
+    header.recordZBytes = compressInto(zRecords, rawBuf.data(),
+                                       rawBuf.size(), compressionLevel);
+
+    std::fwrite(&header, sizeof(header), 1, file);
+    std::fwrite(zStrings.data(), 1, header.stringZBytes, file);
+    std::fwrite(zRecords.data(), 1, header.recordZBytes, file);
+}
+
+void
+PipeTrace::flush()
+{
+    if (flushed)
+        return;
+    flushed = true;
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (current->numRecords > 0)
+            pending.push_back(std::move(current));
+        stopping = true;
+    }
+    cv.notify_all();
+    writer.join();
+
+    std::fclose(file);
+    file = nullptr;
+}
+
+} // namespace o3
+} // namespace gem5
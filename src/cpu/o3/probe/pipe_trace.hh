@@ -0,0 +1,209 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a probe listener that writes a compact binary pipeline
+ * trace of the O3 CPU. It records the same per-stage ticks as the
+ * O3PipeView debug flag, but stores them in zlib compressed, column
+ * oriented blocks that are written out by a background thread. The
+ * util/o3-pipetrace.py script turns a region of such a trace back into
+ * the O3PipeView text format understood by util/o3-pipeview.py.
+ *
+ * A trace file starts with a FileHeader and is followed by any number of
+ * blocks. Each block is a BlockHeader followed by the compressed string
+ * table and the compressed record columns. The string table holds the
+ * disassembly strings first referenced in this block as a sequence of
+ * (uint32_t length, chars) entries; string ids are assigned in file
+ * order. The record columns are, in order, the fetch tick and sequence
+ * number (both as uint64_t deltas to the previous record), the PC
+ * (uint64_t), the disassembly id (uint32_t), the micro PC (uint16_t) and
+ * one int32_t column per stage in Stage order holding the tick offset
+ * from fetch, or -1 if the instruction never reached that stage. All
+ * values are in host byte order.
+ */
+
+#ifndef __CPU_O3_PROBE_PIPE_TRACE_HH__
+#define __CPU_O3_PROBE_PIPE_TRACE_HH__
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "base/types.hh"
+#include "cpu/o3/dyn_inst_ptr.hh"
+#include "params/PipeTrace.hh"
+#include "sim/probe/probe.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+class PipeTrace : public ProbeListenerObject
+{
+  public:
+    /** Pipeline stages with a tick column in the trace. */
+    enum Stage
+    {
+        Decode,
+        Rename,
+        Dispatch,
+        Issue,
+        Complete,
+        Retire,
+        Store,
+        NumStages
+    };
+
+    static constexpr char Magic[8] = {'g', 'e', 'm', '5', 'o', '3', 'p', 't'};
+    static constexpr uint32_t Version = 1;
+
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t numStages;
+        /** Ticks per second. */
+        uint64_t tickFreq;
+    };
+
+    struct BlockHeader
+    {
+        uint32_t numRecords;
+        uint32_t numStrings;
+        /** Uncompressed and compressed size of the string table. */
+        uint32_t stringBytes;
+        uint32_t stringZBytes;
+        /** Compressed size of the record columns. */
+        uint32_t recordZBytes;
+        uint32_t pad;
+        /**
+         * Fetch tick and sequence number ranges of the records, so that
+         * readers can skip blocks outside a region of interest without
+         * decompressing them.
+         */
+        uint64_t minFetchTick;
+        uint64_t maxFetchTick;
+        uint64_t minSeqNum;
+        uint64_t maxSeqNum;
+    };
+
+    /** Size of one record summed over all columns. */
+    static constexpr size_t RecordBytes =
+        3 * sizeof(uint64_t) + sizeof(uint32_t) + sizeof(uint16_t) +
+        NumStages * sizeof(int32_t);
+
+    PipeTrace(const PipeTraceParams &params);
+    ~PipeTrace();
+
+    /** Register the probe listeners. */
+    void regProbeListeners() override;
+
+    std::string
+    name() const override
+    {
+        return ProbeListenerObject::name() + ".pipetrace";
+    }
+
+  private:
+    /** Column storage for up to blockSize records. */
+    struct Block
+    {
+        Block(unsigned size);
+
+        unsigned numRecords = 0;
+        unsigned numStrings = 0;
+        std::string strings;
+
+        std::vector<uint64_t> fetchTick;
+        std::vector<uint64_t> seqNum;
+        std::vector<uint64_t> pc;
+        std::vector<uint32_t> disasm;
+        std::vector<uint16_t> upc;
+        std::vector<int32_t> stageTick[NumStages];
+    };
+
+    /** Called for every timestamped instruction before it is destroyed. */
+    void traceInst(const DynInst *const &inst);
+
+    /** Return the id of an instruction's disassembly, adding it if new. */
+    uint32_t disasmId(const DynInst *inst);
+
+    /** Hand the current block to the writer thread and get a fresh one. */
+    void submitBlock();
+
+    /** Get an empty block from the free list, allocating if needed. */
+    std::unique_ptr<Block> getFreeBlock();
+
+    /** Writer thread main loop. */
+    void writerLoop();
+
+    /** Compress a block and append it to the file. */
+    void writeBlock(const Block &block);
+
+    /** Flush the last block and wait for the writer thread to finish. */
+    void flush();
+
+    const unsigned blockSize;
+    const unsigned maxPendingBlocks;
+    const int compressionLevel;
+
+    std::FILE *file;
+
+    /** Block currently being filled by the simulation thread. */
+    std::unique_ptr<Block> current;
+
+    /** Disassembly ids by disassembly text. */
+    std::unordered_map<std::string, uint32_t> disasmIds;
+
+    /** Protects pending, freeBlocks and stopping. */
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::unique_ptr<Block>> pending;
+    std::vector<std::unique_ptr<Block>> freeBlocks;
+    bool stopping;
+    bool flushed;
+
+    std::thread writer;
+
+    /** Writer thread scratch buffers, reused between blocks. */
+    std::vector<uint8_t> rawBuf;
+    std::vector<uint8_t> zStrings;
+    std::vector<uint8_t> zRecords;
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif//__CPU_O3_PROBE_PIPE_TRACE_HH__
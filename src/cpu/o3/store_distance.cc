@@ -0,0 +1,156 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/o3/store_distance.hh"
+
+#include <algorithm>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/StoreDistance.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+StoreDistance::StoreDistance(uint64_t clear_period, int table_size,
+                             int history_size)
+    : distance(table_size, 0), storeHistory(history_size),
+      clearPeriod(clear_period), indexMask(table_size - 1), offsetBits(2),
+      memOpsPred(0)
+{
+    DPRINTF(StoreDistance, "StoreDistance: table size: %i, history: %i.\n",
+            table_size, history_size);
+
+    if (!isPowerOf2(table_size)) {
+        fatal("Invalid store distance table size!\n");
+    }
+    fatal_if(history_size <= 0, "Store distance history must not be empty");
+}
+
+void
+StoreDistance::checkClear()
+{
+    memOpsPred++;
+    if (memOpsPred > clearPeriod) {
+        DPRINTF(StoreDistance, "Wiping predictor state because %d stores "
+                "executed\n", clearPeriod);
+        memOpsPred = 0;
+        clear();
+    }
+}
+
+void
+StoreDistance::violation(Addr store_PC, InstSeqNum store_seq_num,
+                         Addr load_PC, InstSeqNum load_seq_num)
+{
+    auto seq_lt = [](InstSeqNum a, InstSeqNum b) { return a < b; };
+    auto store_it = std::lower_bound(storeHistory.begin(),
+            storeHistory.end(), store_seq_num, seq_lt);
+
+    if (store_it == storeHistory.end() || *store_it != store_seq_num) {
+        DPRINTF(StoreDistance, "Violating store [sn:%lli] is no longer in "
+                "the history\n", store_seq_num);
+        return;
+    }
+
+    auto load_it = std::lower_bound(store_it, storeHistory.end(),
+            load_seq_num, seq_lt);
+    unsigned dist = load_it - store_it;
+    assert(dist > 0);
+
+    // Keep the shortest distance seen; waiting on a younger store than
+    // needed is safe, waiting on an older one is not.
+    unsigned &entry = distance[calcIndex(load_PC)];
+    if (!entry || dist < entry)
+        entry = dist;
+
+    DPRINTF(StoreDistance, "Load %#x now waits %i stores back (store %#x)\n",
+            load_PC, entry, store_PC);
+}
+
+void
+StoreDistance::insertLoad(Addr load_PC, InstSeqNum load_seq_num)
+{
+    checkClear();
+}
+
+void
+StoreDistance::insertStore(Addr store_PC, InstSeqNum store_seq_num,
+                           ThreadID tid)
+{
+    checkClear();
+
+    if (storeHistory.full())
+        storeHistory.pop_front();
+    assert(storeHistory.empty() || storeHistory.back() < store_seq_num);
+    storeHistory.push_back(store_seq_num);
+}
+
+InstSeqNum
+StoreDistance::checkInst(Addr PC)
+{
+    unsigned dist = distance[calcIndex(PC)];
+
+    // The instruction being checked has not been inserted yet, so the
+    // youngest store in the history is one store back.
+    if (!dist || dist > storeHistory.size()) {
+        return 0;
+    }
+
+    InstSeqNum dep = *(storeHistory.end() - dist);
+    DPRINTF(StoreDistance, "Inst %#x is %i stores after [sn:%lli]\n",
+            PC, dist, dep);
+    return dep;
+}
+
+void
+StoreDistance::squash(InstSeqNum squashed_num, ThreadID tid)
+{
+    while (!storeHistory.empty() && storeHistory.back() > squashed_num)
+        storeHistory.pop_back();
+}
+
+void
+StoreDistance::clear()
+{
+    std::fill(distance.begin(), distance.end(), 0);
+}
+
+void
+StoreDistance::dump()
+{
+    cprintf("storeHistory.size(): %i\n", storeHistory.size());
+    for (int i = 0; i < distance.size(); ++i) {
+        if (distance[i])
+            cprintf("%i: distance %i\n", i, distance[i]);
+    }
+}
+
+} // namespace o3
+} // namespace gem5
@@ -0,0 +1,110 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_STORE_DISTANCE_HH__
+#define __CPU_O3_STORE_DISTANCE_HH__
+
+#include <vector>
+
+#include "base/circular_queue.hh"
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/o3/mem_dep_pred.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/**
+ * Store distance memory dependence predictor, in the style of NoSQ
+ * (Sha, Martin and Roth, "NoSQ: Store-Load Communication without a Store
+ * Queue"). Instead of grouping loads and stores into sets, each load PC
+ * remembers how many stores back, in program order, the store it last
+ * conflicted with was. A load is then made dependent on the store that
+ * is that many stores older than itself.
+ *
+ * Recent stores are kept in a ring in program order. Squashing
+ * truncates its tail, and distances are found by binary search.
+ */
+class StoreDistance : public MemDepPredictor
+{
+  public:
+    /** Creates a predictor with table_size load PC entries that can see
+     * up to history_size stores back. */
+    StoreDistance(uint64_t clear_period, int table_size, int history_size);
+
+    void violation(Addr store_PC, InstSeqNum store_seq_num,
+                   Addr load_PC, InstSeqNum load_seq_num) override;
+
+    void insertLoad(Addr load_PC, InstSeqNum load_seq_num) override;
+
+    void insertStore(Addr store_PC, InstSeqNum store_seq_num,
+                     ThreadID tid) override;
+
+    InstSeqNum checkInst(Addr PC) override;
+
+    /** Issued stores stay in the history, as they still count towards
+     * the distance of younger loads. */
+    void issued(Addr issued_PC, InstSeqNum issued_seq_num,
+                bool is_store) override {}
+
+    void squash(InstSeqNum squashed_num, ThreadID tid) override;
+
+    void clear() override;
+
+    void dump() override;
+
+  private:
+    /** Wipes the distance table every clearPeriod stores. */
+    void checkClear();
+
+    /** Calculates the index into the distance table based on the PC. */
+    int calcIndex(Addr PC) const { return (PC >> offsetBits) & indexMask; }
+
+    /** Predicted store distance per load PC; 0 means no prediction. */
+    std::vector<unsigned> distance;
+
+    /** Sequence numbers of the most recent stores, in program order. */
+    CircularQueue<InstSeqNum> storeHistory;
+
+    /** Number of stores to process before wiping the distance table. */
+    uint64_t clearPeriod;
+
+    /** Mask to obtain the index. */
+    int indexMask;
+
+    // Same PC hashing as StoreSet.
+    int offsetBits;
+
+    /** Number of stores seen since the last clear. */
+    uint64_t memOpsPred;
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_STORE_DISTANCE_HH__
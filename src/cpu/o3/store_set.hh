@@ -29,13 +29,12 @@
 #ifndef __CPU_O3_STORE_SET_HH__
 #define __CPU_O3_STORE_SET_HH__
 
-#include <list>
-#include <map>
-#include <utility>
 #include <vector>
 
+#include "base/circular_queue.hh"
 #include "base/types.hh"
 #include "cpu/inst_seq.hh"
+#include "cpu/o3/mem_dep_pred.hh"
 
 namespace gem5
 {
@@ -43,15 +42,6 @@ namespace gem5
 namespace o3
 {
 
-struct ltseqnum
-{
-    bool
-    operator()(const InstSeqNum &lhs, const InstSeqNum &rhs) const
-    {
-        return lhs > rhs;
-    }
-};
-
 /**
  * Implements a store set predictor for determining if memory
  * instructions are dependent upon each other.  See paper "Memory
@@ -59,27 +49,24 @@ struct ltseqnum
  * stands for Store Set ID, SSIT stands for Store Set ID Table, and
  * LFST is Last Fetched Store Table.
  */
-class StoreSet
+class StoreSet : public MemDepPredictor
 {
   public:
     typedef unsigned SSID;
 
   public:
-    /** Default constructor.  init() must be called prior to use. */
-    StoreSet() { };
-
-    /** Creates store set predictor with given table sizes. */
-    StoreSet(uint64_t clear_period, int SSIT_size, int LFST_size);
+    /** Creates store set predictor with given table sizes, tracking up
+     * to store_list_size in-flight stores for squashing. */
+    StoreSet(uint64_t clear_period, int SSIT_size, int LFST_size,
+             int store_list_size);
 
     /** Default destructor. */
     ~StoreSet();
 
-    /** Initializes the store set predictor with the given table sizes. */
-    void init(uint64_t clear_period, int SSIT_size, int LFST_size);
-
     /** Records a memory ordering violation between the younger load
      * and the older store. */
-    void violation(Addr store_PC, Addr load_PC);
+    void violation(Addr store_PC, InstSeqNum store_seq_num,
+                   Addr load_PC, InstSeqNum load_seq_num) override;
 
     /** Clears the store set predictor every so often so that all the
      * entries aren't used and stores are constantly predicted as
@@ -90,29 +77,31 @@ class StoreSet
     /** Inserts a load into the store set predictor.  This does nothing but
      * is included in case other predictors require a similar function.
      */
-    void insertLoad(Addr load_PC, InstSeqNum load_seq_num);
+    void insertLoad(Addr load_PC, InstSeqNum load_seq_num) override;
 
     /** Inserts a store into the store set predictor.  Updates the
      * LFST if the store has a valid SSID. */
-    void insertStore(Addr store_PC, InstSeqNum store_seq_num, ThreadID tid);
+    void insertStore(Addr store_PC, InstSeqNum store_seq_num,
+                     ThreadID tid) override;
 
     /** Checks if the instruction with the given PC is dependent upon
      * any store.  @return Returns the sequence number of the store
      * instruction this PC is dependent upon.  Returns 0 if none.
      */
-    InstSeqNum checkInst(Addr PC);
+    InstSeqNum checkInst(Addr PC) override;
 
     /** Records this PC/sequence number as issued. */
-    void issued(Addr issued_PC, InstSeqNum issued_seq_num, bool is_store);
+    void issued(Addr issued_PC, InstSeqNum issued_seq_num,
+                bool is_store) override;
 
     /** Squashes for a specific thread until the given sequence number. */
-    void squash(InstSeqNum squashed_num, ThreadID tid);
+    void squash(InstSeqNum squashed_num, ThreadID tid) override;
 
     /** Resets all tables. */
-    void clear();
+    void clear() override;
 
     /** Debug function to dump the contents of the store list. */
-    void dump();
+    void dump() override;
 
   private:
     /** Calculates the index into the SSIT based on the PC. */
@@ -135,12 +124,26 @@ class StoreSet
     /** Bit vector to tell if the LFST has a valid entry. */
     std::vector<bool> validLFST;
 
-    /** Map of stores that have been inserted into the store set, but
-     * not yet issued or squashed.
+    /** A store that has been inserted into the store set. */
+    struct StoreEntry
+    {
+        InstSeqNum seqNum;
+        SSID ssid;
+        /** Cleared once the store issues; the entry is dropped when it
+         * reaches either end of the list. */
+        bool inFlight;
+    };
+
+    /** Stores that have been inserted into the store set, but not yet
+     * issued or squashed, in program order. Stores enter in order, so
+     * squashing truncates the tail and issued stores are found by binary
+     * search. If the list fills up the oldest store is forgotten, which
+     * only means a squash can no longer clear its LFST entry.
      */
-    std::map<InstSeqNum, int, ltseqnum> storeList;
+    CircularQueue<StoreEntry> storeList;
 
-    typedef std::map<InstSeqNum, int, ltseqnum>::iterator SeqNumMapIt;
+    /** Drops issued stores from both ends of storeList. */
+    void trimStoreList();
 
     /** Number of loads/stores to process before wiping predictor so all
      * entries don't get saturated
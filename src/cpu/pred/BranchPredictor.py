@@ -29,6 +29,8 @@ from m5.SimObject import SimObject
 from m5.params import *
 from m5.proxy import *
 
+from m5.objects.ReplacementPolicies import *
+
 class IndirectPredictor(SimObject):
     type = 'IndirectPredictor'
     cxx_class = 'gem5::branch_prediction::IndirectPredictor'
@@ -52,6 +54,22 @@ class SimpleIndirectPredictor(IndirectPredictor):
     indirectGHRBits = Param.Unsigned(13, "Indirect GHR number of bits")
     instShiftAmt = Param.Unsigned(2, "Number of bits to shift instructions by")
 
+class BTBLevel(SimObject):
+    type = 'BTBLevel'
+    cxx_class = 'gem5::branch_prediction::BTBLevel'
+    cxx_header = "cpu/pred/btb.hh"
+
+    numEntries = Param.Unsigned(4096, "Number of entries")
+    assoc = Param.Unsigned(1, "Associativity")
+    tagBits = Param.Unsigned(16, "Size of the tags, in bits")
+    latency = Param.Cycles(0, "Cycles fetch is stalled for after a taken "
+        "branch whose target came from this level")
+    replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy")
+    numThreads = Param.Unsigned(Parent.numThreads, "Number of threads")
+    instShiftAmt = Param.Unsigned(Parent.instShiftAmt,
+        "Number of bits to shift instructions by")
+
 class BranchPredictor(SimObject):
     type = 'BranchPredictor'
     cxx_class = 'gem5::branch_prediction::BPredUnit'
@@ -61,7 +79,19 @@ class BranchPredictor(SimObject):
     numThreads = Param.Unsigned(Parent.numThreads, "Number of threads")
     BTBEntries = Param.Unsigned(4096, "Number of BTB entries")
     BTBTagSize = Param.Unsigned(16, "Size of the BTB tags, in bits")
+    BTBLevels = VectorParam.BTBLevel([BTBLevel(numEntries=Parent.BTBEntries,
+        tagBits=Parent.BTBTagSize)], "BTB levels, fastest first. By "
+        "default a single direct mapped level of BTBEntries entries")
+    BTBRegionEntries = Param.Unsigned(256, "Number of entries of the region "
+        "table holding the upper bits of the BTB targets, if BTBRegionBits "
+        "is not 0")
+    BTBRegionBits = Param.Unsigned(0, "Number of lower target bits kept in "
+        "the BTB entries themselves, the upper ones going to the region "
+        "table. 0 keeps full targets in the entries, without a region "
+        "table")
     RASSize = Param.Unsigned(16, "RAS size")
+    historyEntries = Param.Unsigned(64, "Number of in-flight branches per "
+        "thread the history is preallocated for, grown if exceeded")
     instShiftAmt = Param.Unsigned(2, "Number of bits to shift instructions by")
 
     indirectBranchPred = Param.IndirectPredictor(SimpleIndirectPredictor(),
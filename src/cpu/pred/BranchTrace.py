@@ -0,0 +1,62 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+from m5.SimObject import SimObject
+from m5.objects.Probe import ProbeListenerObject
+
+class BranchTraceRecorder(ProbeListenerObject):
+    """Records the branches committed by a CPU to a protobuf branch
+    trace. Set manager to the CPU to trace."""
+
+    type = 'BranchTraceRecorder'
+    cxx_class = 'gem5::branch_prediction::BranchTraceRecorder'
+    cxx_header = 'cpu/pred/branch_trace.hh'
+
+    # The trace file is created in the output directory, and compressed
+    # if its name ends with .gz
+    trace_file = Param.String("branches.trace.gz", "Branch trace file name")
+    async_write = Param.Bool(True, "Compress and write the trace in a "
+                             "background thread")
+
+class BranchTracePlayer(SimObject):
+    """Replays a branch trace through a list of branch predictors and
+    reports their misprediction rates. No CPU or memory system is needed,
+    see configs/example/bpred_trace.py."""
+
+    type = 'BranchTracePlayer'
+    cxx_class = 'gem5::branch_prediction::BranchTracePlayer'
+    cxx_header = 'cpu/pred/branch_trace.hh'
+
+    trace_file = Param.String("Branch trace to replay")
+    predictors = VectorParam.BranchPredictor("Branch predictors to evaluate")
+    numThreads = Param.Unsigned(1, "Number of hardware threads in the trace")
+
+    # Predictors which draw random numbers (e.g. the loop predictor of
+    # LTAGE and the multiperspective perceptrons) have a generator of their
+    # own, so the results don't depend on the number of host threads.
+    host_threads = Param.Unsigned(1, "Number of host threads replaying "
+                                  "predictors in parallel")
+    default_inst_size = Param.Unsigned(4, "Size assumed for calls whose "
+                                       "return is not in the trace")
@@ -75,7 +75,7 @@ BiModeBP::BiModeBP(const BiModeBPParams &params)
 void
 BiModeBP::uncondBranch(ThreadID tid, Addr pc, void * &bpHistory)
 {
-    BPHistory *history = new BPHistory;
+    BPHistory *history = new (historyPool) BPHistory;
     history->globalHistoryReg = globalHistoryReg[tid];
     history->takenUsed = true;
     history->takenPred = true;
@@ -123,7 +123,7 @@ BiModeBP::lookup(ThreadID tid, Addr branchAddr, void * &bpHistory)
                                  > notTakenThreshold;
     bool finalPrediction;
 
-    BPHistory *history = new BPHistory;
+    BPHistory *history = new (historyPool) BPHistory;
     history->globalHistoryReg = globalHistoryReg[tid];
     history->takenUsed = choicePrediction;
     history->takenPred = takenGHBPrediction;
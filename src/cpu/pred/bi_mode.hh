@@ -71,7 +71,7 @@ class BiModeBP : public BPredUnit
   private:
     void updateGlobalHistReg(ThreadID tid, bool taken);
 
-    struct BPHistory
+    struct BPHistory : public Recyclable
     {
         unsigned globalHistoryReg;
         // was the taken array's prediction used?
@@ -43,9 +43,11 @@
 #include "cpu/pred/bpred_unit.hh"
 
 #include <algorithm>
+#include <memory>
 
 #include "arch/generic/pcstate.hh"
 #include "base/compiler.hh"
+#include "base/logging.hh"
 #include "base/trace.hh"
 #include "config/the_isa.hh"
 #include "debug/Branch.hh"
@@ -60,15 +62,19 @@ BPredUnit::BPredUnit(const Params &params)
     : SimObject(params),
       numThreads(params.numThreads),
       predHist(numThreads),
-      BTB(params.BTBEntries,
-          params.BTBTagSize,
-          params.instShiftAmt,
-          params.numThreads),
+      BTB(params, this),
+      btbLatency(numThreads, Cycles(0)),
       RAS(numThreads),
       iPred(params.indirectBranchPred),
       stats(this),
-      instShiftAmt(params.instShiftAmt)
+      instShiftAmt(params.instShiftAmt),
+      historyPool(this, "historyPool", "branch history objects")
 {
+    fatal_if(params.historyEntries == 0,
+             "The branch history needs at least one entry.");
+    for (auto &ph : predHist)
+        ph = std::make_unique<History>(params.historyEntries);
+
     for (auto& r : RAS)
         r.init(params.RASSize);
 }
@@ -124,7 +130,26 @@ BPredUnit::drainSanityCheck() const
     // We shouldn't have any outstanding requests when we resume from
     // a drained system.
     for ([[maybe_unused]] const auto& ph : predHist)
-        assert(ph.empty());
+        assert(ph->empty());
+}
+
+BPredUnit::PredictorHistory &
+BPredUnit::pushHistory(ThreadID tid)
+{
+    std::unique_ptr<History> &pred_hist = predHist[tid];
+    if (pred_hist->full()) {
+        // More branches are in flight than expected. Double the capacity,
+        // which keeps the cost of growing amortised.
+        auto grown = std::make_unique<History>(2 * pred_hist->capacity());
+        for (auto &entry : *pred_hist) {
+            grown->advance_tail();
+            grown->back() = std::move(entry);
+        }
+        pred_hist = std::move(grown);
+    }
+
+    pred_hist->advance_tail();
+    return pred_hist->back();
 }
 
 bool
@@ -145,6 +170,8 @@ BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
     void *bp_history = NULL;
     void *indirect_history = NULL;
 
+    btbLatency[tid] = Cycles(0);
+
     if (inst->isUncondCtrl()) {
         DPRINTF(Branch, "[tid:%i] [sn:%llu] Unconditional control\n",
             tid,seqNum);
@@ -169,8 +196,9 @@ BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
             "[tid:%i] [sn:%llu] Creating prediction history for PC %s\n",
             tid, seqNum, pc);
 
-    PredictorHistory predict_record(seqNum, pc.instAddr(), pred_taken,
-                                    bp_history, indirect_history, tid, inst);
+    PredictorHistory &predict_record = pushHistory(tid);
+    predict_record.reset(seqNum, pc.instAddr(), pred_taken, bp_history,
+                         indirect_history, tid, inst);
 
     // Now lookup in the BTB or RAS.
     if (pred_taken) {
@@ -212,10 +240,11 @@ BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
             if (inst->isDirectCtrl() || !iPred) {
                 ++stats.BTBLookups;
                 // Check BTB on direct branches
-                if (BTB.valid(pc.instAddr(), tid)) {
+                if (const PCStateBase *btb_target =
+                        BTB.lookup(pc.instAddr(), tid, &btbLatency[tid])) {
                     ++stats.BTBHits;
                     // If it's not a return, use the BTB to get target addr.
-                    set(target, BTB.lookup(pc.instAddr(), tid));
+                    set(target, btb_target);
                     DPRINTF(Branch,
                             "[tid:%i] [sn:%llu] Instruction %s predicted "
                             "target is %s\n",
@@ -290,90 +319,101 @@ BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
         iPred->updateDirectionInfo(tid, orig_pred_taken);
     }
 
-    predHist[tid].push_front(predict_record);
-
     DPRINTF(Branch,
             "[tid:%i] [sn:%llu] History entry added. "
             "predHist.size(): %i\n",
-            tid, seqNum, predHist[tid].size());
+            tid, seqNum, predHist[tid]->size());
 
     return pred_taken;
 }
 
+Addr
+BPredUnit::predictFetchBlock(Addr start_pc, Addr end_pc, ThreadID tid)
+{
+    for (Addr pc = start_pc; pc < end_pc; pc += 1 << instShiftAmt) {
+        const Addr target = BTB.probeTarget(pc, tid);
+        if (target != MaxAddr)
+            return target;
+    }
+    return end_pc;
+}
+
 void
 BPredUnit::update(const InstSeqNum &done_sn, ThreadID tid)
 {
     DPRINTF(Branch, "[tid:%i] Committing branches until "
             "sn:%llu]\n", tid, done_sn);
 
-    while (!predHist[tid].empty() &&
-           predHist[tid].back().seqNum <= done_sn) {
+    History &pred_hist = *predHist[tid];
+
+    while (!pred_hist.empty() &&
+           pred_hist.front().seqNum <= done_sn) {
         // Update the branch predictor with the correct results.
-        update(tid, predHist[tid].back().pc,
-                    predHist[tid].back().predTaken,
-                    predHist[tid].back().bpHistory, false,
-                    predHist[tid].back().inst,
-                    predHist[tid].back().target);
+        update(tid, pred_hist.front().pc,
+                    pred_hist.front().predTaken,
+                    pred_hist.front().bpHistory, false,
+                    pred_hist.front().inst,
+                    pred_hist.front().target);
 
         if (iPred) {
-            iPred->commit(done_sn, tid, predHist[tid].back().indirectHistory);
+            iPred->commit(done_sn, tid, pred_hist.front().indirectHistory);
         }
 
-        predHist[tid].pop_back();
+        pred_hist.pop_front();
     }
 }
 
 void
 BPredUnit::squash(const InstSeqNum &squashed_sn, ThreadID tid)
 {
-    History &pred_hist = predHist[tid];
+    History &pred_hist = *predHist[tid];
 
     if (iPred) {
         iPred->squash(squashed_sn, tid);
     }
 
     while (!pred_hist.empty() &&
-           pred_hist.front().seqNum > squashed_sn) {
-        if (pred_hist.front().usedRAS) {
-            if (pred_hist.front().RASTarget != nullptr) {
+           pred_hist.back().seqNum > squashed_sn) {
+        if (pred_hist.back().usedRAS) {
+            if (pred_hist.back().RASTarget != nullptr) {
                 DPRINTF(Branch, "[tid:%i] [squash sn:%llu]"
                         " Restoring top of RAS to: %i,"
                         " target: %s\n", tid, squashed_sn,
-                        pred_hist.front().RASIndex,
-                        *pred_hist.front().RASTarget);
+                        pred_hist.back().RASIndex,
+                        *pred_hist.back().RASTarget);
             }
             else {
                 DPRINTF(Branch, "[tid:%i] [squash sn:%llu]"
                         " Restoring top of RAS to: %i,"
                         " target: INVALID_TARGET\n", tid, squashed_sn,
-                        pred_hist.front().RASIndex);
+                        pred_hist.back().RASIndex);
             }
 
-            RAS[tid].restore(pred_hist.front().RASIndex,
-                             pred_hist.front().RASTarget.get());
-        } else if (pred_hist.front().wasCall && pred_hist.front().pushedRAS) {
+            RAS[tid].restore(pred_hist.back().RASIndex,
+                             pred_hist.back().RASTarget.get());
+        } else if (pred_hist.back().wasCall && pred_hist.back().pushedRAS) {
              // Was a call but predicated false. Pop RAS here
              DPRINTF(Branch, "[tid:%i] [squash sn:%llu] Squashing"
                      "  Call [sn:%llu] PC: %s Popping RAS\n", tid, squashed_sn,
-                     pred_hist.front().seqNum, pred_hist.front().pc);
+                     pred_hist.back().seqNum, pred_hist.back().pc);
              RAS[tid].pop();
         }
 
         // This call should delete the bpHistory.
-        squash(tid, pred_hist.front().bpHistory);
+        squash(tid, pred_hist.back().bpHistory);
         if (iPred) {
-            iPred->deleteIndirectInfo(tid, pred_hist.front().indirectHistory);
+            iPred->deleteIndirectInfo(tid, pred_hist.back().indirectHistory);
         }
 
         DPRINTF(Branch, "[tid:%i] [squash sn:%llu] "
                 "Removing history for [sn:%llu] "
-                "PC %#x\n", tid, squashed_sn, pred_hist.front().seqNum,
-                pred_hist.front().pc);
+                "PC %#x\n", tid, squashed_sn, pred_hist.back().seqNum,
+                pred_hist.back().pc);
 
-        pred_hist.pop_front();
+        pred_hist.pop_back();
 
         DPRINTF(Branch, "[tid:%i] [squash sn:%llu] predHist.size(): %i\n",
-                tid, squashed_sn, predHist[tid].size());
+                tid, squashed_sn, pred_hist.size());
     }
 }
 
@@ -393,7 +433,7 @@ BPredUnit::squash(const InstSeqNum &squashed_sn,
     //     PC-relative, branch was predicted incorrectly. If so, a signal
     //     to the fetch stage is sent to squash history after the mispredict
 
-    History &pred_hist = predHist[tid];
+    History &pred_hist = *predHist[tid];
 
     ++stats.condIncorrect;
     ppMisses->notify(1);
@@ -409,24 +449,21 @@ BPredUnit::squash(const InstSeqNum &squashed_sn,
     // fix up the entry.
     if (!pred_hist.empty()) {
 
-        auto hist_it = pred_hist.begin();
-        //HistoryIt hist_it = find(pred_hist.begin(), pred_hist.end(),
-        //                       squashed_sn);
-
-        //assert(hist_it != pred_hist.end());
-        if (pred_hist.front().seqNum != squashed_sn) {
-            DPRINTF(Branch, "Front sn %i != Squash sn %i\n",
-                    pred_hist.front().seqNum, squashed_sn);
+        // The youngest remaining entry is the mispredicted branch.
+        PredictorHistory &hist = pred_hist.back();
+        if (hist.seqNum != squashed_sn) {
+            DPRINTF(Branch, "Youngest sn %i != Squash sn %i\n",
+                    hist.seqNum, squashed_sn);
 
-            assert(pred_hist.front().seqNum == squashed_sn);
+            assert(hist.seqNum == squashed_sn);
         }
 
 
-        if ((*hist_it).usedRAS) {
+        if (hist.usedRAS) {
             ++stats.RASIncorrect;
             DPRINTF(Branch,
                     "[tid:%i] [squash sn:%llu] Incorrect RAS [sn:%llu]\n",
-                    tid, squashed_sn, hist_it->seqNum);
+                    tid, squashed_sn, hist.seqNum);
         }
 
         // There are separate functions for in-order and out-of-order
@@ -439,67 +476,68 @@ BPredUnit::squash(const InstSeqNum &squashed_sn,
         // the branch actually commits.
 
         // Remember the correct direction for the update at commit.
-        pred_hist.front().predTaken = actually_taken;
-        pred_hist.front().target = corr_target.instAddr();
+        hist.predTaken = actually_taken;
+        hist.target = corr_target.instAddr();
 
-        update(tid, (*hist_it).pc, actually_taken,
-               pred_hist.front().bpHistory, true, pred_hist.front().inst,
-               corr_target.instAddr());
+        update(tid, hist.pc, actually_taken, hist.bpHistory, true,
+               hist.inst, corr_target.instAddr());
 
         if (iPred) {
             iPred->changeDirectionPrediction(tid,
-                pred_hist.front().indirectHistory, actually_taken);
+                hist.indirectHistory, actually_taken);
         }
 
         if (actually_taken) {
-            if (hist_it->wasReturn && !hist_it->usedRAS) {
+            if (hist.wasReturn && !hist.usedRAS) {
                  DPRINTF(Branch, "[tid:%i] [squash sn:%llu] "
                         "Incorrectly predicted "
                         "return [sn:%llu] PC: %#x\n", tid, squashed_sn,
-                        hist_it->seqNum,
-                        hist_it->pc);
+                        hist.seqNum,
+                        hist.pc);
                  RAS[tid].pop();
-                 hist_it->usedRAS = true;
+                 hist.usedRAS = true;
+                 // Entries are reused, so drop any stale RAS target.
+                 hist.RASTarget.reset();
             }
-            if (hist_it->wasIndirect) {
+            if (hist.wasIndirect) {
                 ++stats.indirectMispredicted;
                 if (iPred) {
-                    iPred->recordTarget(
-                        hist_it->seqNum, pred_hist.front().indirectHistory,
-                        corr_target, tid);
+                    iPred->recordTarget(hist.seqNum, hist.indirectHistory,
+                                        corr_target, tid);
                 }
             } else {
                 DPRINTF(Branch,"[tid:%i] [squash sn:%llu] "
                         "BTB Update called for [sn:%llu] "
                         "PC %#x\n", tid, squashed_sn,
-                        hist_it->seqNum, hist_it->pc);
+                        hist.seqNum, hist.pc);
 
-                BTB.update(hist_it->pc, corr_target, tid);
+                BTB.update(hist.pc, corr_target, getBranchType(hist.inst),
+                           tid);
             }
         } else {
            //Actually not Taken
-           if (hist_it->usedRAS) {
+           if (hist.usedRAS) {
                 DPRINTF(Branch,
                         "[tid:%i] [squash sn:%llu] Incorrectly predicted "
                         "return [sn:%llu] PC: %#x Restoring RAS\n", tid,
                         squashed_sn,
-                        hist_it->seqNum, hist_it->pc);
+                        hist.seqNum, hist.pc);
                 DPRINTF(Branch,
                         "[tid:%i] [squash sn:%llu] Restoring top of RAS "
                         "to: %i, target: %s\n", tid, squashed_sn,
-                        hist_it->RASIndex, *hist_it->RASTarget);
-                RAS[tid].restore(hist_it->RASIndex, hist_it->RASTarget.get());
-                hist_it->usedRAS = false;
-           } else if (hist_it->wasCall && hist_it->pushedRAS) {
+                        hist.RASIndex, *hist.RASTarget);
+                RAS[tid].restore(hist.RASIndex, hist.RASTarget.get());
+                hist.usedRAS = false;
+           } else if (hist.wasCall && hist.pushedRAS) {
                  //Was a Call but predicated false. Pop RAS here
                  DPRINTF(Branch,
                         "[tid:%i] [squash sn:%llu] "
                         "Incorrectly predicted "
                         "Call [sn:%llu] PC: %s Popping RAS\n",
                         tid, squashed_sn,
-                        hist_it->seqNum, hist_it->pc);
+                        hist.seqNum, hist.pc);
                  RAS[tid].pop();
-                 hist_it->pushedRAS = false;
+                 hist.pushedRAS = false;
            }
         }
     } else {
@@ -513,12 +551,12 @@ BPredUnit::dump()
 {
     int i = 0;
     for (const auto& ph : predHist) {
-        if (!ph.empty()) {
-            auto pred_hist_it = ph.begin();
+        if (!ph->empty()) {
+            auto pred_hist_it = ph->begin();
 
-            cprintf("predHist[%i].size(): %i\n", i++, ph.size());
+            cprintf("predHist[%i].size(): %i\n", i++, ph->size());
 
-            while (pred_hist_it != ph.end()) {
+            while (pred_hist_it != ph->end()) {
                 cprintf("sn:%llu], PC:%#x, tid:%i, predTaken:%i, "
                         "bpHistory:%#x\n",
                         pred_hist_it->seqNum, pred_hist_it->pc,
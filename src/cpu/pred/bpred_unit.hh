@@ -42,8 +42,10 @@
 #ifndef __CPU_PRED_BPRED_UNIT_HH__
 #define __CPU_PRED_BPRED_UNIT_HH__
 
-#include <deque>
+#include <memory>
 
+#include "base/circular_queue.hh"
+#include "base/recycling_pool.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "cpu/pred/btb.hh"
@@ -167,6 +169,26 @@ class BPredUnit : public SimObject
         return BTB.lookup(inst_pc, 0);
     }
 
+    /**
+     * Returns how many cycles the BTB took to provide the target of the
+     * last branch predict() was called for, or zero if the target did not
+     * come from the BTB.
+     * @param tid The thread id.
+     */
+    Cycles BTBLatency(ThreadID tid) const { return btbLatency[tid]; }
+
+    /**
+     * Predicts where fetch goes after the block [start_pc, end_pc) by
+     * looking for the first branch in it the BTB has a target for. Only
+     * the BTB is consulted, so unlike predict() this can run ahead of
+     * fetch without disturbing the speculative predictor state.
+     * @param start_pc The address the block starts at.
+     * @param end_pc The address just past the end of the block.
+     * @param tid The thread id.
+     * @return The target of the first branch found, or end_pc.
+     */
+    Addr predictFetchBlock(Addr start_pc, Addr end_pc, ThreadID tid);
+
     /**
      * Updates the BP with taken/not taken information.
      * @param inst_PC The branch's PC that will be updated.
@@ -187,11 +209,12 @@ class BPredUnit : public SimObject
      * Updates the BTB with the target of a branch.
      * @param inst_PC The branch's PC that will be updated.
      * @param target_PC The branch's target that will be added to the BTB.
+     * @param type The kind of branch.
      */
     void
-    BTBUpdate(Addr instPC, const PCStateBase &target)
+    BTBUpdate(Addr instPC, const PCStateBase &target, BranchType type)
     {
-        BTB.update(instPC, target, 0);
+        BTB.update(instPC, target, type, 0);
     }
 
 
@@ -200,28 +223,34 @@ class BPredUnit : public SimObject
   private:
     struct PredictorHistory
     {
+        PredictorHistory() = default;
+        PredictorHistory(PredictorHistory &&other) = default;
+        PredictorHistory &operator=(PredictorHistory &&other) = default;
+
         /**
-         * Makes a predictor history struct that contains any
+         * Resets a predictor history entry so it contains any
          * information needed to update the predictor, BTB, and RAS.
+         * Entries are reused, so the RAS target keeps its allocation.
          */
-        PredictorHistory(const InstSeqNum &seq_num, Addr instPC,
-                         bool pred_taken, void *bp_history,
-                         void *indirect_history, ThreadID _tid,
-                         const StaticInstPtr & inst)
-            : seqNum(seq_num), pc(instPC), bpHistory(bp_history),
-              indirectHistory(indirect_history), tid(_tid),
-              predTaken(pred_taken), inst(inst)
-        {}
-
-        PredictorHistory(const PredictorHistory &other) :
-            seqNum(other.seqNum), pc(other.pc), bpHistory(other.bpHistory),
-            indirectHistory(other.indirectHistory), RASIndex(other.RASIndex),
-            tid(other.tid), predTaken(other.predTaken), usedRAS(other.usedRAS),
-            pushedRAS(other.pushedRAS), wasCall(other.wasCall),
-            wasReturn(other.wasReturn), wasIndirect(other.wasIndirect),
-            target(other.target), inst(other.inst)
+        void
+        reset(const InstSeqNum &seq_num, Addr instPC, bool pred_taken,
+              void *bp_history, void *indirect_history, ThreadID _tid,
+              const StaticInstPtr &_inst)
         {
-            set(RASTarget, other.RASTarget);
+            seqNum = seq_num;
+            pc = instPC;
+            bpHistory = bp_history;
+            indirectHistory = indirect_history;
+            RASIndex = 0;
+            tid = _tid;
+            predTaken = pred_taken;
+            usedRAS = false;
+            pushedRAS = false;
+            wasCall = false;
+            wasReturn = false;
+            wasIndirect = false;
+            target = MaxAddr;
+            inst = _inst;
         }
 
         bool
@@ -231,10 +260,10 @@ class BPredUnit : public SimObject
         }
 
         /** The sequence number for the predictor history entry. */
-        InstSeqNum seqNum;
+        InstSeqNum seqNum = 0;
 
         /** The PC associated with the sequence number. */
-        Addr pc;
+        Addr pc = 0;
 
         /** Pointer to the history object passed back from the branch
          * predictor.  It is used to update or restore state of the
@@ -251,10 +280,10 @@ class BPredUnit : public SimObject
         unsigned RASIndex = 0;
 
         /** The thread id. */
-        ThreadID tid;
+        ThreadID tid = InvalidThreadID;
 
         /** Whether or not it was predicted taken. */
-        bool predTaken;
+        bool predTaken = false;
 
         /** Whether or not the RAS was used. */
         bool usedRAS = false;
@@ -277,10 +306,18 @@ class BPredUnit : public SimObject
         Addr target = MaxAddr;
 
         /** The branch instrction */
-        const StaticInstPtr inst;
+        StaticInstPtr inst;
     };
 
-    typedef std::deque<PredictorHistory> History;
+    /**
+     * History entries of a thread, oldest first. The entries are
+     * preallocated and reused, and the queue only grows if more branches
+     * than it can hold are in flight.
+     */
+    typedef CircularQueue<PredictorHistory> History;
+
+    /** Appends a blank entry for the youngest branch of a thread. */
+    PredictorHistory &pushHistory(ThreadID tid);
 
     /** Number of the threads for which the branch history is maintained. */
     const unsigned numThreads;
@@ -291,11 +328,14 @@ class BPredUnit : public SimObject
      * as instructions are committed, or restore it to the proper state after
      * a squash.
      */
-    std::vector<History> predHist;
+    std::vector<std::unique_ptr<History>> predHist;
 
     /** The BTB. */
     DefaultBTB BTB;
 
+    /** Per thread latency of the last target the BTB provided. */
+    std::vector<Cycles> btbLatency;
+
     /** The per-thread return address stack. */
     std::vector<ReturnAddrStack> RAS;
 
@@ -337,6 +377,12 @@ class BPredUnit : public SimObject
     /** Number of bits to shift instructions by for predictor addresses. */
     const unsigned instShiftAmt;
 
+    /**
+     * Pool the predictors recycle their per-branch history objects
+     * through, so predicting a branch doesn't need the heap.
+     */
+    RecyclingPool historyPool;
+
     /**
      * @{
      * @name PMU Probe points.
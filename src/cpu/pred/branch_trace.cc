@@ -0,0 +1,375 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/branch_trace.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unordered_map>
+
+#include "arch/generic/pcstate.hh"
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "proto/branch.pb.h"
+#include "sim/sim_exit.hh"
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+BranchTraceRecorder::BranchTraceRecorder(
+        const BranchTraceRecorderParams &params)
+    : ProbeListenerObject(params),
+      traceStream(nullptr),
+      instsSinceBranch(0)
+{
+    const std::string filename = simout.resolve(params.trace_file);
+    traceStream = new ProtoOutputStream(filename, params.async_write);
+
+    ProtoMessage::BranchHeader header;
+    header.set_obj_id(name());
+    traceStream->write(header);
+
+    registerExitCallback([this]() { closeStream(); });
+}
+
+BranchTraceRecorder::~BranchTraceRecorder()
+{
+    closeStream();
+}
+
+void
+BranchTraceRecorder::closeStream()
+{
+    delete traceStream;
+    traceStream = nullptr;
+}
+
+void
+BranchTraceRecorder::regProbeListeners()
+{
+    typedef ProbeListenerArg<BranchTraceRecorder, uint64_t> InstListener;
+    typedef ProbeListenerArg<BranchTraceRecorder, BaseCPU::RetiredBranch>
+        BranchListener;
+
+    listeners.push_back(new InstListener(this, "RetiredInsts",
+                &BranchTraceRecorder::retiredInsts));
+    listeners.push_back(new BranchListener(this, "RetiredBranchOutcomes",
+                &BranchTraceRecorder::retiredBranch));
+}
+
+void
+BranchTraceRecorder::retiredInsts(const uint64_t &count)
+{
+    instsSinceBranch += count;
+}
+
+void
+BranchTraceRecorder::retiredBranch(const BaseCPU::RetiredBranch &branch)
+{
+    if (!traceStream)
+        return;
+
+    const StaticInstPtr &inst = branch.inst;
+    uint32_t type = 0;
+    if (inst->isCondCtrl())
+        type |= ProtoMessage::Branch::Conditional;
+    if (inst->isIndirectCtrl())
+        type |= ProtoMessage::Branch::Indirect;
+    if (inst->isCall())
+        type |= ProtoMessage::Branch::Call;
+    if (inst->isReturn())
+        type |= ProtoMessage::Branch::Return;
+
+    ProtoMessage::Branch msg;
+    msg.set_pc(branch.pc);
+    msg.set_target(branch.target);
+    msg.set_taken(branch.taken);
+    msg.set_type(type);
+    // Leave out fields holding their default value to keep the trace
+    // small.
+    if (instsSinceBranch != 1)
+        msg.set_insts(instsSinceBranch);
+    if (branch.tid != 0)
+        msg.set_tid(branch.tid);
+    traceStream->write(msg);
+
+    instsSinceBranch = 0;
+}
+
+namespace
+{
+
+/**
+ * Instruction standing in for a traced branch. It only carries the
+ * flags the predictors look at; the PC states it is used with hold the
+ * address of the following instruction as their next PC.
+ */
+class TraceBranchInst : public StaticInst
+{
+  public:
+    TraceBranchInst(uint8_t type)
+        : StaticInst("trace_branch", No_OpClass)
+    {
+        setFlag(IsControl);
+        setFlag(type & ProtoMessage::Branch::Conditional ?
+                IsCondControl : IsUncondControl);
+        setFlag(type & ProtoMessage::Branch::Indirect ?
+                IsIndirectControl : IsDirectControl);
+        if (type & ProtoMessage::Branch::Call)
+            setFlag(IsCall);
+        if (type & ProtoMessage::Branch::Return)
+            setFlag(IsReturn);
+    }
+
+    Fault
+    execute(ExecContext *xc, Trace::InstRecord *traceData) const override
+    {
+        panic("Traced branches can't be executed.");
+    }
+
+    void
+    advancePC(PCStateBase &pc) const override
+    {
+        pc.advance();
+    }
+
+    std::unique_ptr<PCStateBase>
+    buildRetPC(const PCStateBase &cur_pc,
+            const PCStateBase &call_pc) const override
+    {
+        std::unique_ptr<PCStateBase> ret_pc(call_pc.clone());
+        ret_pc->advance();
+        return ret_pc;
+    }
+
+    std::string
+    generateDisassembly(Addr pc,
+            const loader::SymbolTable *symtab) const override
+    {
+        return mnemonic;
+    }
+};
+
+/** PC state with an explicit next PC; the width only matters for advance */
+typedef GenericISA::SimplePCState<1> TracePCState;
+
+TracePCState
+tracePC(Addr pc, Addr npc)
+{
+    TracePCState state(pc);
+    state.npc(npc);
+    return state;
+}
+
+} // anonymous namespace
+
+BranchTracePlayer::BranchTracePlayer(const BranchTracePlayerParams &params)
+    : SimObject(params),
+      predictors(params.predictors),
+      numHostThreads(params.host_threads),
+      numThreads(params.numThreads),
+      defaultInstSize(params.default_inst_size),
+      totalInsts(0),
+      replayEvent([this]{ replayAll(); }, name())
+{
+    fatal_if(numHostThreads == 0,
+             "%s: host_threads must be at least 1.\n", name());
+    fatal_if(defaultInstSize == 0,
+             "%s: default_inst_size must be non-zero.\n", name());
+
+    for (auto *bp : predictors)
+        predStats.emplace_back(new PredictorStats(bp, "replay"));
+
+    loadTrace(params.trace_file);
+}
+
+BranchTracePlayer::BranchInsts
+BranchTracePlayer::makeBranchInsts()
+{
+    BranchInsts insts;
+    for (uint8_t type = 0; type < NumBranchTypes; type++)
+        insts[type] = new TraceBranchInst(type);
+    return insts;
+}
+
+void
+BranchTracePlayer::loadTrace(const std::string &filename)
+{
+    ProtoInputStream stream(filename);
+
+    ProtoMessage::BranchHeader header;
+    fatal_if(!stream.read(header),
+             "%s: Failed to read the header of branch trace %s.\n",
+             name(), filename);
+    fatal_if(header.ver() != 0,
+             "%s: Unsupported branch trace version %d.\n",
+             name(), header.ver());
+
+    // Return addresses tell us where calls end, which we need to predict
+    // returns. Match calls and returns on a shadow stack per thread.
+    std::unordered_map<ThreadID, std::vector<size_t>> calls;
+
+    ProtoMessage::Branch msg;
+    while (stream.read(msg)) {
+        Record rec;
+        rec.pc = msg.pc();
+        rec.target = msg.target();
+        rec.taken = msg.taken();
+        rec.type = msg.type() & (NumBranchTypes - 1);
+        rec.insts = msg.insts();
+        rec.fallThrough = rec.taken ? rec.pc + defaultInstSize : rec.target;
+
+        fatal_if(msg.tid() >= numThreads,
+                 "%s: Branch trace uses thread %d but there are only %d "
+                 "threads.\n", name(), msg.tid(), numThreads);
+        rec.tid = msg.tid();
+
+        auto &stack = calls[rec.tid];
+        if (rec.type & ProtoMessage::Branch::Return && rec.taken &&
+                !stack.empty()) {
+            Record &call = trace[stack.back()];
+            stack.pop_back();
+            if (rec.target > call.pc &&
+                    rec.target - call.pc <= MaxCallSize) {
+                call.fallThrough = rec.target;
+            }
+        }
+        if (rec.type & ProtoMessage::Branch::Call && rec.taken)
+            stack.push_back(trace.size());
+
+        totalInsts += rec.insts;
+        trace.push_back(rec);
+    }
+
+    inform("%s: Loaded %d branches covering %d instructions from %s.\n",
+           name(), trace.size(), totalInsts, filename);
+}
+
+void
+BranchTracePlayer::startup()
+{
+    schedule(replayEvent, curTick());
+}
+
+void
+BranchTracePlayer::replayAll()
+{
+    const unsigned num_workers = std::min<size_t>(numHostThreads,
+                                                  predictors.size());
+    std::atomic<size_t> next(0);
+    auto worker = [this, &next]() {
+        const BranchInsts branch_insts = makeBranchInsts();
+        size_t idx;
+        while ((idx = next++) < predictors.size())
+            replay(idx, branch_insts);
+    };
+
+    if (num_workers <= 1) {
+        worker();
+    } else {
+        EventQueue *eventq = eventQueue();
+        std::vector<std::thread> threads;
+        for (unsigned i = 0; i < num_workers; i++) {
+            threads.emplace_back([eventq, &worker]() {
+                // Predictors may use curTick(), e.g. in debug output.
+                curEventQueue(eventq);
+                worker();
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+    exitSimLoop("branch trace replay complete");
+}
+
+void
+BranchTracePlayer::replay(size_t idx, const BranchInsts &branch_insts)
+{
+    BPredUnit *bp = predictors[idx];
+    PredictorStats &stats = *predStats[idx];
+
+    const auto start = std::chrono::steady_clock::now();
+
+    InstSeqNum seq_num = 0;
+    uint64_t mispredicted = 0;
+    for (const Record &rec : trace) {
+        seq_num++;
+
+        TracePCState pc = tracePC(rec.pc, rec.fallThrough);
+        const bool pred_taken = bp->predict(branch_insts[rec.type], seq_num,
+                                            pc, rec.tid);
+
+        if (pred_taken != rec.taken ||
+                (rec.taken && pc.instAddr() != rec.target)) {
+            mispredicted++;
+            bp->squash(seq_num, tracePC(rec.target, rec.target + 1),
+                       rec.taken, rec.tid);
+        }
+        bp->update(seq_num, rec.tid);
+    }
+
+    const std::chrono::duration<double> secs =
+        std::chrono::steady_clock::now() - start;
+
+    stats.branches += trace.size();
+    stats.mispredicted += mispredicted;
+    stats.insts += totalInsts;
+
+    inform("%s: %d mispredictions, %.3f MPKI, %.2f M branches/s\n",
+           bp->name(), mispredicted,
+           totalInsts ? 1000.0 * mispredicted / totalInsts : 0.0,
+           secs.count() > 0 ? trace.size() / secs.count() / 1e6 : 0.0);
+}
+
+BranchTracePlayer::PredictorStats::PredictorStats(statistics::Group *parent,
+                                                  const std::string &name)
+    : statistics::Group(parent, name.c_str()),
+      ADD_STAT(branches, statistics::units::Count::get(),
+               "Number of branches replayed"),
+      ADD_STAT(mispredicted, statistics::units::Count::get(),
+               "Number of branches with a mispredicted direction or "
+               "target"),
+      ADD_STAT(insts, statistics::units::Count::get(),
+               "Number of instructions covered by the trace"),
+      ADD_STAT(mpki, statistics::units::Rate<
+                    statistics::units::Count, statistics::units::Count>::get(),
+               "Mispredictions per thousand instructions",
+               mispredicted * 1000 / insts),
+      ADD_STAT(accuracy, statistics::units::Ratio::get(),
+               "Fraction of branches predicted correctly",
+               (branches - mispredicted) / branches)
+{
+    mpki.precision(4);
+    accuracy.precision(6);
+}
+
+} // namespace branch_prediction
+} // namespace gem5
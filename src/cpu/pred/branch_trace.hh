@@ -0,0 +1,170 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a probe listener that records the branches a CPU
+ * commits to a protobuf trace (see proto/branch.proto), and of a player
+ * that replays such a trace through any number of branch predictors
+ * without simulating a CPU or a memory system.
+ */
+
+#ifndef __CPU_PRED_BRANCH_TRACE_HH__
+#define __CPU_PRED_BRANCH_TRACE_HH__
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "cpu/base.hh"
+#include "cpu/pred/bpred_unit.hh"
+#include "cpu/static_inst.hh"
+#include "params/BranchTracePlayer.hh"
+#include "params/BranchTraceRecorder.hh"
+#include "proto/protoio.hh"
+#include "sim/eventq.hh"
+#include "sim/probe/probe.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+/**
+ * Writes every control instruction committed by a CPU to a branch
+ * trace, along with the number of instructions committed in between.
+ */
+class BranchTraceRecorder : public ProbeListenerObject
+{
+  public:
+    BranchTraceRecorder(const BranchTraceRecorderParams &params);
+    ~BranchTraceRecorder();
+
+    void regProbeListeners() override;
+
+    void retiredInsts(const uint64_t &count);
+    void retiredBranch(const BaseCPU::RetiredBranch &branch);
+
+  private:
+    /** Flush the trace and close the output file */
+    void closeStream();
+
+    ProtoOutputStream *traceStream;
+
+    /** Instructions committed since the last recorded branch */
+    uint64_t instsSinceBranch;
+};
+
+/**
+ * Replays a branch trace through a set of branch predictors. Every
+ * predictor sees the whole trace; predictors are independent of each
+ * other, so they can be evaluated by several host threads in parallel.
+ * Each host thread builds its own stand-in branch instructions, so their
+ * reference counts are never shared between threads, and each predictor
+ * draws from its own random number generator, so the results don't
+ * depend on the number of host threads.
+ * Each branch is predicted, squashed if mispredicted and committed
+ * before the next one is looked at, as a simple in-order core would do.
+ */
+class BranchTracePlayer : public SimObject
+{
+  public:
+    BranchTracePlayer(const BranchTracePlayerParams &params);
+
+    void startup() override;
+
+  private:
+    /** A branch of the trace, decoded once and shared by all replays */
+    struct Record
+    {
+        Addr pc;
+        Addr target;
+        /** Address of the instruction following the branch */
+        Addr fallThrough;
+        uint32_t insts;
+        ThreadID tid;
+        uint8_t type;
+        bool taken;
+    };
+
+    /** Largest distance between a call and its return address */
+    static constexpr Addr MaxCallSize = 16;
+
+    /** Number of combinations of Branch::Type bits */
+    static constexpr size_t NumBranchTypes = 16;
+
+    /** Stand-in instructions, indexed by Branch::Type bits */
+    typedef std::array<StaticInstPtr, NumBranchTypes> BranchInsts;
+
+    /** Create a set of stand-in instructions for one host thread */
+    static BranchInsts makeBranchInsts();
+
+    /** Read the whole trace into memory */
+    void loadTrace(const std::string &filename);
+
+    /** Replay all the predictors and leave the simulation loop */
+    void replayAll();
+
+    /** Replay the trace through predictor idx */
+    void replay(size_t idx, const BranchInsts &branch_insts);
+
+    std::vector<BPredUnit *> predictors;
+    const unsigned numHostThreads;
+    const unsigned numThreads;
+    const unsigned defaultInstSize;
+
+    std::vector<Record> trace;
+    uint64_t totalInsts;
+
+    EventFunctionWrapper replayEvent;
+
+    struct PredictorStats : public statistics::Group
+    {
+        PredictorStats(statistics::Group *parent, const std::string &name);
+
+        /** Number of branches replayed */
+        statistics::Scalar branches;
+        /** Number of branches with a wrong direction or target */
+        statistics::Scalar mispredicted;
+        /** Number of instructions covered by the trace */
+        statistics::Scalar insts;
+        /** Mispredictions per thousand instructions */
+        statistics::Formula mpki;
+        /** Fraction of branches predicted correctly */
+        statistics::Formula accuracy;
+    };
+
+    std::vector<std::unique_ptr<PredictorStats>> predStats;
+};
+
+} // namespace branch_prediction
+} // namespace gem5
+
+#endif // __CPU_PRED_BRANCH_TRACE_HH__
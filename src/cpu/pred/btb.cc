@@ -29,8 +29,10 @@
 #include "cpu/pred/btb.hh"
 
 #include "base/intmath.hh"
+#include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/Fetch.hh"
+#include "params/BranchPredictor.hh"
 
 namespace gem5
 {
@@ -38,109 +40,329 @@ namespace gem5
 namespace branch_prediction
 {
 
-DefaultBTB::DefaultBTB(unsigned _numEntries,
-                       unsigned _tagBits,
-                       unsigned _instShiftAmt,
-                       unsigned _num_threads)
-    : numEntries(_numEntries),
-      tagBits(_tagBits),
-      instShiftAmt(_instShiftAmt),
-      log2NumThreads(floorLog2(_num_threads))
-{
-    DPRINTF(Fetch, "BTB: Creating BTB object.\n");
+const char *branchTypeNames[] = {
+    "DirectCond", "DirectUncond", "DirectCall",
+    "Indirect", "IndirectCall", "Return"
+};
 
-    if (!isPowerOf2(numEntries)) {
-        fatal("BTB entries is not a power of 2!");
+BranchType
+getBranchType(const StaticInstPtr &inst)
+{
+    if (inst->isReturn())
+        return BranchType::Return;
+    if (inst->isDirectCtrl()) {
+        if (inst->isCall())
+            return BranchType::DirectCall;
+        return inst->isCondCtrl() ? BranchType::DirectCond :
+            BranchType::DirectUncond;
     }
+    return inst->isCall() ? BranchType::IndirectCall : BranchType::Indirect;
+}
 
-    btb.resize(numEntries);
+BTBLevel::BTBLevel(const BTBLevelParams &p)
+    : SimObject(p),
+      entries(p.numEntries),
+      assoc(p.assoc),
+      setMask(p.numEntries / std::max(p.assoc, 1U) - 1),
+      tagMask(mask(p.tagBits)),
+      instShiftAmt(p.instShiftAmt),
+      tagShiftAmt(p.instShiftAmt + floorLog2(setMask + 1)),
+      tidShiftAmt(floorLog2(setMask + 1) - floorLog2(p.numThreads)),
+      _latency(p.latency),
+      replacementPolicy(p.replacement_policy),
+      stats(this)
+{
+    fatal_if(assoc == 0 || p.numEntries % assoc,
+             "%s: BTB entries must be a multiple of the associativity.",
+             name());
+    fatal_if(!isPowerOf2(setMask + 1),
+             "%s: The number of BTB sets is not a power of 2.", name());
+    fatal_if(setMask + 1 < p.numThreads,
+             "%s: The BTB needs at least as many sets as threads.", name());
 
-    for (unsigned i = 0; i < numEntries; ++i) {
-        btb[i].valid = false;
+    for (unsigned i = 0; i < entries.size(); ++i) {
+        entries[i].setPosition(i / assoc, i % assoc);
+        entries[i].replacementData = replacementPolicy->instantiateEntry();
     }
+}
 
-    idxMask = numEntries - 1;
-
-    tagMask = (1 << tagBits) - 1;
+BTBLevel::BTBLevelStats::BTBLevelStats(statistics::Group *parent)
+    : statistics::Group(parent),
+      ADD_STAT(lookups, statistics::units::Count::get(),
+               "Number of lookups"),
+      ADD_STAT(hits, statistics::units::Count::get(), "Number of hits"),
+      ADD_STAT(hitRatio, statistics::units::Ratio::get(), "Hit ratio",
+               hits / lookups),
+      ADD_STAT(staleHits, statistics::units::Count::get(),
+               "Number of hits whose target region had been replaced"),
+      ADD_STAT(inserts, statistics::units::Count::get(),
+               "Number of branches inserted"),
+      ADD_STAT(evictions, statistics::units::Count::get(),
+               "Number of valid entries replaced"),
+      ADD_STAT(insertsByType, statistics::units::Count::get(),
+               "Number of branches inserted per branch type")
+{
+    hitRatio.precision(6);
 
-    tagShiftAmt = instShiftAmt + floorLog2(numEntries);
+    insertsByType
+        .init(static_cast<int>(BranchType::NumBranchTypes))
+        .flags(statistics::total | statistics::nozero);
+    for (int i = 0; i < static_cast<int>(BranchType::NumBranchTypes); ++i)
+        insertsByType.subname(i, branchTypeNames[i]);
 }
 
 void
-DefaultBTB::reset()
+BTBLevel::reset()
 {
-    for (unsigned i = 0; i < numEntries; ++i) {
-        btb[i].valid = false;
+    for (auto &entry : entries) {
+        entry.valid = false;
+        replacementPolicy->invalidate(entry.replacementData);
     }
 }
 
-inline
 unsigned
-DefaultBTB::getIndex(Addr instPC, ThreadID tid)
+BTBLevel::getSet(Addr inst_pc, ThreadID tid) const
 {
     // Need to shift PC over by the word offset.
-    return ((instPC >> instShiftAmt)
-            ^ (tid << (tagShiftAmt - instShiftAmt - log2NumThreads)))
-            & idxMask;
+    return ((inst_pc >> instShiftAmt) ^ (tid << tidShiftAmt)) & setMask;
 }
 
-inline
 Addr
-DefaultBTB::getTag(Addr instPC)
+BTBLevel::getTag(Addr inst_pc) const
 {
-    return (instPC >> tagShiftAmt) & tagMask;
+    return (inst_pc >> tagShiftAmt) & tagMask;
 }
 
-bool
-DefaultBTB::valid(Addr instPC, ThreadID tid)
+const BTBLevel::Entry *
+BTBLevel::probe(Addr inst_pc, ThreadID tid) const
 {
-    unsigned btb_idx = getIndex(instPC, tid);
+    const Entry *set = &entries[getSet(inst_pc, tid) * assoc];
+    const Addr tag = getTag(inst_pc);
+    for (unsigned way = 0; way < assoc; ++way) {
+        if (set[way].valid && set[way].tag == tag && set[way].tid == tid)
+            return &set[way];
+    }
+    return nullptr;
+}
 
-    Addr inst_tag = getTag(instPC);
+BTBLevel::Entry *
+BTBLevel::lookup(Addr inst_pc, ThreadID tid)
+{
+    ++stats.lookups;
+    auto *entry = const_cast<Entry *>(probe(inst_pc, tid));
+    if (entry) {
+        ++stats.hits;
+        replacementPolicy->touch(entry->replacementData);
+    }
+    return entry;
+}
 
-    assert(btb_idx < numEntries);
+BTBLevel::Entry &
+BTBLevel::allocate(Addr inst_pc, BranchType type, ThreadID tid)
+{
+    if (auto *entry = const_cast<Entry *>(probe(inst_pc, tid))) {
+        replacementPolicy->touch(entry->replacementData);
+        entry->type = type;
+        return *entry;
+    }
 
-    if (btb[btb_idx].valid
-        && inst_tag == btb[btb_idx].tag
-        && btb[btb_idx].tid == tid) {
-        return true;
-    } else {
-        return false;
+    Entry *set = &entries[getSet(inst_pc, tid) * assoc];
+    Entry *victim = nullptr;
+    for (unsigned way = 0; way < assoc && !victim; ++way) {
+        if (!set[way].valid)
+            victim = &set[way];
+    }
+    if (!victim) {
+        ReplacementCandidates candidates;
+        for (unsigned way = 0; way < assoc; ++way)
+            candidates.push_back(&set[way]);
+        victim = static_cast<Entry *>(
+                replacementPolicy->getVictim(candidates));
+        ++stats.evictions;
     }
+
+    ++stats.inserts;
+    ++stats.insertsByType[static_cast<int>(type)];
+    victim->valid = true;
+    victim->type = type;
+    victim->tag = getTag(inst_pc);
+    victim->tid = tid;
+    replacementPolicy->reset(victim->replacementData);
+    return *victim;
 }
 
-// @todo Create some sort of return struct that has both whether or not the
-// address is valid, and also the address.  For now will just use addr = 0 to
-// represent invalid entry.
-const PCStateBase *
-DefaultBTB::lookup(Addr inst_pc, ThreadID tid)
+DefaultBTB::DefaultBTB(const BranchPredictorParams &params,
+                       statistics::Group *parent)
+    : levels(params.BTBLevels),
+      regions(params.BTBRegionBits ? params.BTBRegionEntries : 0),
+      regionBits(params.BTBRegionBits),
+      stats(parent)
+{
+    DPRINTF(Fetch, "BTB: Creating BTB object.\n");
+
+    fatal_if(levels.empty(), "The BTB needs at least one level.");
+    fatal_if(regionBits && regions.empty(),
+             "The BTB region table needs an entry.");
+    fatal_if(regionBits >= sizeof(Addr) * 8,
+             "BTB region bits must be less than %d.", sizeof(Addr) * 8);
+}
+
+DefaultBTB::BTBStats::BTBStats(statistics::Group *parent)
+    : statistics::Group(parent, "btb"),
+      ADD_STAT(footprint, statistics::units::Count::get(),
+               "Number of distinct branches put into the BTB"),
+      ADD_STAT(fills, statistics::units::Count::get(),
+               "Number of entries filled into faster levels on a hit"),
+      ADD_STAT(regionHits, statistics::units::Count::get(),
+               "Number of targets encoded with an existing region"),
+      ADD_STAT(regionMisses, statistics::units::Count::get(),
+               "Number of targets which needed a new region"),
+      ADD_STAT(regionEvictions, statistics::units::Count::get(),
+               "Number of valid regions replaced")
 {
-    unsigned btb_idx = getIndex(inst_pc, tid);
+}
 
-    Addr inst_tag = getTag(inst_pc);
+void
+DefaultBTB::reset()
+{
+    for (auto *level : levels)
+        level->reset();
+    for (auto &region : regions)
+        region.valid = false;
+}
+
+void
+DefaultBTB::buildTarget(std::unique_ptr<PCStateBase> &target,
+                        const Region &region, Addr offset) const
+{
+    const Addr addr = (region.tag << regionBits) | offset;
+    set(target, *region.target);
+    // The region's own target keeps all of its state, others are built
+    // from the address alone.
+    if (target->instAddr() != addr)
+        target->set(addr);
+}
+
+void
+DefaultBTB::encodeTarget(BTBLevel::Entry &entry, const PCStateBase &target,
+                         ThreadID tid)
+{
+    if (!regionBits) {
+        set(entry.target, target);
+        return;
+    }
+
+    const Addr tag = target.instAddr() >> regionBits;
+    const Addr offset = target.instAddr() & mask(regionBits);
+    ++regionUseCount;
+
+    Region *victim = &regions[0];
+    for (auto &region : regions) {
+        if (region.valid && region.tid == tid && region.tag == tag) {
+            // Only share the region if it rebuilds the target exactly.
+            buildTarget(scratchTarget, region, offset);
+            if (scratchTarget->equals(target)) {
+                ++stats.regionHits;
+                region.lastUse = regionUseCount;
+                entry.region = &region - regions.data();
+                entry.regionGen = region.gen;
+                entry.offset = offset;
+                return;
+            }
+        }
+        if (victim->valid &&
+                (!region.valid || region.lastUse < victim->lastUse)) {
+            victim = &region;
+        }
+    }
+
+    ++stats.regionMisses;
+    if (victim->valid)
+        ++stats.regionEvictions;
+    victim->tag = tag;
+    victim->tid = tid;
+    victim->valid = true;
+    ++victim->gen;
+    victim->lastUse = regionUseCount;
+    set(victim->target, target);
+
+    entry.region = victim - regions.data();
+    entry.regionGen = victim->gen;
+    entry.offset = offset;
+}
+
+void
+DefaultBTB::copyTarget(BTBLevel::Entry &to, const BTBLevel::Entry &from) const
+{
+    if (!regionBits) {
+        set(to.target, from.target);
+        return;
+    }
+
+    to.region = from.region;
+    to.regionGen = from.regionGen;
+    to.offset = from.offset;
+}
+
+Addr
+DefaultBTB::probeTarget(Addr inst_pc, ThreadID tid) const
+{
+    for (const auto *level : levels) {
+        const auto *entry = level->probe(inst_pc, tid);
+        if (!entry || !hasTarget(*entry))
+            continue;
+        if (!regionBits)
+            return entry->target->instAddr();
+        return (regions[entry->region].tag << regionBits) | entry->offset;
+    }
+    return MaxAddr;
+}
+
+const PCStateBase *
+DefaultBTB::lookup(Addr inst_pc, ThreadID tid, Cycles *latency)
+{
+    for (size_t i = 0; i < levels.size(); ++i) {
+        BTBLevel::Entry *entry = levels[i]->lookup(inst_pc, tid);
+        if (!entry)
+            continue;
+        if (!hasTarget(*entry)) {
+            levels[i]->staleHit();
+            continue;
+        }
 
-    assert(btb_idx < numEntries);
+        // Bring the branch closer for the next time around.
+        for (size_t j = 0; j < i; ++j) {
+            copyTarget(levels[j]->allocate(inst_pc, entry->type, tid),
+                       *entry);
+            ++stats.fills;
+        }
 
-    if (btb[btb_idx].valid
-        && inst_tag == btb[btb_idx].tag
-        && btb[btb_idx].tid == tid) {
-        return btb[btb_idx].target.get();
-    } else {
-        return nullptr;
+        if (latency)
+            *latency = levels[i]->latency();
+        if (!regionBits) {
+            set(lookupTarget, entry->target);
+        } else {
+            buildTarget(lookupTarget, regions[entry->region], entry->offset);
+            regions[entry->region].lastUse = ++regionUseCount;
+        }
+        return lookupTarget.get();
     }
+    return nullptr;
 }
 
 void
-DefaultBTB::update(Addr inst_pc, const PCStateBase &target, ThreadID tid)
+DefaultBTB::update(Addr inst_pc, const PCStateBase &target, BranchType type,
+                   ThreadID tid)
 {
-    unsigned btb_idx = getIndex(inst_pc, tid);
+    if (branchPCs.insert(inst_pc).second)
+        stats.footprint = branchPCs.size();
 
-    assert(btb_idx < numEntries);
+    // All the levels share the encoding of the target.
+    BTBLevel::Entry &first = levels[0]->allocate(inst_pc, type, tid);
+    encodeTarget(first, target, tid);
 
-    btb[btb_idx].tid = tid;
-    btb[btb_idx].valid = true;
-    set(btb[btb_idx].target, target);
-    btb[btb_idx].tag = getTag(inst_pc);
+    for (size_t i = 1; i < levels.size(); ++i)
+        copyTarget(levels[i]->allocate(inst_pc, type, tid), first);
 }
 
 } // namespace branch_prediction
@@ -29,104 +29,301 @@
 #ifndef __CPU_PRED_BTB_HH__
 #define __CPU_PRED_BTB_HH__
 
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
 #include "arch/generic/pcstate.hh"
-#include "base/logging.hh"
+#include "base/statistics.hh"
 #include "base/types.hh"
-#include "config/the_isa.hh"
+#include "cpu/static_inst.hh"
+#include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
+#include "params/BTBLevel.hh"
+#include "sim/sim_object.hh"
 
 namespace gem5
 {
 
+struct BranchPredictorParams;
+
 namespace branch_prediction
 {
 
-class DefaultBTB
+/** The kinds of branches a BTB entry can record. */
+enum class BranchType
 {
-  private:
-    struct BTBEntry
+    DirectCond,
+    DirectUncond,
+    DirectCall,
+    Indirect,
+    IndirectCall,
+    Return,
+    NumBranchTypes
+};
+
+/** Classifies a control instruction. */
+BranchType getBranchType(const StaticInstPtr &inst);
+
+/** The names of the branch types, e.g. for stats. */
+extern const char *branchTypeNames[];
+
+/**
+ * One level of a BTB hierarchy: a set associative table of branches.
+ * Targets are stored in full, or as an offset into a region of the
+ * region table of the DefaultBTB the level belongs to.
+ */
+class BTBLevel : public SimObject
+{
+  public:
+    struct Entry : public ReplaceableEntry
     {
         /** The entry's tag. */
         Addr tag = 0;
 
-        /** The entry's target. */
-        std::unique_ptr<PCStateBase> target;
-
         /** The entry's thread id. */
-        ThreadID tid;
+        ThreadID tid = InvalidThreadID;
 
         /** Whether or not the entry is valid. */
         bool valid = false;
+
+        /** The kind of branch the entry is for. */
+        BranchType type = BranchType::DirectCond;
+
+        /** Index of the region table entry holding the target's region. */
+        unsigned region = 0;
+
+        /**
+         * Generation of the region table entry the target was encoded
+         * with. If the region has been reallocated since, the target is
+         * lost.
+         */
+        uint64_t regionGen = 0;
+
+        /** The target's offset into its region. */
+        Addr offset = 0;
+
+        /** The full target, if targets are not region compressed. */
+        std::unique_ptr<PCStateBase> target;
     };
 
+    BTBLevel(const BTBLevelParams &p);
+
+    /** Invalidates all the entries. */
+    void reset();
+
+    /**
+     * Finds the entry of a branch without updating any state.
+     * @param inst_pc The address of the branch to look up.
+     * @param tid The thread id.
+     * @return The entry or nullptr if the branch is not in this level.
+     */
+    const Entry *probe(Addr inst_pc, ThreadID tid) const;
+
+    /**
+     * Looks up a branch, counting the access and updating the
+     * replacement state on a hit.
+     * @param inst_pc The address of the branch to look up.
+     * @param tid The thread id.
+     * @return The entry or nullptr if the branch is not in this level.
+     */
+    Entry *lookup(Addr inst_pc, ThreadID tid);
+
+    /**
+     * Returns the entry of a branch, replacing one of its set if the
+     * branch is not in this level yet.
+     * @param inst_pc The address of the branch.
+     * @param type The kind of branch.
+     * @param tid The thread id.
+     * @return The entry, whose target may still be another branch's.
+     */
+    Entry &allocate(Addr inst_pc, BranchType type, ThreadID tid);
+
+    /** Records a hit whose target was lost to a region reallocation. */
+    void staleHit() { ++stats.staleHits; }
+
+    /** Cycles it takes this level to provide a target. */
+    Cycles latency() const { return _latency; }
+
+  private:
+    /** Returns the set a branch maps to. */
+    unsigned getSet(Addr inst_pc, ThreadID tid) const;
+
+    /** Returns the tag bits of a given address. */
+    Addr getTag(Addr inst_pc) const;
+
+    /** The entries, a set after the other. */
+    std::vector<Entry> entries;
+
+    /** Number of ways per set. */
+    const unsigned assoc;
+
+    /** The set index mask. */
+    const unsigned setMask;
+
+    /** The tag mask. */
+    const Addr tagMask;
+
+    /** Number of bits to shift PC when calculating index. */
+    const unsigned instShiftAmt;
+
+    /** Number of bits to shift PC when calculating tag. */
+    const unsigned tagShiftAmt;
+
+    /** Number of bits to shift the thread id by when hashing the index. */
+    const unsigned tidShiftAmt;
+
+    const Cycles _latency;
+
+    replacement_policy::Base *replacementPolicy;
+
+    struct BTBLevelStats : public statistics::Group
+    {
+        BTBLevelStats(statistics::Group *parent);
+
+        statistics::Scalar lookups;
+        statistics::Scalar hits;
+        statistics::Formula hitRatio;
+        statistics::Scalar staleHits;
+        statistics::Scalar inserts;
+        statistics::Scalar evictions;
+        statistics::Vector insertsByType;
+    } stats;
+};
+
+/**
+ * A hierarchy of BTB levels, looked up fastest first. A hit fills the
+ * faster levels, and a branch is written to all the levels on update.
+ *
+ * The targets may be region compressed: the upper bits of a target are
+ * kept once per region in a small fully associative region table,
+ * together with the rest of the PC state of the last target put into
+ * the region, so the entries of the levels only need the lower bits.
+ * Without region bits, the entries hold full targets and there is no
+ * region table.
+ */
+class DefaultBTB
+{
   public:
-    /** Creates a BTB with the given number of entries, number of bits per
-     *  tag, and instruction offset amount.
-     *  @param numEntries Number of entries for the BTB.
-     *  @param tagBits Number of bits for each tag in the BTB.
-     *  @param instShiftAmt Offset amount for instructions to ignore alignment.
+    /** Creates a BTB out of the levels of a branch predictor.
+     *  @param params The branch predictor's params.
+     *  @param parent The stats group to put the BTB's stats in.
      */
-    DefaultBTB(unsigned numEntries, unsigned tagBits,
-               unsigned instShiftAmt, unsigned numThreads);
+    DefaultBTB(const BranchPredictorParams &params,
+               statistics::Group *parent);
 
     void reset();
 
-    /** Looks up an address in the BTB. Must call valid() first on the address.
-     *  @param inst_PC The address of the branch to look up.
+    /** Looks up an address in the BTB.
+     *  @param inst_pc The address of the branch to look up.
      *  @param tid The thread id.
-     *  @return Returns the target of the branch.
+     *  @param latency If not null, set to the latency of the level which
+     *  provided the target.
+     *  @return The target of the branch, or nullptr if the BTB doesn't
+     *  have one. It stays valid until the next lookup.
      */
-    const PCStateBase *lookup(Addr instPC, ThreadID tid);
+    const PCStateBase *lookup(Addr inst_pc, ThreadID tid,
+                              Cycles *latency=nullptr);
 
-    /** Checks if a branch is in the BTB.
-     *  @param inst_PC The address of the branch to look up.
+    /** Checks if a branch is in the BTB, without updating any state.
+     *  @param inst_pc The address of the branch to look up.
      *  @param tid The thread id.
      *  @return Whether or not the branch exists in the BTB.
      */
-    bool valid(Addr instPC, ThreadID tid);
+    bool
+    valid(Addr inst_pc, ThreadID tid) const
+    {
+        return probeTarget(inst_pc, tid) != MaxAddr;
+    }
+
+    /** Finds the target address of a branch without updating any state.
+     *  @param inst_pc The address of the branch to look up.
+     *  @param tid The thread id.
+     *  @return The target address, or MaxAddr if the BTB doesn't have one.
+     */
+    Addr probeTarget(Addr inst_pc, ThreadID tid) const;
 
     /** Updates the BTB with the target of a branch.
      *  @param inst_pc The address of the branch being updated.
-     *  @param target_pc The target address of the branch.
+     *  @param target The target of the branch.
+     *  @param type The kind of branch.
      *  @param tid The thread id.
      */
-    void update(Addr inst_pc, const PCStateBase &target_pc, ThreadID tid);
+    void update(Addr inst_pc, const PCStateBase &target, BranchType type,
+                ThreadID tid);
 
   private:
-    /** Returns the index into the BTB, based on the branch's PC.
-     *  @param inst_PC The branch to look up.
-     *  @return Returns the index into the BTB.
-     */
-    inline unsigned getIndex(Addr instPC, ThreadID tid);
+    struct Region
+    {
+        /** The upper bits of the targets in the region. */
+        Addr tag = 0;
 
-    /** Returns the tag bits of a given address.
-     *  @param inst_PC The branch's address.
-     *  @return Returns the tag bits.
-     */
-    inline Addr getTag(Addr instPC);
+        ThreadID tid = InvalidThreadID;
 
-    /** The actual BTB. */
-    std::vector<BTBEntry> btb;
+        bool valid = false;
 
-    /** The number of entries in the BTB. */
-    unsigned numEntries;
+        /** Bumped whenever the entry is reallocated. */
+        uint64_t gen = 0;
 
-    /** The index mask. */
-    unsigned idxMask;
+        /** Last use, for LRU replacement. */
+        uint64_t lastUse = 0;
+
+        /** The PC state targets in the region are built from. */
+        std::unique_ptr<PCStateBase> target;
+    };
 
-    /** The number of tag bits per entry. */
-    unsigned tagBits;
+    /** Whether an entry's target is still in the region table. */
+    bool
+    hasTarget(const BTBLevel::Entry &entry) const
+    {
+        if (!regionBits)
+            return entry.target != nullptr;
+        const Region &region = regions[entry.region];
+        return region.valid && region.gen == entry.regionGen;
+    }
 
-    /** The tag mask. */
-    unsigned tagMask;
+    /** Builds a target from a region and an offset into it. */
+    void buildTarget(std::unique_ptr<PCStateBase> &target,
+                     const Region &region, Addr offset) const;
 
-    /** Number of bits to shift PC when calculating index. */
-    unsigned instShiftAmt;
+    /** Encodes a target into an entry, allocating a region if needed. */
+    void encodeTarget(BTBLevel::Entry &entry, const PCStateBase &target,
+                      ThreadID tid);
 
-    /** Number of bits to shift PC when calculating tag. */
-    unsigned tagShiftAmt;
+    /** Gives an entry the target of another one. */
+    void copyTarget(BTBLevel::Entry &to, const BTBLevel::Entry &from) const;
+
+    /** The levels, fastest first. */
+    std::vector<BTBLevel *> levels;
+
+    /** The region table. */
+    std::vector<Region> regions;
+
+    /** Number of target bits kept in the entries, 0 for full targets. */
+    const unsigned regionBits;
+
+    /** Counter the region table's LRU stamps are taken from. */
+    uint64_t regionUseCount = 0;
+
+    /** The target returned by the last lookup. */
+    std::unique_ptr<PCStateBase> lookupTarget;
+
+    /** Scratch space to check if a region can encode a target. */
+    std::unique_ptr<PCStateBase> scratchTarget;
+
+    /** Addresses of all the branches put into the BTB so far. */
+    std::unordered_set<Addr> branchPCs;
+
+    struct BTBStats : public statistics::Group
+    {
+        BTBStats(statistics::Group *parent);
 
-    /** Log2 NumThreads used for hashing threadid */
-    unsigned log2NumThreads;
+        statistics::Scalar footprint;
+        statistics::Scalar fills;
+        statistics::Scalar regionHits;
+        statistics::Scalar regionMisses;
+        statistics::Scalar regionEvictions;
+    } stats;
 };
 
 } // namespace branch_prediction
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2004-2005 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "arch/generic/pcstate.hh"
+#include "cpu/pred/btb.hh"
+#include "mem/cache/replacement_policies/lru_rp.hh"
+#include "params/BranchPredictor.hh"
+#include "params/LRURP.hh"
+#include "sim/eventq.hh"
+#include "sim/root.hh"
+
+using namespace gem5;
+using namespace gem5::branch_prediction;
+
+// The stats code looks up the simulation root when resolving stat names,
+// which these tests never do, so there is no root object.
+Root *Root::_root = nullptr;
+
+namespace
+{
+
+typedef GenericISA::SimplePCState<4> TestPCState;
+
+/** Builds BTB levels and the BTB made out of them. */
+class BTBTest : public testing::Test
+{
+  protected:
+    // The replacement policies stamp entries with the current tick.
+    BTBTest() { curEventQueue(getEventQueue(0)); }
+
+    void
+    advanceTick()
+    {
+        curEventQueue()->setCurTick(curTick() + 1);
+    }
+
+    replacement_policy::LRU *
+    makeRP()
+    {
+        LRURPParams p;
+        p.name = "lru" + std::to_string(objects.size());
+        p.eventq_index = 0;
+        objects.emplace_back(new replacement_policy::LRU(p));
+        return static_cast<replacement_policy::LRU *>(objects.back().get());
+    }
+
+    BTBLevel *
+    makeLevel(unsigned num_entries, unsigned assoc)
+    {
+        BTBLevelParams p;
+        p.name = "level" + std::to_string(objects.size());
+        p.eventq_index = 0;
+        p.numEntries = num_entries;
+        p.assoc = assoc;
+        p.tagBits = 16;
+        p.latency = Cycles(0);
+        p.replacement_policy = makeRP();
+        p.numThreads = 2;
+        p.instShiftAmt = 2;
+        objects.emplace_back(new BTBLevel(p));
+        return static_cast<BTBLevel *>(objects.back().get());
+    }
+
+    DefaultBTB &
+    makeBTB(std::vector<BTBLevel *> levels, unsigned region_entries,
+            unsigned region_bits)
+    {
+        BranchPredictorParams p;
+        p.BTBLevels = levels;
+        p.BTBRegionEntries = region_entries;
+        p.BTBRegionBits = region_bits;
+        btb.reset(new DefaultBTB(p, &statsRoot));
+        return *btb;
+    }
+
+    statistics::Group statsRoot{nullptr};
+    std::vector<std::unique_ptr<SimObject>> objects;
+    std::unique_ptr<DefaultBTB> btb;
+};
+
+} // anonymous namespace
+
+/** Branches map to sets by PC and thread, and are replaced LRU in a set */
+TEST_F(BTBTest, SetMapping)
+{
+    // 4 sets of 2 ways, indexed by PC bits [3:2] and the thread id.
+    BTBLevel *level = makeLevel(8, 2);
+    const Addr a = 0x1000, b = a + 4 * 4, c = a + 8 * 4;
+
+    level->allocate(a, BranchType::DirectCond, 0);
+    advanceTick();
+    level->allocate(b, BranchType::DirectCond, 0);
+    // Another set, so nothing gets replaced.
+    level->allocate(a + 4, BranchType::DirectCond, 0);
+    EXPECT_NE(level->probe(a, 0), nullptr);
+    EXPECT_NE(level->probe(b, 0), nullptr);
+    EXPECT_NE(level->probe(a + 4, 0), nullptr);
+
+    // Threads have their own entries for the same PC.
+    EXPECT_EQ(level->probe(a, 1), nullptr);
+    level->allocate(a, BranchType::DirectCond, 1);
+    EXPECT_NE(level->probe(a, 0), nullptr);
+    EXPECT_NE(level->probe(a, 1), nullptr);
+
+    // A third branch in the set of a and b replaces the least recently
+    // used one.
+    advanceTick();
+    EXPECT_NE(level->lookup(a, 0), nullptr);
+    advanceTick();
+    level->allocate(c, BranchType::DirectCond, 0);
+    EXPECT_NE(level->probe(a, 0), nullptr);
+    EXPECT_EQ(level->probe(b, 0), nullptr);
+    EXPECT_NE(level->probe(c, 0), nullptr);
+}
+
+/** Without region bits, targets are kept in full in the entries */
+TEST_F(BTBTest, FullTargets)
+{
+    BTBLevel *l1 = makeLevel(4, 1);
+    BTBLevel *l2 = makeLevel(64, 4);
+    DefaultBTB &btb = makeBTB({l1, l2}, 0, 0);
+
+    const TestPCState far(0x7fff00001230ULL), near(0x2000);
+    btb.update(0x1000, far, BranchType::DirectUncond, 0);
+    btb.update(0x1004, near, BranchType::DirectUncond, 0);
+    EXPECT_EQ(btb.probeTarget(0x1000, 0), far.instAddr());
+    EXPECT_EQ(btb.probeTarget(0x1004, 0), near.instAddr());
+
+    const PCStateBase *target = btb.lookup(0x1000, 0);
+    ASSERT_NE(target, nullptr);
+    EXPECT_TRUE(target->equals(far));
+
+    // 0x1010 takes the place of 0x1000 in the direct mapped first level,
+    // but the second level still has it and fills it back in.
+    btb.update(0x1010, near, BranchType::DirectUncond, 0);
+    EXPECT_EQ(l1->probe(0x1000, 0), nullptr);
+    target = btb.lookup(0x1000, 0);
+    ASSERT_NE(target, nullptr);
+    EXPECT_TRUE(target->equals(far));
+    EXPECT_NE(l1->probe(0x1000, 0), nullptr);
+
+    EXPECT_FALSE(btb.valid(0x2000, 0));
+    EXPECT_EQ(btb.lookup(0x2000, 0), nullptr);
+}
+
+/** Targets sharing a region are rebuilt from it exactly */
+TEST_F(BTBTest, RegionEncoding)
+{
+    DefaultBTB &btb = makeBTB({makeLevel(64, 4)}, 4, 12);
+
+    // Both targets are in the 4KiB region at 0x45000.
+    TestPCState first(0x45100), second(0x45ffc);
+    btb.update(0x1000, first, BranchType::DirectUncond, 0);
+    btb.update(0x1004, second, BranchType::DirectUncond, 0);
+
+    const PCStateBase *target = btb.lookup(0x1000, 0);
+    ASSERT_NE(target, nullptr);
+    EXPECT_TRUE(target->equals(first));
+    target = btb.lookup(0x1004, 0);
+    ASSERT_NE(target, nullptr);
+    EXPECT_TRUE(target->equals(second));
+
+    // A target whose PC state can't be rebuilt from the region's, here
+    // because of its next PC, gets a region of its own.
+    TestPCState odd(0x45200);
+    odd.npc(0x45300);
+    btb.update(0x1008, odd, BranchType::DirectUncond, 0);
+    target = btb.lookup(0x1008, 0);
+    ASSERT_NE(target, nullptr);
+    EXPECT_TRUE(target->equals(odd));
+    target = btb.lookup(0x1000, 0);
+    ASSERT_NE(target, nullptr);
+    EXPECT_TRUE(target->equals(first));
+}
+
+/** Entries lose their target when its region is reallocated */
+TEST_F(BTBTest, RegionInvalidation)
+{
+    BTBLevel *level = makeLevel(64, 4);
+    DefaultBTB &btb = makeBTB({level}, 2, 12);
+
+    btb.update(0x1000, TestPCState(0x10000), BranchType::DirectUncond, 0);
+    btb.update(0x1004, TestPCState(0x20000), BranchType::DirectUncond, 0);
+    // Use the first region, so the second one is replaced next.
+    EXPECT_NE(btb.lookup(0x1000, 0), nullptr);
+    btb.update(0x1008, TestPCState(0x30000), BranchType::DirectUncond, 0);
+
+    // The branch is still in the level, but its target is gone.
+    EXPECT_NE(level->probe(0x1004, 0), nullptr);
+    EXPECT_FALSE(btb.valid(0x1004, 0));
+    EXPECT_EQ(btb.lookup(0x1004, 0), nullptr);
+
+    EXPECT_EQ(btb.probeTarget(0x1000, 0), 0x10000);
+    EXPECT_EQ(btb.probeTarget(0x1008, 0), 0x30000);
+
+    // Updating the branch again gives it a valid target.
+    btb.update(0x1004, TestPCState(0x20000), BranchType::DirectUncond, 0);
+    EXPECT_EQ(btb.probeTarget(0x1004, 0), 0x20000);
+}
@@ -34,6 +34,8 @@
 #ifndef __CPU_PRED_LOOP_PREDICTOR_HH__
 #define __CPU_PRED_LOOP_PREDICTOR_HH__
 
+#include "base/random.hh"
+#include "base/recycling_pool.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "sim/sim_object.hh"
@@ -96,6 +98,12 @@ class LoopPredictor : public SimObject
         statistics::Scalar wrong;
     } stats;
 
+    /** Pool the per-branch history objects are recycled through. */
+    RecyclingPool historyPool;
+
+    /** Private generator, so predictors don't depend on each other */
+    mutable Random rng;
+
     /**
      * Updates an unsigned counter based on up/down parameter
      * @param ctr Reference to counter to update.
@@ -126,7 +134,7 @@ class LoopPredictor : public SimObject
     }
   public:
     // Primary branch history entry
-    struct BranchInfo
+    struct BranchInfo : public Recyclable
     {
         uint16_t loopTag;
         uint16_t currentIter;
@@ -501,7 +501,7 @@ MultiperspectivePerceptron::train(ThreadID tid, MPPBranchInfo &bi, bool taken)
             do {
                 // udpate a random weight
                 int besti = -1;
-                int nrand = random_mt.random<int>() % specs.size();
+                int nrand = rng.random<int>() % specs.size();
                 int pout;
                 found = false;
                 for (int j = 0; j < specs.size(); j += 1) {
@@ -551,7 +551,8 @@ void
 MultiperspectivePerceptron::uncondBranch(ThreadID tid, Addr pc,
                                          void * &bp_history)
 {
-    MPPBranchInfo *bi = new MPPBranchInfo(pc, pcshift, false);
+    MPPBranchInfo *bi =
+        new (historyPool) MPPBranchInfo(pc, pcshift, false);
     std::vector<unsigned int> &ghist_words = threadData[tid]->ghist_words;
 
     bp_history = (void *)bi;
@@ -574,7 +575,8 @@ bool
 MultiperspectivePerceptron::lookup(ThreadID tid, Addr instPC,
                                    void * &bp_history)
 {
-    MPPBranchInfo *bi = new MPPBranchInfo(instPC, pcshift, true);
+    MPPBranchInfo *bi =
+        new (historyPool) MPPBranchInfo(instPC, pcshift, true);
     bp_history = (void *)bi;
 
     bool use_static = false;
@@ -663,7 +665,7 @@ MultiperspectivePerceptron::update(ThreadID tid, Addr instPC, bool taken,
         // filter, blow a random filter entry away
         if (decay && transition &&
             ((threadData[tid]->occupancy > decay) || (decay == 1))) {
-            int rnd = random_mt.random<int>() %
+            int rnd = rng.random<int>() %
                       threadData[tid]->filterTable.size();
             FilterEntry &frand = threadData[tid]->filterTable[rnd];
             if (frand.seenTaken && frand.seenUntaken) {
@@ -42,6 +42,7 @@
 #include <array>
 #include <vector>
 
+#include "base/random.hh"
 #include "cpu/pred/bpred_unit.hh"
 #include "params/MultiperspectivePerceptron.hh"
 
@@ -57,7 +58,7 @@ class MultiperspectivePerceptron : public BPredUnit
     /**
      * Branch information data
      */
-    class MPPBranchInfo
+    class MPPBranchInfo : public Recyclable
     {
         /** pc of the branch */
         const unsigned int pc;
@@ -362,6 +363,9 @@ class MultiperspectivePerceptron : public BPredUnit
     std::vector<HistorySpec *> specs;
     std::vector<int> table_sizes;
 
+    /** Private generator, so predictors don't depend on each other */
+    Random rng;
+
     /** runtime values and data used to count the size in bits */
     bool doing_local;
     bool doing_recency;
@@ -28,6 +28,8 @@
 
 #include "cpu/pred/simple_indirect.hh"
 
+#include <cstdint>
+
 #include "base/intmath.hh"
 #include "debug/Indirect.hh"
 
@@ -70,8 +72,10 @@ SimpleIndirectPredictor::genIndirectInfo(ThreadID tid,
 {
     // record the GHR as it was before this prediction
     // It will be used to recover the history in case this prediction is
-    // wrong or belongs to bad path
-    indirect_history = new unsigned(threadInfo[tid].ghr);
+    // wrong or belongs to bad path. It fits in the pointer itself, so
+    // there is nothing to allocate.
+    indirect_history = reinterpret_cast<void *>(
+            static_cast<uintptr_t>(threadInfo[tid].ghr));
 }
 
 void
@@ -87,8 +91,8 @@ void
 SimpleIndirectPredictor::changeDirectionPrediction(ThreadID tid,
     void * indirect_history, bool actually_taken)
 {
-    unsigned * previousGhr = static_cast<unsigned *>(indirect_history);
-    threadInfo[tid].ghr = ((*previousGhr) << 1) + actually_taken;
+    unsigned previous_ghr = reinterpret_cast<uintptr_t>(indirect_history);
+    threadInfo[tid].ghr = (previous_ghr << 1) + actually_taken;
     threadInfo[tid].ghr &= ghrMask;
 }
 
@@ -132,10 +136,6 @@ SimpleIndirectPredictor::commit(InstSeqNum seq_num, ThreadID tid,
     DPRINTF(Indirect, "Committing seq:%d\n", seq_num);
     ThreadInfo &t_info = threadInfo[tid];
 
-    // we do not need to recover the GHR, so delete the information
-    unsigned * previousGhr = static_cast<unsigned *>(indirect_history);
-    delete previousGhr;
-
     if (t_info.pathHist.empty()) return;
 
     if (t_info.headHistEntry < t_info.pathHist.size() &&
@@ -171,10 +171,7 @@ void
 SimpleIndirectPredictor::deleteIndirectInfo(ThreadID tid,
                                             void * indirect_history)
 {
-    unsigned * previousGhr = static_cast<unsigned *>(indirect_history);
-    threadInfo[tid].ghr = *previousGhr;
-
-    delete previousGhr;
+    threadInfo[tid].ghr = reinterpret_cast<uintptr_t>(indirect_history);
 }
 
 void
@@ -184,13 +181,13 @@ SimpleIndirectPredictor::recordTarget(
 {
     ThreadInfo &t_info = threadInfo[tid];
 
-    unsigned * ghr = static_cast<unsigned *>(indirect_history);
+    unsigned ghr = reinterpret_cast<uintptr_t>(indirect_history);
 
     // Should have just squashed so this branch should be the oldest
     auto hist_entry = *(t_info.pathHist.rbegin());
     // Temporarily pop it off the history so we can calculate the set
     t_info.pathHist.pop_back();
-    Addr set_index = getSetIndex(hist_entry.pcAddr, *ghr, tid);
+    Addr set_index = getSetIndex(hist_entry.pcAddr, ghr, tid);
     Addr tag = getTag(hist_entry.pcAddr);
     hist_entry.targetAddr = target.instAddr();
     t_info.pathHist.push_back(hist_entry);
@@ -72,7 +72,8 @@ StatisticalCorrector::StatisticalCorrector(
     scCountersWidth(p.scCountersWidth),
     firstH(0),
     secondH(0),
-    stats(this)
+    stats(this),
+    historyPool(this, "historyPool", "branch history objects")
 {
     wb.resize(1 << logSizeUps, 4);
 
@@ -92,7 +93,7 @@ StatisticalCorrector::StatisticalCorrector(
 StatisticalCorrector::BranchInfo*
 StatisticalCorrector::makeBranchInfo()
 {
-    return new BranchInfo();
+    return new (historyPool) BranchInfo();
 }
 
 StatisticalCorrector::SCThreadHistory*
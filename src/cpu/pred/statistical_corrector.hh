@@ -42,6 +42,7 @@
 #ifndef __CPU_PRED_STATISTICAL_CORRECTOR_HH__
 #define __CPU_PRED_STATISTICAL_CORRECTOR_HH__
 
+#include "base/recycling_pool.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "cpu/static_inst.hh"
@@ -196,8 +197,11 @@ class StatisticalCorrector : public SimObject
         statistics::Scalar wrong;
     } stats;
 
+    /** Pool the per-branch history objects are recycled through. */
+    RecyclingPool historyPool;
+
   public:
-    struct BranchInfo
+    struct BranchInfo : public Recyclable
     {
         BranchInfo() : lowConf(false), highConf(false), altConf(false),
               medConf(false), scPred(false), lsum(0), thres(0),
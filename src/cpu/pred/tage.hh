@@ -50,6 +50,7 @@
 
 #include <vector>
 
+#include "base/random.hh"
 #include "base/types.hh"
 #include "cpu/pred/bpred_unit.hh"
 #include "cpu/pred/tage_base.hh"
@@ -66,7 +67,10 @@ class TAGE: public BPredUnit
   protected:
     TAGEBase *tage;
 
-    struct TageBranchInfo
+    /** Private generator, so predictors don't depend on each other */
+    Random rng;
+
+    struct TageBranchInfo : public Recyclable
     {
         TAGEBase::BranchInfo *tageBranchInfo;
 
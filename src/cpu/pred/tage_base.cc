@@ -70,7 +70,8 @@ TAGEBase::TAGEBase(const TAGEBaseParams &p)
      speculativeHistUpdate(p.speculativeHistUpdate),
      instShiftAmt(p.instShiftAmt),
      initialized(false),
-     stats(this, nHistoryTables)
+     stats(this, nHistoryTables),
+     historyPool(this, "historyPool", "branch history objects")
 {
     if (noSkip.empty()) {
         // Set all the table to enabled by default
@@ -80,7 +81,7 @@ TAGEBase::TAGEBase(const TAGEBaseParams &p)
 
 TAGEBase::BranchInfo*
 TAGEBase::makeBranchInfo() {
-    return new BranchInfo(*this);
+    return new (historyPool) BranchInfo(*this);
 }
 
 void
@@ -50,6 +50,8 @@
 
 #include <vector>
 
+#include "base/random.hh"
+#include "base/recycling_pool.hh"
 #include "base/statistics.hh"
 #include "cpu/null_static_inst.hh"
 #include "cpu/static_inst.hh"
@@ -125,7 +127,7 @@ class TAGEBase : public SimObject
     };
 
     // Primary branch history entry
-    struct BranchInfo
+    struct BranchInfo : public Recyclable
     {
         int pathHist;
         int ptGhist;
@@ -142,9 +144,9 @@ class TAGEBase : public SimObject
         bool pseudoNewAlloc;
         Addr branchPC;
 
-        // Pointer to dynamically allocated storage
+        // Pointer to storage recycled through the TAGE history pool
         // to save table indices and folded histories.
-        // To do one call to new instead of five.
+        // To do one allocation instead of five.
         int *storage;
 
         // Pointers to actual saved array within the dynamically
@@ -169,7 +171,8 @@ class TAGEBase : public SimObject
               provider(-1)
         {
             int sz = tage.nHistoryTables + 1;
-            storage = new int [sz * 5];
+            storage = static_cast<int *>(RecyclingPool::allocate(
+                sz * 5 * sizeof(int), &tage.historyPool));
             tableIndices = storage;
             tableTags = storage + sz;
             ci = tableTags + sz;
@@ -179,7 +182,7 @@ class TAGEBase : public SimObject
 
         virtual ~BranchInfo()
         {
-            delete[] storage;
+            RecyclingPool::release(storage);
         }
     };
 
@@ -463,6 +466,9 @@ class TAGEBase : public SimObject
 
     std::vector<ThreadHistory> threadHistory;
 
+    /** Private generator, so predictors don't depend on each other */
+    Random rng;
+
     /**
      * Initialization of the folded histories
      */
@@ -509,6 +515,13 @@ class TAGEBase : public SimObject
         statistics::Vector longestMatchProvider;
         statistics::Vector altMatchProvider;
     } stats;
+
+    /**
+     * Pool the per-branch history objects and their table index storage
+     * are recycled through. Its size classes are fixed by nHistoryTables
+     * at construction, so a warmed up pool never goes to the heap.
+     */
+    mutable RecyclingPool historyPool;
 };
 
 } // namespace branch_prediction
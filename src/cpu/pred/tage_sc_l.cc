@@ -61,7 +61,7 @@ TAGE_SC_L_LoopPredictor::calcConf(int index) const
 bool
 TAGE_SC_L_LoopPredictor::optionalAgeInc() const
 {
-    return (random_mt.random<int>() & 7) == 0;
+    return (rng.random<int>() & 7) == 0;
 }
 
 TAGE_SC_L::TAGE_SC_L(const TAGE_SC_LParams &p)
@@ -72,7 +72,7 @@ TAGE_SC_L::TAGE_SC_L(const TAGE_SC_LParams &p)
 TAGEBase::BranchInfo*
 TAGE_SC_L_TAGE::makeBranchInfo()
 {
-    return new BranchInfo(*this);
+    return new (historyPool) BranchInfo(*this);
 }
 void
 TAGE_SC_L_TAGE::calculateParameters()
@@ -296,7 +296,7 @@ void
 TAGE_SC_L_TAGE::adjustAlloc(bool & alloc, bool taken, bool pred_taken)
 {
     // Do not allocate too often if the prediction is ok
-    if ((taken == pred_taken) && ((random_mt.random<int>() & 31) != 0)) {
+    if ((taken == pred_taken) && ((rng.random<int>() & 31) != 0)) {
         alloc = false;
     }
 }
@@ -305,11 +305,11 @@ int
 TAGE_SC_L_TAGE::calcDep(TAGEBase::BranchInfo* bi)
 {
     int a = 1;
-    if ((random_mt.random<int>() & 127) < 32) {
+    if ((rng.random<int>() & 127) < 32) {
         a = 2;
     }
     return ((((bi->hitBank - 1 + 2 * a) & 0xffe)) ^
-            (random_mt.random<int>() & 1));
+            (rng.random<int>() & 1));
 }
 
 void
@@ -364,9 +364,9 @@ TAGE_SC_L_TAGE::extraAltCalc(TAGEBase::BranchInfo* bi)
 bool
 TAGE_SC_L::predict(ThreadID tid, Addr branch_pc, bool cond_branch, void* &b)
 {
-    TageSCLBranchInfo *bi = new TageSCLBranchInfo(*tage,
-                                                  *statisticalCorrector,
-                                                  *loopPredictor);
+    TageSCLBranchInfo *bi =
+        new (historyPool) TageSCLBranchInfo(*tage, *statisticalCorrector,
+                                            *loopPredictor);
     b = (void*)(bi);
 
     bool pred_taken = tage->tagePredict(tid, branch_pc, cond_branch,
@@ -431,7 +431,7 @@ TAGE_SC_L::update(ThreadID tid, Addr branch_pc, bool taken, void *bp_history,
         return;
     }
 
-    int nrand = random_mt.random<int>() & 3;
+    int nrand = rng.random<int>() & 3;
     if (tage_bi->condBranch) {
         DPRINTF(TageSCL, "Updating tables for branch:%lx; taken?:%d\n",
                 branch_pc, taken);
@@ -201,7 +201,7 @@ TournamentBP::lookup(ThreadID tid, Addr branch_addr, void * &bp_history)
       choiceCtrs[globalHistory[tid] & choiceHistoryMask];
 
     // Create BPHistory and pass it back to be recorded.
-    BPHistory *history = new BPHistory;
+    BPHistory *history = new (historyPool) BPHistory;
     history->globalHistory = globalHistory[tid];
     history->localPredTaken = local_prediction;
     history->globalPredTaken = global_prediction;
@@ -241,7 +241,7 @@ void
 TournamentBP::uncondBranch(ThreadID tid, Addr pc, void * &bp_history)
 {
     // Create BPHistory and pass it back to be recorded.
-    BPHistory *history = new BPHistory;
+    BPHistory *history = new (historyPool) BPHistory;
     history->globalHistory = globalHistory[tid];
     history->localPredTaken = true;
     history->globalPredTaken = true;
@@ -157,7 +157,7 @@ class TournamentBP : public BPredUnit
      * when the BP can use this information to update/restore its
      * state properly.
      */
-    struct BPHistory
+    struct BPHistory : public Recyclable
     {
 #ifdef DEBUG
         BPHistory()
@@ -60,6 +60,16 @@ class BaseAtomicSimpleCPU(BaseSimpleCPU):
     width = Param.Int(1, "CPU width")
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
+    bb_cache_entries = Param.Unsigned(0, "Number of entries in the cache "
+        "of decoded basic blocks (0 to disable). Only the first instruction "
+        "of a replayed block is translated and fetched, the others do not "
+        "access the ITB or the icache. Enabling it therefore lowers the ITB "
+        "and icache access counts, and the icache stall time charged with "
+        "simulate_inst_stalls, so those stats differ from a run with the "
+        "cache disabled")
+    bb_max_insts = Param.Unsigned(64, "Maximum number of instructions in a "
+        "cached basic block, also bounding how many instructions replayed "
+        "from the cache run in one cycle")
 
     def addSimPointProbe(self, interval):
         simpoint = SimPoint()
@@ -51,6 +51,12 @@ class BaseNonCachingSimpleCPU(BaseAtomicSimpleCPU):
 
     numThreads = 1
 
+    soft_tlb_entries = Param.Unsigned(0, "Number of entries in each of "
+        "the direct mapped soft TLBs mapping virtual pages to host memory "
+        "for reads, writes and fetches (0 to disable). Accesses hitting in "
+        "them skip the memory system, so other CPUs won't observe them "
+        "through snoops or exclusive monitors.")
+
     @classmethod
     def memory_mode(cls):
         return 'atomic_noncaching'
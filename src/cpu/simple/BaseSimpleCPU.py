@@ -38,3 +38,7 @@ class BaseSimpleCPU(BaseCPU):
     cxx_class = 'gem5::BaseSimpleCPU'
 
     branchPred = Param.BranchPredictor(NULL, "Branch Predictor")
+    batch_stats = Param.Bool(False, "Collect the per instruction stats in "
+        "plain counters, only adding them to the stats when they are "
+        "dumped or the CPU is drained. Counts pending when the stats are "
+        "reset are dropped, as the reset would have cleared them")
@@ -42,6 +42,7 @@
 #include "cpu/simple/atomic.hh"
 
 #include "arch/generic/decoder.hh"
+#include "base/intmath.hh"
 #include "base/output.hh"
 #include "config/the_isa.hh"
 #include "cpu/exetrace.hh"
@@ -79,6 +80,7 @@ AtomicSimpleCPU::AtomicSimpleCPU(const BaseAtomicSimpleCPUParams &p)
       width(p.width), locked(false),
       simulate_data_stalls(p.simulate_data_stalls),
       simulate_inst_stalls(p.simulate_inst_stalls),
+      bbCache(p.bb_cache_entries), bbMaxInsts(p.bb_max_insts),
       icachePort(name() + ".icache_port", this),
       dcachePort(name() + ".dcache_port", this),
       dcache_access(false), dcache_latency(0),
@@ -89,6 +91,13 @@ AtomicSimpleCPU::AtomicSimpleCPU(const BaseAtomicSimpleCPUParams &p)
     data_read_req = std::make_shared<Request>();
     data_write_req = std::make_shared<Request>();
     data_amo_req = std::make_shared<Request>();
+
+    fatal_if(!bbCache.empty() && !isPowerOf2(bbCache.size()),
+             "Number of basic block cache entries must be a power of 2.");
+    fatal_if(!bbCache.empty() && numThreads > 1,
+             "The basic block cache only supports one thread.");
+    fatal_if(!bbCache.empty() && !bbMaxInsts,
+             "Cached basic blocks must hold at least one instruction.");
 }
 
 
@@ -105,6 +114,9 @@ AtomicSimpleCPU::drain()
     // Deschedule any power gating event (if any)
     deschedulePowerGatingEvent();
 
+    // Anyone looking at the stats after draining expects them up to date.
+    flushStats();
+
     if (switchedOut())
         return DrainState::Drained;
 
@@ -149,6 +161,10 @@ AtomicSimpleCPU::drainResume()
     DPRINTF(SimpleCPU, "Resume\n");
     verifyMemoryMode();
 
+    // Memory may have been written behind our back while drained, e.g.
+    // by a checkpoint restore or another CPU model.
+    bbFlush();
+
     assert(!threadContexts.empty());
 
     _status = BaseSimpleCPU::Idle;
@@ -183,6 +199,7 @@ AtomicSimpleCPU::tryCompleteDrain()
         return false;
 
     DPRINTF(Drain, "CPU done draining, processing drain event\n");
+    flushStats();
     signalDrainDone();
 
     return true;
@@ -301,6 +318,7 @@ AtomicSimpleCPU::AtomicCPUDPort::recvAtomicSnoop(PacketPtr pkt)
             t_info->thread->getIsaPtr()->handleLockedSnoop(pkt,
                     cacheBlockMask);
         }
+        cpu->bbCheckWrite(pkt->getAddr(), pkt->getSize());
     }
 
     return 0;
@@ -329,6 +347,9 @@ AtomicSimpleCPU::AtomicCPUDPort::recvFunctionalSnoop(PacketPtr pkt)
                     cacheBlockMask);
         }
     }
+
+    if (pkt->isWrite())
+        cpu->bbCheckWrite(pkt->getAddr(), pkt->getSize());
 }
 
 bool
@@ -507,6 +528,7 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
 
                     // Notify other threads on this CPU of write
                     threadSnoop(&pkt, curThread);
+                    bbCheckWrite(req->getPaddr(), req->getSize());
                 }
                 dcache_access = true;
                 panic_if(pkt.isError(), "Data write (%s) failed: %s",
@@ -594,6 +616,7 @@ AtomicSimpleCPU::amoMem(Addr addr, uint8_t* data, unsigned size,
             dcache_latency += req->localAccessor(thread->getTC(), &pkt);
         } else {
             dcache_latency += sendPacket(dcachePort, &pkt);
+            bbCheckWrite(req->getPaddr(), req->getSize());
         }
 
         dcache_access = true;
@@ -634,7 +657,11 @@ AtomicSimpleCPU::tick()
 
     Tick latency = 0;
 
-    for (int i = 0; i < width || locked; ++i) {
+    // While replaying a cached basic block, keep going past the width
+    // of the CPU to run the whole block in one go.
+    int i = 0;
+    for (; i < width || locked ||
+            (bbReplay && i < static_cast<int>(bbMaxInsts)); ++i) {
         baseStats.numCycles++;
         updateCycleCounters(BaseCPU::CPU_STATE_ON);
 
@@ -656,11 +683,17 @@ AtomicSimpleCPU::tick()
         const PCStateBase &pc = thread->pcState();
 
         bool needToFetch = !isRomMicroPC(pc.microPC()) && !curMacroStaticInst;
+        bbInst = nullptr;
         if (needToFetch) {
             ifetch_req->taskId(taskId());
             setupFetchRequest(ifetch_req);
-            fault = thread->mmu->translateAtomic(ifetch_req, thread->getTC(),
-                                                 BaseMMU::Execute);
+            if (!bbCache.empty())
+                bbInst = bbNextInst();
+            if (!bbInst) {
+                fault = translateInstFetch();
+                if (fault == NoFault && !bbCache.empty())
+                    bbInst = bbFetched();
+            }
         }
 
         if (fault == NoFault) {
@@ -668,7 +701,7 @@ AtomicSimpleCPU::tick()
             bool icache_access = false;
             dcache_access = false; // assume no dcache access
 
-            if (needToFetch) {
+            if (needToFetch && !bbInst) {
                 // This is commented out because the decoder would act like
                 // a tiny cache otherwise. It wouldn't be flushed when needed
                 // like the I cache. It should be flushed, and when that works
@@ -682,6 +715,7 @@ AtomicSimpleCPU::tick()
             }
 
             preExecute();
+            bbInst = nullptr;
 
             Tick stall_ticks = 0;
             if (curStaticInst) {
@@ -727,6 +761,13 @@ AtomicSimpleCPU::tick()
             }
 
         }
+
+        // A recorded block ends with a control instruction or a fault.
+        if (bbRecord && (fault != NoFault ||
+                    (curStaticInst && curStaticInst->isControl()))) {
+            bbRecordEnd = true;
+        }
+
         if (fault != NoFault || !t_info.stayAtPC)
             advancePC(fault);
     }
@@ -734,14 +775,146 @@ AtomicSimpleCPU::tick()
     if (tryCompleteDrain())
         return;
 
-    // instruction takes at least one cycle
-    if (latency < clockPeriod())
-        latency = clockPeriod();
+    // instruction takes at least one cycle, and every width instructions
+    // replayed past the first take one more
+    Tick min_latency = clockPeriod();
+    if (i > width && !locked)
+        min_latency *= divCeil(i, width);
+    if (latency < min_latency)
+        latency = min_latency;
 
     if (_status != Idle)
         reschedule(tickEvent, curTick() + latency, true);
 }
 
+const AtomicSimpleCPU::BBInst *
+AtomicSimpleCPU::bbNextInst()
+{
+    if (!bbReplay)
+        return nullptr;
+
+    SimpleThread *thread = threadInfo[curThread]->thread;
+    if (bbReplayIdx < bbReplay->insts.size() &&
+            bbReplay->decoderEpoch == thread->decoder->contextEpoch()) {
+        const BBInst &bb_inst = bbReplay->insts[bbReplayIdx];
+        if (bb_inst.pcBefore->equals(thread->pcState())) {
+            bbReplayIdx++;
+            return &bb_inst;
+        }
+    }
+
+    bbStopReplay();
+    return nullptr;
+}
+
+const AtomicSimpleCPU::BBInst *
+AtomicSimpleCPU::bbFetched()
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+    SimpleThread *thread = t_info.thread;
+
+    const Addr paddr = ifetch_req->getPaddr();
+    const Addr page = paddr >> bbPageShift;
+    const uint64_t epoch = thread->decoder->contextEpoch();
+
+    if (bbRecord) {
+        // Keep recording as long as the instruction bytes come from the
+        // page of the block.
+        if (!bbRecordEnd && (bbRecord->paddr >> bbPageShift) == page &&
+                bbRecord->decoderEpoch == epoch &&
+                (t_info.fetchOffset || bbRecord->insts.size() < bbMaxInsts)) {
+            return nullptr;
+        }
+        bbRecord = nullptr;
+    }
+
+    // Only the first fetch of an instruction can start a block.
+    if (t_info.fetchOffset)
+        return nullptr;
+
+    BasicBlock &bb =
+        bbCache[((paddr >> 1) ^ page) & (bbCache.size() - 1)];
+    if (bb.paddr == paddr && bb.decoderEpoch == epoch &&
+            !bb.insts.empty() &&
+            bb.insts.front().pcBefore->equals(thread->pcState())) {
+        bbReplay = &bb;
+        bbReplayIdx = 1;
+        return &bb.insts.front();
+    }
+
+    bb.paddr = paddr;
+    bb.decoderEpoch = epoch;
+    bb.insts.clear();
+    bbRecord = &bb;
+    bbRecordEnd = false;
+    bbCodePages.insert(page);
+    return nullptr;
+}
+
+void
+AtomicSimpleCPU::bbStopReplay()
+{
+    // Whatever the decoder buffered predates the replayed instructions.
+    bbReplay = nullptr;
+    threadInfo[curThread]->thread->decoder->reset();
+}
+
+void
+AtomicSimpleCPU::bbFlush()
+{
+    for (auto &bb : bbCache) {
+        bb.paddr = MaxAddr;
+        bb.insts.clear();
+    }
+    bbCodePages.clear();
+    bbRecord = nullptr;
+    if (bbReplay)
+        bbStopReplay();
+}
+
+void
+AtomicSimpleCPU::bbCheckWrite(Addr addr, unsigned size)
+{
+    if (bbCodePages.empty() || !size)
+        return;
+
+    const Addr last = (addr + size - 1) >> bbPageShift;
+    for (Addr page = addr >> bbPageShift; page <= last; page++) {
+        if (bbCodePages.count(page)) {
+            bbFlush();
+            return;
+        }
+    }
+}
+
+StaticInstPtr
+AtomicSimpleCPU::decodeInst(PCStateBase &pc_state)
+{
+    if (bbInst) {
+        pc_state.update(*bbInst->pcAfter);
+        return bbInst->inst;
+    }
+
+    if (!bbRecord)
+        return BaseSimpleCPU::decodeInst(pc_state);
+
+    std::unique_ptr<PCStateBase> pc_before(pc_state.clone());
+    StaticInstPtr inst = BaseSimpleCPU::decodeInst(pc_state);
+    if (inst) {
+        bbRecord->insts.push_back({std::move(pc_before),
+                std::unique_ptr<PCStateBase>(pc_state.clone()), inst});
+    }
+    return inst;
+}
+
+Fault
+AtomicSimpleCPU::translateInstFetch()
+{
+    SimpleThread *thread = threadInfo[curThread]->thread;
+    return thread->mmu->translateAtomic(ifetch_req, thread->getTC(),
+                                        BaseMMU::Execute);
+}
+
 Tick
 AtomicSimpleCPU::fetchInstMem()
 {
@@ -41,6 +41,10 @@
 #ifndef __CPU_SIMPLE_ATOMIC_HH__
 #define __CPU_SIMPLE_ATOMIC_HH__
 
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
 #include "cpu/simple/base.hh"
 #include "cpu/simple/exec_context.hh"
 #include "mem/request.hh"
@@ -67,6 +71,65 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     const bool simulate_data_stalls;
     const bool simulate_inst_stalls;
 
+    /**
+     * An instruction of a cached basic block. It stands in for decoding
+     * the bytes at its PC as long as the PC state before decoding
+     * matches the one it was recorded with.
+     */
+    struct BBInst
+    {
+        std::unique_ptr<PCStateBase> pcBefore;
+        std::unique_ptr<PCStateBase> pcAfter;
+        StaticInstPtr inst;
+    };
+
+    /**
+     * A sequence of decoded instructions ending with a control
+     * instruction, all fetched from the page holding the first one.
+     */
+    struct BasicBlock
+    {
+        /** Physical address of the first instruction */
+        Addr paddr = MaxAddr;
+        /** Decoder context epoch the block was recorded in */
+        uint64_t decoderEpoch = 0;
+        std::vector<BBInst> insts;
+    };
+
+    /** Cached blocks never cross an aligned 4KiB boundary */
+    static constexpr unsigned bbPageShift = 12;
+
+    /** Direct mapped cache of basic blocks, empty if disabled */
+    std::vector<BasicBlock> bbCache;
+    const unsigned bbMaxInsts;
+    /** Physical page numbers instructions in bbCache were fetched from */
+    std::unordered_set<Addr> bbCodePages;
+
+    /** Block being replayed and the index of its next instruction */
+    BasicBlock *bbReplay = nullptr;
+    size_t bbReplayIdx = 0;
+    /** Block being recorded */
+    BasicBlock *bbRecord = nullptr;
+    /** The block being recorded ends with the current instruction */
+    bool bbRecordEnd = false;
+    /** Cached decoding of the instruction being fetched, if any */
+    const BBInst *bbInst = nullptr;
+
+    /** Continue replaying the current block, if the PC still matches. */
+    const BBInst *bbNextInst();
+    /**
+     * Bookkeeping for a fetch which went through translation: start or
+     * stop recording, or start replaying a cached block.
+     */
+    const BBInst *bbFetched();
+    void bbStopReplay();
+    /** Drop all the cached blocks */
+    void bbFlush();
+    /** Drop the cached blocks if [addr, addr + size) holds any of them. */
+    void bbCheckWrite(Addr addr, unsigned size);
+
+    StaticInstPtr decodeInst(PCStateBase &pc_state) override;
+
     // main simulation loop (one cycle)
     void tick();
 
@@ -104,6 +167,7 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     bool tryCompleteDrain();
 
     virtual Tick sendPacket(RequestPort &port, const PacketPtr &pkt);
+    virtual Fault translateInstFetch();
     virtual Tick fetchInstMem();
 
     /**
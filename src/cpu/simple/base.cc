@@ -81,6 +81,69 @@
 namespace gem5
 {
 
+namespace
+{
+
+/**
+ * Counts an executed instruction into either the stats of a thread or
+ * their batched plain counterparts, which share the same names.
+ */
+template <class Stats>
+void
+countExecuted(Stats &stats, const StaticInst &inst)
+{
+    if (inst.isMemRef()) {
+        stats.numMemRefs++;
+    }
+
+    if (inst.isControl()) {
+        ++stats.numBranches;
+    }
+
+    /* Power model statistics */
+    //integer alu accesses
+    if (inst.isInteger()){
+        stats.numIntAluAccesses++;
+        stats.numIntInsts++;
+    }
+
+    //float alu accesses
+    if (inst.isFloating()){
+        stats.numFpAluAccesses++;
+        stats.numFpInsts++;
+    }
+
+    //vector alu accesses
+    if (inst.isVector()){
+        stats.numVecAluAccesses++;
+        stats.numVecInsts++;
+    }
+
+    //number of function calls/returns to get window accesses
+    if (inst.isCall() || inst.isReturn()){
+        stats.numCallsReturns++;
+    }
+
+    //the number of branch predictions that will be made
+    if (inst.isCondCtrl()){
+        stats.numCondCtrlInsts++;
+    }
+
+    //result bus acceses
+    if (inst.isLoad()){
+        stats.numLoadInsts++;
+    }
+
+    if (inst.isStore() || inst.isAtomic()){
+        stats.numStoreInsts++;
+    }
+    /* End power model statistics */
+
+    stats.statExecutedInstType[inst.opClass()]++;
+}
+
+} // anonymous namespace
+
 BaseSimpleCPU::BaseSimpleCPU(const BaseSimpleCPUParams &p)
     : BaseCPU(p),
       curThread(0),
@@ -90,6 +153,10 @@ BaseSimpleCPU::BaseSimpleCPU(const BaseSimpleCPUParams &p)
 {
     SimpleThread *thread;
 
+    fatal_if(p.batch_stats && !p.power_model.empty(),
+             "Power models read the stats while simulating, so they can't "
+             "be used with batched stats.");
+
     for (unsigned i = 0; i < numThreads; i++) {
         if (FullSystem) {
             thread = new SimpleThread(
@@ -99,7 +166,8 @@ BaseSimpleCPU::BaseSimpleCPU(const BaseSimpleCPUParams &p)
                 this, i, p.system, p.workload[i], p.mmu, p.isa[i],
                 p.decoder[i]);
         }
-        threadInfo.push_back(new SimpleExecContext(this, thread));
+        threadInfo.push_back(
+                new SimpleExecContext(this, thread, p.batch_stats));
         ThreadContext *tc = thread->getTC();
         threadContexts.push_back(tc);
     }
@@ -155,10 +223,16 @@ BaseSimpleCPU::countInst()
 
     if (!curStaticInst->isMicroop() || curStaticInst->isLastMicroop()) {
         t_info.numInst++;
-        t_info.execContextStats.numInsts++;
+        if (t_info.batchStats)
+            t_info.pendingStats.numInsts++;
+        else
+            t_info.execContextStats.numInsts++;
     }
     t_info.numOp++;
-    t_info.execContextStats.numOps++;
+    if (t_info.batchStats)
+        t_info.pendingStats.numOps++;
+    else
+        t_info.execContextStats.numOps++;
 }
 
 Counter
@@ -200,10 +274,25 @@ BaseSimpleCPU::resetStats()
 {
     BaseCPU::resetStats();
     for (auto &thread_info : threadInfo) {
+        thread_info->clearStats();
         thread_info->execContextStats.notIdleFraction = (_status != Idle);
     }
 }
 
+void
+BaseSimpleCPU::preDumpStats()
+{
+    flushStats();
+    BaseCPU::preDumpStats();
+}
+
+void
+BaseSimpleCPU::flushStats()
+{
+    for (auto &thread_info : threadInfo)
+        thread_info->flushStats();
+}
+
 void
 BaseSimpleCPU::serializeThread(CheckpointOut &cp, ThreadID tid) const
 {
@@ -300,6 +389,22 @@ BaseSimpleCPU::serviceInstCountEvents()
     t_info.thread->comInstEventQueue.serviceEvents(t_info.numInst);
 }
 
+StaticInstPtr
+BaseSimpleCPU::decodeInst(PCStateBase &pc_state)
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+    auto &decoder = t_info.thread->decoder;
+
+    //Predecode, ie bundle up an ExtMachInst
+    //If more fetch data is needed, pass it in.
+    Addr fetch_pc =
+        (pc_state.instAddr() & decoder->pcMask()) + t_info.fetchOffset;
+
+    decoder->moreBytes(pc_state, fetch_pc);
+
+    return decoder->decode(pc_state);
+}
+
 void
 BaseSimpleCPU::preExecute()
 {
@@ -322,18 +427,9 @@ BaseSimpleCPU::preExecute()
                 pc_state.microPC(), curMacroStaticInst);
     } else if (!curMacroStaticInst) {
         //We're not in the middle of a macro instruction
-        StaticInstPtr instPtr = NULL;
-
-        //Predecode, ie bundle up an ExtMachInst
-        //If more fetch data is needed, pass it in.
-        Addr fetch_pc =
-            (pc_state.instAddr() & decoder->pcMask()) + t_info.fetchOffset;
-
-        decoder->moreBytes(pc_state, fetch_pc);
-
         //Decode an instruction if one is ready. Otherwise, we'll have to
         //fetch beyond the MachInst at the current pc.
-        instPtr = decoder->decode(pc_state);
+        StaticInstPtr instPtr = decodeInst(pc_state);
         if (instPtr) {
             t_info.stayAtPC = false;
             thread->pcState(pc_state);
@@ -374,8 +470,12 @@ BaseSimpleCPU::preExecute()
             branchPred->predict(curStaticInst, cur_sn, *t_info.predPC,
                 curThread));
 
-        if (predict_taken)
-            ++t_info.execContextStats.numPredictedBranches;
+        if (predict_taken) {
+            if (t_info.batchStats)
+                ++t_info.pendingStats.numPredictedBranches;
+            else
+                ++t_info.execContextStats.numPredictedBranches;
+        }
     }
 }
 
@@ -388,58 +488,14 @@ BaseSimpleCPU::postExecute()
 
     Addr instAddr = threadContexts[curThread]->pcState().instAddr();
 
-    if (curStaticInst->isMemRef()) {
-        t_info.execContextStats.numMemRefs++;
-    }
-
     if (curStaticInst->isLoad()) {
         ++t_info.numLoad;
     }
 
-    if (curStaticInst->isControl()) {
-        ++t_info.execContextStats.numBranches;
-    }
-
-    /* Power model statistics */
-    //integer alu accesses
-    if (curStaticInst->isInteger()){
-        t_info.execContextStats.numIntAluAccesses++;
-        t_info.execContextStats.numIntInsts++;
-    }
-
-    //float alu accesses
-    if (curStaticInst->isFloating()){
-        t_info.execContextStats.numFpAluAccesses++;
-        t_info.execContextStats.numFpInsts++;
-    }
-
-    //vector alu accesses
-    if (curStaticInst->isVector()){
-        t_info.execContextStats.numVecAluAccesses++;
-        t_info.execContextStats.numVecInsts++;
-    }
-
-    //number of function calls/returns to get window accesses
-    if (curStaticInst->isCall() || curStaticInst->isReturn()){
-        t_info.execContextStats.numCallsReturns++;
-    }
-
-    //the number of branch predictions that will be made
-    if (curStaticInst->isCondCtrl()){
-        t_info.execContextStats.numCondCtrlInsts++;
-    }
-
-    //result bus acceses
-    if (curStaticInst->isLoad()){
-        t_info.execContextStats.numLoadInsts++;
-    }
-
-    if (curStaticInst->isStore() || curStaticInst->isAtomic()){
-        t_info.execContextStats.numStoreInsts++;
-    }
-    /* End power model statistics */
-
-    t_info.execContextStats.statExecutedInstType[curStaticInst->opClass()]++;
+    if (t_info.batchStats)
+        countExecuted(t_info.pendingStats, *curStaticInst);
+    else
+        countExecuted(t_info.execContextStats, *curStaticInst);
 
     if (FullSystem)
         traceFunctions(instAddr);
@@ -470,6 +526,7 @@ BaseSimpleCPU::advancePC(const Fault &fault)
         thread->decoder->reset();
     } else {
         if (curStaticInst) {
+            probeBranchCommit(curThread, curStaticInst, thread->pcState());
             if (curStaticInst->isLastMicroop())
                 curMacroStaticInst = nullStaticInstPtr;
             curStaticInst->advancePC(thread);
@@ -488,7 +545,10 @@ BaseSimpleCPU::advancePC(const Fault &fault)
             // Mis-predicted branch
             branchPred->squash(cur_sn, thread->pcState(), branching,
                     curThread);
-            ++t_info.execContextStats.numBranchMispred;
+            if (t_info.batchStats)
+                ++t_info.pendingStats.numBranchMispred;
+            else
+                ++t_info.execContextStats.numBranchMispred;
         }
     }
 }
@@ -132,6 +132,14 @@ class BaseSimpleCPU : public BaseCPU
 
     std::unique_ptr<PCStateBase> preExecuteTempPC;
 
+    /**
+     * Decode the instruction at pc_state from the bytes fetched so
+     * far, updating pc_state to reflect its size.
+     *
+     * @return The instruction or nullptr if more bytes are needed.
+     */
+    virtual StaticInstPtr decodeInst(PCStateBase &pc_state);
+
   public:
     void checkForInterrupts();
     void setupFetchRequest(const RequestPtr &req);
@@ -144,6 +152,10 @@ class BaseSimpleCPU : public BaseCPU
 
     // statistics
     void resetStats() override;
+    void preDumpStats() override;
+
+    /** Adds the batched per instruction counts to the stats. */
+    void flushStats();
 
     virtual Fault
     readMem(Addr addr, uint8_t* data, unsigned size, Request::Flags flags,
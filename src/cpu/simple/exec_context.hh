@@ -299,21 +299,137 @@ class SimpleExecContext : public ExecContext
 
     } execContextStats;
 
+    /**
+     * Plain counterparts of the per instruction stats, which collect the
+     * counts instead of the stats when batchStats is set until they are
+     * flushed into execContextStats.
+     */
+    struct PendingStats
+    {
+        Counter numInsts = 0;
+        Counter numOps = 0;
+        Counter numIntAluAccesses = 0;
+        Counter numFpAluAccesses = 0;
+        Counter numVecAluAccesses = 0;
+        Counter numCallsReturns = 0;
+        Counter numCondCtrlInsts = 0;
+        Counter numIntInsts = 0;
+        Counter numFpInsts = 0;
+        Counter numVecInsts = 0;
+        Counter numMiscRegReads = 0;
+        Counter numMiscRegWrites = 0;
+        Counter numMemRefs = 0;
+        Counter numLoadInsts = 0;
+        Counter numStoreInsts = 0;
+        Counter numBranches = 0;
+        Counter numPredictedBranches = 0;
+        Counter numBranchMispred = 0;
+        std::array<Counter, Num_OpClasses> statExecutedInstType = {};
+        std::array<Counter, CCRegClass + 1> numRegReads = {};
+        std::array<Counter, CCRegClass + 1> numRegWrites = {};
+    } pendingStats;
+
+    /** Whether per instruction stats are batched in pendingStats. */
+    const bool batchStats;
+
+    /** @{ */
+    /** Count register accesses into either the stats or the batch. */
+    void
+    countRegRead(const RegId &reg)
+    {
+        if (batchStats)
+            pendingStats.numRegReads[reg.classValue()]++;
+        else
+            (*execContextStats.numRegReads[reg.classValue()])++;
+    }
+
+    void
+    countRegWrite(const RegId &reg)
+    {
+        if (batchStats)
+            pendingStats.numRegWrites[reg.classValue()]++;
+        else
+            (*execContextStats.numRegWrites[reg.classValue()])++;
+    }
+
+    void
+    countMiscRegRead()
+    {
+        if (batchStats)
+            pendingStats.numMiscRegReads++;
+        else
+            execContextStats.numMiscRegReads++;
+    }
+
+    void
+    countMiscRegWrite()
+    {
+        if (batchStats)
+            pendingStats.numMiscRegWrites++;
+        else
+            execContextStats.numMiscRegWrites++;
+    }
+    /** @} */
+
   public:
     /** Constructor */
-    SimpleExecContext(BaseSimpleCPU* _cpu, SimpleThread* _thread)
+    SimpleExecContext(BaseSimpleCPU* _cpu, SimpleThread* _thread,
+                      bool batch_stats)
         : cpu(_cpu), thread(_thread), fetchOffset(0), stayAtPC(false),
         numInst(0), numOp(0), numLoad(0), lastIcacheStall(0),
-        lastDcacheStall(0), execContextStats(cpu, thread)
+        lastDcacheStall(0), execContextStats(cpu, thread),
+        batchStats(batch_stats)
     { }
 
+    /** Adds the batched counts to the stats and clears them. */
+    void
+    flushStats()
+    {
+        PendingStats &p = pendingStats;
+        ExecContextStats &s = execContextStats;
+
+        s.numInsts += p.numInsts;
+        s.numOps += p.numOps;
+        s.numIntAluAccesses += p.numIntAluAccesses;
+        s.numFpAluAccesses += p.numFpAluAccesses;
+        s.numVecAluAccesses += p.numVecAluAccesses;
+        s.numCallsReturns += p.numCallsReturns;
+        s.numCondCtrlInsts += p.numCondCtrlInsts;
+        s.numIntInsts += p.numIntInsts;
+        s.numFpInsts += p.numFpInsts;
+        s.numVecInsts += p.numVecInsts;
+        s.numMiscRegReads += p.numMiscRegReads;
+        s.numMiscRegWrites += p.numMiscRegWrites;
+        s.numMemRefs += p.numMemRefs;
+        s.numLoadInsts += p.numLoadInsts;
+        s.numStoreInsts += p.numStoreInsts;
+        s.numBranches += p.numBranches;
+        s.numPredictedBranches += p.numPredictedBranches;
+        s.numBranchMispred += p.numBranchMispred;
+        for (int i = 0; i < Num_OpClasses; ++i) {
+            if (p.statExecutedInstType[i])
+                s.statExecutedInstType[i] += p.statExecutedInstType[i];
+        }
+        for (int i = 0; i <= CCRegClass; ++i) {
+            if (p.numRegReads[i])
+                *s.numRegReads[i] += p.numRegReads[i];
+            if (p.numRegWrites[i])
+                *s.numRegWrites[i] += p.numRegWrites[i];
+        }
+
+        p = PendingStats();
+    }
+
+    /** Drops the batched counts, e.g. when the stats are reset. */
+    void clearStats() { pendingStats = PendingStats(); }
+
     RegVal
     getRegOperand(const StaticInst *si, int idx) override
     {
         const RegId &reg = si->srcRegIdx(idx);
         if (reg.is(InvalidRegClass))
             return 0;
-        (*execContextStats.numRegReads[reg.classValue()])++;
+        countRegRead(reg);
         return thread->getReg(reg);
     }
 
@@ -321,7 +437,7 @@ class SimpleExecContext : public ExecContext
     getRegOperand(const StaticInst *si, int idx, void *val) override
     {
         const RegId &reg = si->srcRegIdx(idx);
-        (*execContextStats.numRegReads[reg.classValue()])++;
+        countRegRead(reg);
         thread->getReg(reg, val);
     }
 
@@ -329,7 +445,7 @@ class SimpleExecContext : public ExecContext
     getWritableRegOperand(const StaticInst *si, int idx) override
     {
         const RegId &reg = si->destRegIdx(idx);
-        (*execContextStats.numRegWrites[reg.classValue()])++;
+        countRegWrite(reg);
         return thread->getWritableReg(reg);
     }
 
@@ -339,7 +455,7 @@ class SimpleExecContext : public ExecContext
         const RegId &reg = si->destRegIdx(idx);
         if (reg.is(InvalidRegClass))
             return;
-        (*execContextStats.numRegWrites[reg.classValue()])++;
+        countRegWrite(reg);
         thread->setReg(reg, val);
     }
 
@@ -347,14 +463,14 @@ class SimpleExecContext : public ExecContext
     setRegOperand(const StaticInst *si, int idx, const void *val) override
     {
         const RegId &reg = si->destRegIdx(idx);
-        (*execContextStats.numRegWrites[reg.classValue()])++;
+        countRegWrite(reg);
         thread->setReg(reg, val);
     }
 
     RegVal
     readMiscRegOperand(const StaticInst *si, int idx) override
     {
-        execContextStats.numMiscRegReads++;
+        countMiscRegRead();
         const RegId& reg = si->srcRegIdx(idx);
         assert(reg.is(MiscRegClass));
         return thread->readMiscReg(reg.index());
@@ -363,7 +479,7 @@ class SimpleExecContext : public ExecContext
     void
     setMiscRegOperand(const StaticInst *si, int idx, RegVal val) override
     {
-        execContextStats.numMiscRegWrites++;
+        countMiscRegWrite();
         const RegId& reg = si->destRegIdx(idx);
         assert(reg.is(MiscRegClass));
         thread->setMiscReg(reg.index(), val);
@@ -376,7 +492,7 @@ class SimpleExecContext : public ExecContext
     RegVal
     readMiscReg(int misc_reg) override
     {
-        execContextStats.numMiscRegReads++;
+        countMiscRegRead();
         return thread->readMiscReg(misc_reg);
     }
 
@@ -387,7 +503,7 @@ class SimpleExecContext : public ExecContext
     void
     setMiscReg(int misc_reg, RegVal val) override
     {
-        execContextStats.numMiscRegWrites++;
+        countMiscRegWrite();
         thread->setMiscReg(misc_reg, val);
     }
 
@@ -37,9 +37,15 @@
 
 #include "cpu/simple/noncaching.hh"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 
 #include "arch/generic/decoder.hh"
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "cpu/exetrace.hh"
+#include "cpu/simple_thread.hh"
 
 namespace gem5
 {
@@ -51,6 +57,11 @@ NonCachingSimpleCPU::NonCachingSimpleCPU(
     assert(p.numThreads == 1);
     fatal_if(!FullSystem && p.workload.size() != 1,
              "only one workload allowed");
+
+    fatal_if(p.soft_tlb_entries && !isPowerOf2(p.soft_tlb_entries),
+             "Number of soft TLB entries must be a power of 2.");
+    for (auto &table : softTlb)
+        table.resize(p.soft_tlb_entries);
 }
 
 void
@@ -73,6 +84,8 @@ NonCachingSimpleCPU::sendPacket(RequestPort &port, const PacketPtr &pkt)
     if (bd && memBackdoors.insert(bd->range(), bd) != memBackdoors.end()) {
         // Install a callback to erase this backdoor if it goes away.
         auto callback = [this](const MemBackdoor &backdoor) {
+                // The soft TLB may point into this backdoor.
+                softTlbFlush();
                 for (auto it = memBackdoors.begin();
                         it != memBackdoors.end(); it++) {
                     if (it->second == &backdoor) {
@@ -87,9 +100,166 @@ NonCachingSimpleCPU::sendPacket(RequestPort &port, const PacketPtr &pkt)
     return latency;
 }
 
+const NonCachingSimpleCPU::SoftTlbEntry *
+NonCachingSimpleCPU::softTlbLookup(BaseMMU::Mode mode, Addr vaddr,
+        unsigned size, Request::Flags flags,
+        const std::vector<bool> &byte_enable)
+{
+    auto &table = softTlb[mode];
+    if (table.empty() || !isPowerOf2(size) || (vaddr & (size - 1)) ||
+            size > (1 << softTlbPageShift)) {
+        return nullptr;
+    }
+    if (!std::all_of(byte_enable.begin(), byte_enable.end(),
+                [](bool b) { return b; })) {
+        return nullptr;
+    }
+
+    const Addr vpn = vaddr >> softTlbPageShift;
+    const SoftTlbEntry &entry = table[vpn & (table.size() - 1)];
+    if (entry.vpn != vpn || entry.flags != (Request::FlagsType)flags ||
+            entry.epoch != threadInfo[curThread]->thread->mmu->
+                translationEpoch()) {
+        return nullptr;
+    }
+
+    return &entry;
+}
+
+void
+NonCachingSimpleCPU::softTlbFill(BaseMMU::Mode mode, const RequestPtr &req,
+        Addr vaddr, unsigned size, Request::Flags flags)
+{
+    auto &table = softTlb[mode];
+    if (table.empty() || !isPowerOf2(size) || (vaddr & (size - 1)) ||
+            size > (1 << softTlbPageShift)) {
+        return;
+    }
+
+    // Only plain accesses can skip the memory system. Anything with
+    // side effects, e.g. LLSC, prefetches or cache maintenance, has
+    // to use the normal path.
+    Request::FlagsType allowed = Request::ARCH_BITS;
+    if (mode == BaseMMU::Execute)
+        allowed |= Request::INST_FETCH;
+    if ((Request::FlagsType)flags & ~allowed)
+        return;
+
+    if (!req->hasPaddr() || req->getVaddr() != vaddr ||
+            req->getSize() != size || req->isUncacheable() ||
+            req->isStrictlyOrdered() || req->isLocalAccess()) {
+        return;
+    }
+
+    SimpleThread *thread = threadInfo[curThread]->thread;
+    if (!thread->mmu->translationCacheable(req, thread->getTC(), mode))
+        return;
+
+    const Addr page_size = 1 << softTlbPageShift;
+    const Addr ppage = req->getPaddr() & ~mask(softTlbPageShift);
+    auto bd_it = memBackdoors.contains(RangeSize(ppage, page_size));
+    if (bd_it == memBackdoors.end())
+        return;
+    const MemBackdoorPtr bd = bd_it->second;
+    if (mode == BaseMMU::Write ? !bd->writeable() : !bd->readable())
+        return;
+
+    const Addr vpn = vaddr >> softTlbPageShift;
+    SoftTlbEntry &entry = table[vpn & (table.size() - 1)];
+    entry.vpn = vpn;
+    entry.flags = flags;
+    entry.epoch = thread->mmu->translationEpoch();
+    entry.paddr = ppage;
+    entry.host = bd->ptr() + (ppage - bd->range().start());
+}
+
+void
+NonCachingSimpleCPU::softTlbFlush()
+{
+    for (auto &table : softTlb)
+        std::fill(table.begin(), table.end(), SoftTlbEntry());
+}
+
+Fault
+NonCachingSimpleCPU::readMem(Addr addr, uint8_t *data, unsigned size,
+                             Request::Flags flags,
+                             const std::vector<bool> &byte_enable)
+{
+    if (auto *entry = softTlbLookup(BaseMMU::Read, addr, size, flags,
+                                    byte_enable)) {
+        if (traceData)
+            traceData->setMem(addr, size, flags);
+        memcpy(data, entry->host + (addr & mask(softTlbPageShift)), size);
+        dcache_latency = 0;
+        dcache_access = true;
+        return NoFault;
+    }
+
+    Fault fault = AtomicSimpleCPU::readMem(addr, data, size, flags,
+                                           byte_enable);
+    if (fault == NoFault)
+        softTlbFill(BaseMMU::Read, data_read_req, addr, size, flags);
+    return fault;
+}
+
+Fault
+NonCachingSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
+                              Request::Flags flags, uint64_t *res,
+                              const std::vector<bool> &byte_enable)
+{
+    const SoftTlbEntry *entry = (data && !res) ?
+        softTlbLookup(BaseMMU::Write, addr, size, flags, byte_enable) :
+        nullptr;
+    if (entry) {
+        const Addr offset = addr & mask(softTlbPageShift);
+        if (traceData)
+            traceData->setMem(addr, size, flags);
+        memcpy(entry->host + offset, data, size);
+        bbCheckWrite(entry->paddr + offset, size);
+        dcache_latency = 0;
+        dcache_access = true;
+        return NoFault;
+    }
+
+    Fault fault = AtomicSimpleCPU::writeMem(data, size, addr, flags, res,
+                                            byte_enable);
+    if (fault == NoFault && data && !res)
+        softTlbFill(BaseMMU::Write, data_write_req, addr, size, flags);
+    return fault;
+}
+
+Fault
+NonCachingSimpleCPU::translateInstFetch()
+{
+    const Addr vaddr = ifetch_req->getVaddr();
+    if (auto *entry = softTlbLookup(BaseMMU::Execute, vaddr,
+                                    ifetch_req->getSize(),
+                                    ifetch_req->getFlags(),
+                                    std::vector<bool>())) {
+        const Addr offset = vaddr & mask(softTlbPageShift);
+        ifetch_req->setPaddr(entry->paddr + offset);
+        fetchHost = entry->host + offset;
+        return NoFault;
+    }
+    fetchHost = nullptr;
+
+    Fault fault = AtomicSimpleCPU::translateInstFetch();
+    if (fault == NoFault) {
+        softTlbFill(BaseMMU::Execute, ifetch_req, ifetch_req->getVaddr(),
+                    ifetch_req->getSize(), ifetch_req->getFlags());
+    }
+    return fault;
+}
+
 Tick
 NonCachingSimpleCPU::fetchInstMem()
 {
+    if (fetchHost) {
+        auto &decoder = threadInfo[curThread]->thread->decoder;
+        memcpy(decoder->moreBytesPtr(), fetchHost, ifetch_req->getSize());
+        return 0;
+    }
+
     auto bd_it = memBackdoors.contains(ifetch_req->getPaddr());
     if (bd_it == memBackdoors.end())
         return AtomicSimpleCPU::fetchInstMem();
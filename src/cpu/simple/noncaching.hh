@@ -38,6 +38,10 @@
 #ifndef __CPU_SIMPLE_NONCACHING_HH__
 #define __CPU_SIMPLE_NONCACHING_HH__
 
+#include <array>
+#include <vector>
+
+#include "arch/generic/mmu.hh"
 #include "base/addr_range_map.hh"
 #include "cpu/simple/atomic.hh"
 #include "mem/backdoor.hh"
@@ -57,10 +61,70 @@ class NonCachingSimpleCPU : public AtomicSimpleCPU
 
     void verifyMemoryMode() const override;
 
+    Fault readMem(Addr addr, uint8_t *data, unsigned size,
+                  Request::Flags flags,
+                  const std::vector<bool> &byte_enable=std::vector<bool>())
+        override;
+
+    Fault writeMem(uint8_t *data, unsigned size,
+                   Addr addr, Request::Flags flags, uint64_t *res,
+                   const std::vector<bool> &byte_enable=std::vector<bool>())
+        override;
+
   protected:
     AddrRangeMap<MemBackdoorPtr, 1> memBackdoors;
 
+    /**
+     * An entry of the soft TLB, caching the host address the page at
+     * vpn is backed by for accesses using the given request flags. It
+     * is only valid in the translation epoch of the MMU it was filled
+     * in.
+     */
+    struct SoftTlbEntry
+    {
+        Addr vpn = MaxAddr;
+        Request::FlagsType flags = 0;
+        uint64_t epoch = 0;
+        Addr paddr = 0;
+        uint8_t *host = nullptr;
+    };
+
+    /**
+     * Soft TLB pages are 4KiB, which no ISA supporting cached
+     * translations maps in smaller granules.
+     */
+    static constexpr unsigned softTlbPageShift = 12;
+
+    /**
+     * Direct mapped soft TLBs for reads, writes and fetches. They
+     * let accesses to memory providing a backdoor skip both the MMU
+     * and the memory system.
+     */
+    std::array<std::vector<SoftTlbEntry>, BaseMMU::Execute + 1> softTlb;
+
+    /** Host address of the fetch translated through the soft TLB */
+    uint8_t *fetchHost = nullptr;
+
+    /**
+     * Look an access up in the soft TLB.
+     * @return The entry translating the page accessed or nullptr on miss.
+     */
+    const SoftTlbEntry *softTlbLookup(BaseMMU::Mode mode, Addr vaddr,
+                                      unsigned size, Request::Flags flags,
+                                      const std::vector<bool> &byte_enable);
+
+    /**
+     * Cache the translation done by req for the access to vaddr, if
+     * the MMU allows it and the whole page is covered by a backdoor.
+     */
+    void softTlbFill(BaseMMU::Mode mode, const RequestPtr &req, Addr vaddr,
+                     unsigned size, Request::Flags flags);
+
+    /** Drop all the soft TLB entries, e.g. when a backdoor goes away */
+    void softTlbFlush();
+
     Tick sendPacket(RequestPort &port, const PacketPtr &pkt) override;
+    Fault translateInstFetch() override;
     Tick fetchInstMem() override;
 };
 
@@ -94,6 +94,9 @@ TimingSimpleCPU::drain()
     // Deschedule any power gating event (if any)
     deschedulePowerGatingEvent();
 
+    // Anyone looking at the stats after draining expects them up to date.
+    flushStats();
+
     if (switchedOut())
         return DrainState::Drained;
 
@@ -161,6 +164,7 @@ TimingSimpleCPU::tryCompleteDrain()
         return false;
 
     DPRINTF(Drain, "CPU done draining, processing drain event\n");
+    flushStats();
     signalDrainDone();
 
     return true;
@@ -36,6 +36,25 @@
 namespace gem5
 {
 
+/**
+ * Returns a TimeBuffer slot to its default state when the buffer
+ * advances onto it. By default the element is destroyed, zeroed and
+ * default constructed again. Element types owning storage which the
+ * next data written to the slot could reuse can specialise this to
+ * reset the element in place instead.
+ */
+template <class T>
+struct TimeBufferSlot
+{
+    static void
+    reset(T *elem)
+    {
+        elem->~T();
+        std::memset(static_cast<void *>(elem), 0, sizeof(T));
+        new (elem) T;
+    }
+};
+
 template <class T>
 class TimeBuffer
 {
@@ -184,9 +203,7 @@ class TimeBuffer
         int ptr = base + future;
         if (ptr >= (int)size)
             ptr -= size;
-        (reinterpret_cast<T *>(index[ptr]))->~T();
-        std::memset(index[ptr], 0, sizeof(T));
-        new (index[ptr]) T;
+        TimeBufferSlot<T>::reset(reinterpret_cast<T *>(index[ptr]));
     }
 
   protected:
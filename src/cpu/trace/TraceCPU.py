@@ -60,7 +60,8 @@ class TraceCPU(BaseCPU):
         return True
 
     instTraceFile = Param.String("", "Instruction trace file")
-    dataTraceFile = Param.String("", "Data dependency trace file")
+    dataTraceFile = Param.String("", "Data dependency trace file, in "\
+        "protobuf or packed (util/pack_inst_dep_trace.py) format")
     sizeStoreBuffer = Param.Unsigned(16, "Number of entries in the store "\
         "buffer")
     sizeLoadBuffer = Param.Unsigned(16, "Number of entries in the load buffer")
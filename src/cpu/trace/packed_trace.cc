@@ -0,0 +1,121 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/trace/packed_trace.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+bool
+PackedDepTrace::isPacked(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    char magic[sizeof(Magic)];
+    if (!file.read(magic, sizeof(magic)))
+        return false;
+    return std::memcmp(magic, Magic, sizeof(Magic)) == 0;
+}
+
+PackedDepTrace::PackedDepTrace(const std::string &filename) :
+    fileName(filename), buffer(nullptr), length(0), hdr(nullptr),
+    records(nullptr), deps(nullptr), next(0)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    fatal_if(fd < 0, "Could not open %s for reading: %s\n", filename,
+             strerror(errno));
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        fatal("Cannot stat %s: %s\n", filename, strerror(errno));
+    }
+    length = file_stat.st_size;
+    if (length < sizeof(Header)) {
+        close(fd);
+        fatal("%s is too short to be a packed dependency trace\n", filename);
+    }
+
+    buffer = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    fatal_if(buffer == MAP_FAILED, "Failed to map %s: %s\n", filename,
+             strerror(errno));
+    // Records are consumed front to back.
+    madvise(buffer, length, MADV_SEQUENTIAL);
+
+    const char *base = static_cast<const char *>(buffer);
+    hdr = reinterpret_cast<const Header *>(base);
+    fatal_if(std::memcmp(hdr->magic, Magic, sizeof(Magic)) != 0,
+             "%s is not a packed dependency trace\n", filename);
+    fatal_if(hdr->version != Version,
+             "%s has packed trace version %d, expected %d\n", filename,
+             hdr->version, Version);
+
+    // Both arrays must be aligned and lie entirely within the file.
+    fatal_if(hdr->recordsOffset % alignof(Record) ||
+             hdr->depsOffset % alignof(uint64_t),
+             "%s has misaligned packed trace sections\n", filename);
+    fatal_if(hdr->recordsOffset > length ||
+             hdr->numRecords > (length - hdr->recordsOffset) / sizeof(Record),
+             "%s is truncated in its record array\n", filename);
+    fatal_if(hdr->depsOffset > length ||
+             hdr->numDeps > (length - hdr->depsOffset) / sizeof(uint64_t),
+             "%s is truncated in its dependency array\n", filename);
+
+    records = reinterpret_cast<const Record *>(base + hdr->recordsOffset);
+    deps = reinterpret_cast<const uint64_t *>(base + hdr->depsOffset);
+}
+
+PackedDepTrace::~PackedDepTrace()
+{
+    if (buffer && buffer != MAP_FAILED)
+        munmap(buffer, length);
+}
+
+bool
+PackedDepTrace::read(const Record *&rec, const uint64_t *&rec_deps)
+{
+    if (next == hdr->numRecords)
+        return false;
+
+    rec = &records[next++];
+    fatal_if(rec->depIndex + rec->numRobDeps + rec->numRegDeps >
+             hdr->numDeps, "Record %d of %s has dependencies past the end "
+             "of the dependency array\n", rec->seqNum, fileName);
+    rec_deps = &deps[rec->depIndex];
+    return true;
+}
+
+} // namespace gem5
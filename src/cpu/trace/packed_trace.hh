@@ -0,0 +1,148 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a reader for elastic data dependency traces that have
+ * been converted ahead of time to a flat, indexed binary layout by
+ * util/pack_inst_dep_trace.py. The file is mapped into memory and
+ * records are used in place, so replay does not decode varints or
+ * construct protobuf messages.
+ */
+
+#ifndef __CPU_TRACE_PACKED_TRACE_HH__
+#define __CPU_TRACE_PACKED_TRACE_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace gem5
+{
+
+class PackedDepTrace
+{
+  public:
+    /** File magic. Differs from the protobuf magic in its first bytes. */
+    static constexpr char Magic[8] = {'G', '5', 'P', 'K', 'D', 'E', 'P', 0};
+
+    /** Layout version, bumped whenever Header or Record change. */
+    static constexpr uint32_t Version = 1;
+
+    /** File header, stored at offset 0. */
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        /** Window size the trace was recorded with. */
+        uint32_t windowSize;
+        /** Tick frequency the trace was recorded with. */
+        uint64_t tickFreq;
+        uint64_t numRecords;
+        uint64_t numDeps;
+        /** Byte offset of the Record array. */
+        uint64_t recordsOffset;
+        /** Byte offset of the dependency array. */
+        uint64_t depsOffset;
+    };
+
+    /**
+     * One instruction of the trace. The dependencies of a record are
+     * stored back to back in the dependency array starting at depIndex,
+     * the order dependencies first followed by the register dependencies.
+     * Register dependencies that duplicate an order dependency have
+     * already been dropped by the converter.
+     */
+    struct Record
+    {
+        uint64_t seqNum;
+        uint64_t physAddr;
+        uint64_t virtAddr;
+        uint64_t pc;
+        uint64_t compDelay;
+        uint64_t depIndex;
+        uint32_t size;
+        uint32_t flags;
+        uint32_t weight;
+        /** An InstDepRecord::RecordType. */
+        uint8_t type;
+        uint8_t numRobDeps;
+        uint8_t numRegDeps;
+        uint8_t pad;
+    };
+
+    static_assert(sizeof(Record) == 64, "Packed records must be 64 bytes");
+
+    /**
+     * Check whether a file starts with the packed trace magic.
+     *
+     * @param filename Path to the trace
+     * @return true if the file should be read with this class
+     */
+    static bool isPacked(const std::string &filename);
+
+    /**
+     * Map a packed trace and validate its header and layout.
+     *
+     * @param filename Path to the trace
+     */
+    PackedDepTrace(const std::string &filename);
+    ~PackedDepTrace();
+
+    PackedDepTrace(const PackedDepTrace &) = delete;
+    PackedDepTrace &operator=(const PackedDepTrace &) = delete;
+
+    const Header &header() const { return *hdr; }
+
+    /**
+     * Get the next record of the trace.
+     *
+     * @param rec Set to the record
+     * @param deps Set to the first of its dependencies
+     * @return false at the end of the trace
+     */
+    bool read(const Record *&rec, const uint64_t *&deps);
+
+    /** Rewind to the first record. */
+    void reset() { next = 0; }
+
+  private:
+    const std::string fileName;
+
+    /** Mapping of the whole file. */
+    void *buffer;
+    size_t length;
+
+    const Header *hdr;
+    const Record *records;
+    const uint64_t *deps;
+
+    /** Index of the record returned by the next read(). */
+    uint64_t next;
+};
+
+} // namespace gem5
+
+#endif //__CPU_TRACE_PACKED_TRACE_HH__
@@ -312,13 +312,14 @@ TraceCPU::ElasticDataGen::readNextWindow()
     while (num_read != windowSize) {
 
         // Create a new graph node
-        GraphNode* new_node = new GraphNode;
+        GraphNode* new_node = allocNode();
 
         // Read the next line to get the next record. If that fails then end of
         // trace has been reached and traceComplete needs to be set in addition
         // to returning false.
         if (!trace.read(new_node)) {
             DPRINTF(TraceCPUData, "\tTrace complete!\n");
+            freeNode(new_node);
             traceComplete = true;
             return false;
         }
@@ -330,8 +331,8 @@ TraceCPU::ElasticDataGen::readNextWindow()
         addDepsOnParent(new_node, new_node->regDep);
 
         num_read++;
-        // Add to map
-        depGraph[new_node->seqNum] = new_node;
+        // Add to the window
+        depGraph.push(new_node);
         if (new_node->robDep.empty() && new_node->regDep.empty()) {
             // Source dependencies are already complete, check if resources
             // are available and issue. The execution time is approximated
@@ -345,6 +346,28 @@ TraceCPU::ElasticDataGen::readNextWindow()
     return true;
 }
 
+TraceCPU::ElasticDataGen::GraphNode*
+TraceCPU::ElasticDataGen::allocNode()
+{
+    if (freeNodes.empty())
+        return new GraphNode;
+
+    GraphNode* node_ptr = freeNodes.back();
+    freeNodes.pop_back();
+    return node_ptr;
+}
+
+void
+TraceCPU::ElasticDataGen::freeNode(GraphNode* node_ptr)
+{
+    // Only drop the contents of the dependency containers so that their
+    // storage is reused by the next record read into this node.
+    node_ptr->dependents.clear();
+    node_ptr->robDep.clear();
+    node_ptr->regDep.clear();
+    freeNodes.push_back(node_ptr);
+}
+
 template<typename T>
 void
 TraceCPU::ElasticDataGen::addDepsOnParent(GraphNode *new_node, T& dep_list)
@@ -352,13 +375,13 @@ TraceCPU::ElasticDataGen::addDepsOnParent(GraphNode *new_node, T& dep_list)
     auto dep_it = dep_list.begin();
     while (dep_it != dep_list.end()) {
         // We look up the valid dependency, i.e. the parent of this node
-        auto parent_itr = depGraph.find(*dep_it);
-        if (parent_itr != depGraph.end()) {
+        GraphNode* parent = depGraph.find(*dep_it);
+        if (parent) {
             // If the parent is found, it is yet to be executed. Append a
             // pointer to the new node to the dependents list of the parent
             // node.
-            parent_itr->second->dependents.push_back(new_node);
-            auto num_depts = parent_itr->second->dependents.size();
+            parent->dependents.push_back(new_node);
+            auto num_depts = parent->dependents.size();
             elasticStats.maxDependents = std::max<double>(num_depts,
                                         elasticStats.maxDependents.value());
             dep_it++;
@@ -401,16 +424,14 @@ TraceCPU::ElasticDataGen::execute()
         }
     }
     // Proceed to execute from readyList
-    auto graph_itr = depGraph.begin();
     auto free_itr = readyList.begin();
     // Iterate through readyList until the next free node has its execute
     // tick later than curTick or the end of readyList is reached
     while (free_itr->execTick <= curTick() && free_itr != readyList.end()) {
 
         // Get pointer to the node to be executed
-        graph_itr = depGraph.find(free_itr->seqNum);
-        assert(graph_itr != depGraph.end());
-        GraphNode* node_ptr = graph_itr->second;
+        GraphNode* node_ptr = depGraph.find(free_itr->seqNum);
+        assert(node_ptr);
 
         // If there is a retryPkt send that else execute the load
         if (retryPkt) {
@@ -505,14 +526,12 @@ TraceCPU::ElasticDataGen::execute()
         if (!node_ptr->isLoad() || node_ptr->isStrictlyOrdered()) {
             // Release all resources occupied by the completed node
             hwResource.release(node_ptr);
-            // clear the dynamically allocated set of dependents
-            (node_ptr->dependents).clear();
             // Update the stat for numOps simulated
             owner.updateNumOps(node_ptr->robNum);
-            // delete node
-            delete node_ptr;
             // remove from graph
-            depGraph.erase(graph_itr);
+            depGraph.remove(node_ptr);
+            // recycle node
+            freeNode(node_ptr);
         }
         // Point to first node to continue to next iteration of while loop
         free_itr = readyList.begin();
@@ -697,9 +716,8 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
     } else {
         // If it is a load response then release the dependents waiting on it.
         // Get pointer to the completed load
-        auto graph_itr = depGraph.find(pkt->req->getReqInstSeqNum());
-        assert(graph_itr != depGraph.end());
-        GraphNode* node_ptr = graph_itr->second;
+        GraphNode* node_ptr = depGraph.find(pkt->req->getReqInstSeqNum());
+        assert(node_ptr);
 
         // Release resources occupied by the load
         hwResource.release(node_ptr);
@@ -713,14 +731,12 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
             }
         }
 
-        // clear the dynamically allocated set of dependents
-        (node_ptr->dependents).clear();
         // Update the stat for numOps completed
         owner.updateNumOps(node_ptr->robNum);
-        // delete node
-        delete node_ptr;
         // remove from graph
-        depGraph.erase(graph_itr);
+        depGraph.remove(node_ptr);
+        // recycle node
+        freeNode(node_ptr);
     }
 
     if (debug::TraceCPUData) {
@@ -820,14 +836,75 @@ TraceCPU::ElasticDataGen::printReadyList()
     }
     DPRINTF(TraceCPUData, "Printing readyList:\n");
     while (itr != readyList.end()) {
-        auto graph_itr = depGraph.find(itr->seqNum);
-        [[maybe_unused]] GraphNode* node_ptr = graph_itr->second;
+        [[maybe_unused]] GraphNode* node_ptr = depGraph.find(itr->seqNum);
         DPRINTFR(TraceCPUData, "\t%lld(%s), %lld\n", itr->seqNum,
             node_ptr->typeToStr(), itr->execTick);
         itr++;
     }
 }
 
+TraceCPU::ElasticDataGen::DepWindow::DepWindow() :
+    head(0), tail(0), numNodes(0)
+{}
+
+TraceCPU::ElasticDataGen::DepWindow::~DepWindow()
+{
+    for (GraphNode* node_ptr : nodes)
+        delete node_ptr;
+}
+
+void
+TraceCPU::ElasticDataGen::DepWindow::reserve(size_t num_seq_nums)
+{
+    while (nodes.size() < num_seq_nums)
+        grow();
+}
+
+void
+TraceCPU::ElasticDataGen::DepWindow::grow()
+{
+    std::vector<GraphNode*> old_nodes(nodes.empty() ? 16 : 2 * nodes.size(),
+                                      nullptr);
+    nodes.swap(old_nodes);
+    for (GraphNode* node_ptr : old_nodes) {
+        if (node_ptr)
+            nodes[slot(node_ptr->seqNum)] = node_ptr;
+    }
+}
+
+void
+TraceCPU::ElasticDataGen::DepWindow::push(GraphNode* node_ptr)
+{
+    const NodeSeqNum seq_num = node_ptr->seqNum;
+    panic_if(seq_num < tail, "Trace records must have increasing sequence "
+             "numbers, %lli follows %lli.\n", seq_num, tail - 1);
+
+    // Nothing older is left, so the window can start at this node
+    if (numNodes == 0)
+        head = seq_num;
+    while (seq_num - head >= nodes.size())
+        grow();
+
+    nodes[slot(seq_num)] = node_ptr;
+    tail = seq_num + 1;
+    ++numNodes;
+}
+
+void
+TraceCPU::ElasticDataGen::DepWindow::remove(const GraphNode* node_ptr)
+{
+    assert(find(node_ptr->seqNum) == node_ptr);
+
+    nodes[slot(node_ptr->seqNum)] = nullptr;
+    if (--numNodes == 0) {
+        head = tail;
+        return;
+    }
+    // Move past the empty slots at the old end of the window
+    while (!nodes[slot(head)])
+        ++head;
+}
+
 TraceCPU::ElasticDataGen::HardwareResource::HardwareResource(
         uint16_t max_rob, uint16_t max_stores, uint16_t max_loads) :
     sizeROB(max_rob),
@@ -1196,13 +1273,24 @@ TraceCPU::DcachePort::recvReqRetry()
 
 TraceCPU::ElasticDataGen::InputStream::InputStream(
         const std::string& filename, const double time_multiplier) :
-    trace(filename),
     timeMultiplier(time_multiplier),
     microOpCount(0)
 {
+    if (PackedDepTrace::isPacked(filename)) {
+        packedTrace.reset(new PackedDepTrace(filename));
+        const PackedDepTrace::Header &header = packedTrace->header();
+        fatal_if(header.tickFreq != sim_clock::Frequency,
+                 "Trace %s was recorded with a different tick frequency %d\n",
+                 filename, header.tickFreq);
+        windowSize = header.windowSize;
+        return;
+    }
+
+    protoTrace.reset(new ProtoInputStream(filename));
+
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::InstDepRecordHeader header_msg;
-    if (!trace.read(header_msg)) {
+    if (!protoTrace->read(header_msg)) {
         panic("Failed to read packet header from %s\n", filename);
 
         if (header_msg.tick_freq() != sim_clock::Frequency) {
@@ -1219,14 +1307,55 @@ TraceCPU::ElasticDataGen::InputStream::InputStream(
 void
 TraceCPU::ElasticDataGen::InputStream::reset()
 {
-    trace.reset();
+    if (packedTrace)
+        packedTrace->reset();
+    else
+        protoTrace->reset();
 }
 
 bool
 TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
 {
-    ProtoMessage::InstDepRecord pkt_msg;
-    if (trace.read(pkt_msg)) {
+    return packedTrace ? readPacked(element) : readProto(element);
+}
+
+bool
+TraceCPU::ElasticDataGen::InputStream::readPacked(GraphNode* element)
+{
+    const PackedDepTrace::Record *rec;
+    const uint64_t *deps;
+    if (!packedTrace->read(rec, deps))
+        return false;
+
+    element->seqNum = rec->seqNum;
+    element->type = static_cast<RecordType>(rec->type);
+    // Scale the compute delay to effectively scale the Trace CPU frequency
+    element->compDelay = rec->compDelay * timeMultiplier;
+
+    // The converter has already dropped register dependencies that are
+    // also order dependencies.
+    element->robDep.assign(deps, deps + rec->numRobDeps);
+    deps += rec->numRobDeps;
+    element->regDep.assign(deps, deps + rec->numRegDeps);
+
+    // Absent optional fields were stored as zero
+    element->physAddr = rec->physAddr;
+    element->virtAddr = rec->virtAddr;
+    element->size = rec->size;
+    element->flags = rec->flags;
+    element->pc = rec->pc;
+
+    // ROB occupancy number
+    microOpCount += 1 + rec->weight;
+    element->robNum = microOpCount;
+    return true;
+}
+
+bool
+TraceCPU::ElasticDataGen::InputStream::readProto(GraphNode* element)
+{
+    ProtoMessage::InstDepRecord &pkt_msg = pktMsg;
+    if (protoTrace->read(pkt_msg)) {
         // Required fields
         element->seqNum = pkt_msg.seq_num();
         element->type = pkt_msg.type();
@@ -1234,10 +1363,8 @@ TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
         element->compDelay = pkt_msg.comp_delay() * timeMultiplier;
 
         // Repeated field robDepList
-        element->robDep.clear();
-        for (int i = 0; i < (pkt_msg.rob_dep()).size(); i++) {
-            element->robDep.push_back(pkt_msg.rob_dep(i));
-        }
+        element->robDep.assign(pkt_msg.rob_dep().begin(),
+                               pkt_msg.rob_dep().end());
 
         // Repeated field
         element->regDep.clear();
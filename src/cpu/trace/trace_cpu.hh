@@ -40,12 +40,14 @@
 
 #include <cstdint>
 #include <list>
+#include <memory>
 #include <queue>
 #include <set>
-#include <unordered_map>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "cpu/base.hh"
+#include "cpu/trace/packed_trace.hh"
 #include "debug/TraceCPUData.hh"
 #include "debug/TraceCPUInst.hh"
 #include "params/TraceCPU.hh"
@@ -557,11 +559,16 @@ class TraceCPU : public BaseCPU
         class GraphNode
         {
           public:
-            /** Typedef for the list containing the ROB dependencies */
-            typedef std::list<NodeSeqNum> RobDepList;
+            /**
+             * Typedef for the list containing the ROB dependencies. A node
+             * has only a handful of dependencies, so a vector is cheaper to
+             * search and erase from than a list, and keeps its storage when
+             * the node is recycled.
+             */
+            typedef std::vector<NodeSeqNum> RobDepList;
 
             /** Typedef for the list containing the register dependencies */
-            typedef std::list<NodeSeqNum> RegDepList;
+            typedef std::vector<NodeSeqNum> RegDepList;
 
             /** Instruction sequence number */
             NodeSeqNum seqNum;
@@ -653,6 +660,79 @@ class TraceCPU : public BaseCPU
             Tick execTick;
         };
 
+        /**
+         * The DepWindow holds the nodes read from the trace that have not
+         * completed yet. Records arrive in increasing sequence number order
+         * and the span of sequence numbers in flight is bounded by the ROB,
+         * so a node is stored in a ring at its sequence number modulo the
+         * ring size. Finding a node is a single array access, and adding and
+         * removing nodes does not allocate once the ring covers the largest
+         * span seen. Sequence numbers skipped by the trace and nodes that
+         * completed out of order leave empty slots.
+         */
+        class DepWindow
+        {
+          public:
+            DepWindow();
+
+            /** Delete the nodes still in the window. */
+            ~DepWindow();
+
+            /** Size the ring to span at least num_seq_nums sequence numbers. */
+            void reserve(size_t num_seq_nums);
+
+            /**
+             * Add a node read from the trace. Its sequence number must be
+             * larger than that of any node added before it.
+             */
+            void push(GraphNode* node_ptr);
+
+            /**
+             * Find a node by sequence number.
+             *
+             * @return the node, or nullptr if it is not in the window
+             */
+            GraphNode* find(NodeSeqNum seq_num) const
+            {
+                if (seq_num < head || seq_num >= tail)
+                    return nullptr;
+                return nodes[slot(seq_num)];
+            }
+
+            /** Remove a node from the window without deleting it. */
+            void remove(const GraphNode* node_ptr);
+
+            /** Number of nodes in the window. */
+            size_t size() const { return numNodes; }
+
+            bool empty() const { return numNodes == 0; }
+
+          private:
+            /** Ring slot of a sequence number. */
+            size_t slot(NodeSeqNum seq_num) const
+            {
+                return seq_num & (nodes.size() - 1);
+            }
+
+            /** Double the ring, keeping the nodes in it. */
+            void grow();
+
+            /**
+             * The ring of nodes, nullptr where there is none. Its size is a
+             * power of two.
+             */
+            std::vector<GraphNode*> nodes;
+
+            /** No node in the window has a smaller sequence number. */
+            NodeSeqNum head;
+
+            /** One past the sequence number of the newest node. */
+            NodeSeqNum tail;
+
+            /** Number of nodes in the window. */
+            size_t numNodes;
+        };
+
         /**
          * The HardwareResource class models structures that hold the in-flight
          * nodes. When a node becomes dependency free, first check if resources
@@ -756,13 +836,18 @@ class TraceCPU : public BaseCPU
         /**
          * The InputStream encapsulates a trace file and the
          * internal buffers and populates GraphNodes based on
-         * the input.
+         * the input. The trace is either a protobuf trace or a packed
+         * trace produced from one by util/pack_inst_dep_trace.py, which
+         * is detected by its magic.
          */
         class InputStream
         {
           private:
-            /** Input file stream for the protobuf trace */
-            ProtoInputStream trace;
+            /** Input file stream for a protobuf trace */
+            std::unique_ptr<ProtoInputStream> protoTrace;
+
+            /** Mapped packed trace, used instead of protoTrace if set */
+            std::unique_ptr<PackedDepTrace> packedTrace;
 
             /**
              * A multiplier for the compute delays in the trace to modulate
@@ -781,6 +866,18 @@ class TraceCPU : public BaseCPU
              */
             uint32_t windowSize;
 
+            /**
+             * Message that records are parsed into. Reusing it lets protobuf
+             * keep the storage of its repeated fields between records.
+             */
+            ProtoMessage::InstDepRecord pktMsg;
+
+            /** Populate a node from the next protobuf record. */
+            bool readProto(GraphNode* element);
+
+            /** Populate a node from the next packed record. */
+            bool readPacked(GraphNode* element);
+
           public:
             /**
              * Create a trace input stream for a given file name.
@@ -836,6 +933,17 @@ class TraceCPU : public BaseCPU
         {
             DPRINTF(TraceCPUData, "Window size in the trace is %d.\n",
                     windowSize);
+            // The graph is refilled a window at a time once it drops below
+            // one window, so it holds at most about two windows of nodes.
+            // Their sequence numbers span more than that where the trace
+            // skips numbers, in which case the window grows on demand.
+            depGraph.reserve(2 * windowSize);
+        }
+
+        ~ElasticDataGen()
+        {
+            for (GraphNode* node_ptr : freeNodes)
+                delete node_ptr;
         }
 
         /**
@@ -880,6 +988,12 @@ class TraceCPU : public BaseCPU
         template<typename T>
         void addDepsOnParent(GraphNode *new_node, T& dep_list);
 
+        /** Get a node for a new record, reusing a retired one if possible. */
+        GraphNode* allocNode();
+
+        /** Retire a node that has been removed from the depGraph. */
+        void freeNode(GraphNode* node_ptr);
+
         /**
          * This is the main execute function which consumes nodes from the
          * sorted readyList. First attempt to issue the pending dependency-free
@@ -991,7 +1105,14 @@ class TraceCPU : public BaseCPU
         HardwareResource hwResource;
 
         /** Store the depGraph of GraphNodes */
-        std::unordered_map<NodeSeqNum, GraphNode*> depGraph;
+        DepWindow depGraph;
+
+        /**
+         * Nodes removed from the depGraph, kept for reuse. The graph never
+         * holds much more than two windows of nodes, so after warming up
+         * replay does not allocate nodes at all.
+         */
+        std::vector<GraphNode*> freeNodes;
 
         /**
          * Queue of dependency-free nodes that are pending issue because
@@ -72,6 +72,13 @@ class Consumer
     virtual void print(std::ostream& out) const = 0;
     virtual void storeEventInfo(int info) {}
 
+    /**
+     * Called by a MessageBuffer registered as in-port @p port of this
+     * consumer when it goes from empty to holding messages (ready) and
+     * back. Consumers that poll all their inputs can ignore it.
+     */
+    virtual void setInPortReady(int port, bool ready) {}
+
     bool
     alreadyScheduled(Tick time)
     {
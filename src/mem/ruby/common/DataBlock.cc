@@ -40,6 +40,13 @@
 
 #include "mem/ruby/common/DataBlock.hh"
 
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
 #include "mem/ruby/common/WriteMask.hh"
 #include "mem/ruby/system/RubySystem.hh"
 
@@ -49,36 +56,155 @@ namespace gem5
 namespace ruby
 {
 
+namespace
+{
+
+/**
+ * Slab allocator for the line buffers backing DataBlocks. Buffers are
+ * carved out of cache-line aligned slabs and their reference counts are
+ * kept in a separate array, so that the line data stays aligned and
+ * densely packed. Released buffers are recycled through a free list, so
+ * the allocator is only called when the number of live lines grows.
+ * Ruby runs on a single event queue, so the pool is not thread safe.
+ */
+class LineBufferPool
+{
+  public:
+    LineBufferPool(int block_size)
+        : blockSize(block_size)
+    {
+        assert(blockSize > 0);
+        allocate(zeroData, zeroRef);
+        memset(zeroData, 0, blockSize);
+    }
+
+    /** Get an unshared buffer, with a reference count of one */
+    void
+    allocate(uint8_t *&data, uint32_t *&ref)
+    {
+        if (freeList.empty())
+            grow();
+        data = freeList.back().first;
+        ref = freeList.back().second;
+        freeList.pop_back();
+        *ref = 1;
+    }
+
+    void
+    free(uint8_t *data, uint32_t *ref)
+    {
+        assert(*ref == 0);
+        freeList.emplace_back(data, ref);
+    }
+
+    /**
+     * The line shared by all zero-filled blocks. The pool holds a
+     * reference to it, so it is never freed nor written to.
+     */
+    uint8_t *zeroData;
+    uint32_t *zeroRef;
+
+    const int blockSize;
+
+  private:
+    static constexpr int BuffersPerSlab = 1024;
+    static constexpr int SlabAlignment = 64;
+
+    void
+    grow()
+    {
+        // Slabs live until the end of the simulation
+        size_t bytes = roundUp((size_t)BuffersPerSlab * blockSize,
+                               SlabAlignment);
+        uint8_t *data = static_cast<uint8_t *>(
+            std::aligned_alloc(SlabAlignment, bytes));
+        panic_if(!data, "Failed to allocate Ruby line buffers\n");
+        uint32_t *refs = new uint32_t[BuffersPerSlab];
+        // Push in reverse so that buffers are handed out in address order
+        for (int i = BuffersPerSlab - 1; i >= 0; i--)
+            freeList.emplace_back(data + (size_t)i * blockSize, &refs[i]);
+    }
+
+    std::vector<std::pair<uint8_t *, uint32_t *>> freeList;
+};
+
+LineBufferPool &
+linePool()
+{
+    static LineBufferPool pool(RubySystem::getBlockSizeBytes());
+    assert(pool.blockSize == RubySystem::getBlockSizeBytes());
+    return pool;
+}
+
+} // anonymous namespace
+
 DataBlock::DataBlock(const DataBlock &cp)
 {
-    m_data = new uint8_t[RubySystem::getBlockSizeBytes()];
-    memcpy(m_data, cp.m_data, RubySystem::getBlockSizeBytes());
-    m_alloc = true;
+    share(cp);
 }
 
 void
 DataBlock::alloc()
 {
-    m_data = new uint8_t[RubySystem::getBlockSizeBytes()];
-    m_alloc = true;
-    clear();
+    LineBufferPool &pool = linePool();
+    m_data = pool.zeroData;
+    m_ref = pool.zeroRef;
+    ++*m_ref;
+}
+
+void
+DataBlock::share(const DataBlock &obj)
+{
+    if (obj.m_ref) {
+        m_data = obj.m_data;
+        m_ref = obj.m_ref;
+        ++*m_ref;
+    } else {
+        // External storage may change under us, so take a private copy
+        linePool().allocate(m_data, m_ref);
+        memcpy(m_data, obj.m_data, RubySystem::getBlockSizeBytes());
+    }
+}
+
+void
+DataBlock::release()
+{
+    if (m_ref && --*m_ref == 0)
+        linePool().free(m_data, m_ref);
+}
+
+void
+DataBlock::unshare()
+{
+    assert(m_ref && *m_ref > 1);
+    uint8_t *old_data = m_data;
+    --*m_ref;
+    linePool().allocate(m_data, m_ref);
+    memcpy(m_data, old_data, RubySystem::getBlockSizeBytes());
 }
 
 void
 DataBlock::clear()
 {
-    memset(m_data, 0, RubySystem::getBlockSizeBytes());
+    if (m_ref) {
+        release();
+        alloc();
+    } else {
+        memset(m_data, 0, RubySystem::getBlockSizeBytes());
+    }
 }
 
 bool
 DataBlock::equal(const DataBlock& obj) const
 {
-    return !memcmp(m_data, obj.m_data, RubySystem::getBlockSizeBytes());
+    return m_data == obj.m_data ||
+        !memcmp(m_data, obj.m_data, RubySystem::getBlockSizeBytes());
 }
 
 void
 DataBlock::copyPartial(const DataBlock &dblk, const WriteMask &mask)
 {
+    makeWritable();
     for (int i = 0; i < RubySystem::getBlockSizeBytes(); i++) {
         if (mask.getMask(i, 1)) {
             m_data[i] = dblk.m_data[i];
@@ -89,6 +215,7 @@ DataBlock::copyPartial(const DataBlock &dblk, const WriteMask &mask)
 void
 DataBlock::atomicPartial(const DataBlock &dblk, const WriteMask &mask)
 {
+    makeWritable();
     for (int i = 0; i < RubySystem::getBlockSizeBytes(); i++) {
         m_data[i] = dblk.m_data[i];
     }
@@ -117,12 +244,14 @@ DataBlock::getData(int offset, int len) const
 uint8_t*
 DataBlock::getDataMod(int offset)
 {
+    makeWritable();
     return &m_data[offset];
 }
 
 void
 DataBlock::setData(const uint8_t *data, int offset, int len)
 {
+    makeWritable();
     memcpy(&m_data[offset], data, len);
 }
 
@@ -131,13 +260,23 @@ DataBlock::setData(PacketPtr pkt)
 {
     int offset = getOffset(pkt->getAddr());
     assert(offset + pkt->getSize() <= RubySystem::getBlockSizeBytes());
+    makeWritable();
     pkt->writeData(&m_data[offset]);
 }
 
 DataBlock &
 DataBlock::operator=(const DataBlock & obj)
 {
-    memcpy(m_data, obj.m_data, RubySystem::getBlockSizeBytes());
+    if (m_data == obj.m_data)
+        return *this;
+
+    if (m_ref) {
+        release();
+        share(obj);
+    } else {
+        // Write through to the external storage
+        memcpy(m_data, obj.m_data, RubySystem::getBlockSizeBytes());
+    }
     return *this;
 }
 
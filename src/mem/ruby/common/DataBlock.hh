@@ -57,6 +57,19 @@ namespace ruby
 
 class WriteMask;
 
+/**
+ * A cache line worth of data. Line buffers are reference counted and
+ * shared copy-on-write: copying a DataBlock (e.g. from a cache entry into
+ * a message or TBE) only takes a reference to the same buffer, and the
+ * buffer is duplicated the first time one of its users modifies it.
+ * Buffers are cache-line aligned and come from a slab allocator that
+ * recycles them, and default constructed blocks all share a single
+ * zero-filled line.
+ *
+ * A block can alternatively wrap external storage through assign(), in
+ * which case it is never shared and assignments write through to that
+ * storage.
+ */
 class DataBlock
 {
   public:
@@ -69,8 +82,7 @@ class DataBlock
 
     ~DataBlock()
     {
-        if (m_alloc)
-            delete [] m_data;
+        release();
     }
 
     DataBlock& operator=(const DataBlock& obj);
@@ -92,19 +104,31 @@ class DataBlock
 
   private:
     void alloc();
+    void share(const DataBlock &obj);
+    void release();
+    void unshare();
+
+    // Must be called before modifying m_data
+    void
+    makeWritable()
+    {
+        if (m_ref && *m_ref > 1)
+            unshare();
+    }
+
     uint8_t *m_data;
-    bool m_alloc;
+    // Reference count of the pooled buffer m_data points to, or nullptr
+    // if m_data is external storage set through assign()
+    uint32_t *m_ref;
 };
 
 inline void
 DataBlock::assign(uint8_t *data)
 {
     assert(data != NULL);
-    if (m_alloc) {
-        delete [] m_data;
-    }
+    release();
     m_data = data;
-    m_alloc = false;
+    m_ref = nullptr;
 }
 
 inline uint8_t
@@ -116,6 +140,7 @@ DataBlock::getByte(int whichByte) const
 inline void
 DataBlock::setByte(int whichByte, uint8_t data)
 {
+    makeWritable();
     m_data[whichByte] = data;
 }
 
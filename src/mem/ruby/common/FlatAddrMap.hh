@@ -0,0 +1,396 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_COMMON_FLATADDRMAP_HH__
+#define __MEM_RUBY_COMMON_FLATADDRMAP_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+/**
+ * Open-addressed map from (line) addresses to values.
+ *
+ * Values live in a pool allocated up front for the expected number of
+ * entries, and are constructed in place on insertion and destroyed on
+ * erase, so inserting and removing entries doesn't touch the allocator
+ * as long as the expected number isn't exceeded. The index pointing at
+ * them only holds a key and a pointer per slot, and has twice as many
+ * slots as the pool has values to keep probe chains short. If more
+ * entries are inserted, the pool gets another chunk and the index is
+ * rebuilt twice as large. Values never move once inserted: pointers and
+ * references to a value stay valid until that value is erased, as they
+ * do with std::unordered_map. Iterators are invalidated by insertions
+ * which grow the map.
+ *
+ * Collisions are resolved by linear probing. Erased slots become
+ * tombstones only when needed to keep a probe chain intact; they are
+ * turned back into empty slots as soon as the chain behind them ends,
+ * and are reused by later insertions.
+ *
+ * The interface mirrors the subset of std::unordered_map used by Ruby
+ * (find, operator[], emplace, erase, iteration over key/value pairs).
+ */
+template <class VALUE>
+class FlatAddrMap
+{
+  public:
+    typedef Addr key_type;
+    typedef VALUE mapped_type;
+    typedef std::pair<const Addr, VALUE> value_type;
+
+  private:
+    enum SlotState : uint8_t
+    {
+        Empty,
+        Full,
+        Deleted
+    };
+
+    struct Storage
+    {
+        alignas(value_type) unsigned char bytes[sizeof(value_type)];
+    };
+
+    /** Keys and slot states are kept apart from values for fast probing */
+    std::vector<Addr> keys;
+    std::vector<SlotState> states;
+    std::vector<value_type *> slots;
+
+    /** The chunks of the value pool and the storage not in use */
+    std::vector<std::unique_ptr<Storage[]>> chunks;
+    std::vector<Storage *> freeValues;
+    size_t poolSize;
+
+    size_t mask;
+    int hashShift;
+    size_t numEntries;
+
+    value_type *slotValue(size_t idx) const { return slots[idx]; }
+
+    size_t
+    home(Addr addr) const
+    {
+        // Fibonacci hashing spreads line addresses, whose low order bits
+        // are all zero, over the whole table.
+        return (addr * 0x9E3779B97F4A7C15ULL) >> hashShift;
+    }
+
+    /** Index of the slot holding addr, or numSlots() if not present */
+    size_t
+    lookup(Addr addr) const
+    {
+        size_t idx = home(addr);
+        for (size_t probes = 0; probes <= mask; ++probes) {
+            if (states[idx] == Empty)
+                break;
+            if (states[idx] == Full && keys[idx] == addr)
+                return idx;
+            idx = (idx + 1) & mask;
+        }
+        return numSlots();
+    }
+
+    /** Add a chunk of num_values values to the pool */
+    void
+    addChunk(size_t num_values)
+    {
+        chunks.emplace_back(new Storage[num_values]);
+        Storage *chunk = chunks.back().get();
+        // Hand out the storage in address order.
+        for (size_t i = num_values; i > 0; --i)
+            freeValues.push_back(&chunk[i - 1]);
+        poolSize += num_values;
+    }
+
+    /** Size the index for num_slots slots, reinserting all the entries */
+    void
+    resizeIndex(size_t num_slots)
+    {
+        std::vector<Addr> old_keys(num_slots);
+        std::vector<SlotState> old_states(num_slots, Empty);
+        std::vector<value_type *> old_slots(num_slots, nullptr);
+        keys.swap(old_keys);
+        states.swap(old_states);
+        slots.swap(old_slots);
+        mask = num_slots - 1;
+        hashShift = 64 - floorLog2(num_slots);
+
+        for (size_t old = 0; old < old_states.size(); ++old) {
+            if (old_states[old] != Full)
+                continue;
+            size_t idx = home(old_keys[old]);
+            while (states[idx] != Empty)
+                idx = (idx + 1) & mask;
+            keys[idx] = old_keys[old];
+            states[idx] = Full;
+            slots[idx] = old_slots[old];
+        }
+    }
+
+    /**
+     * Find the slot for addr, inserting a value constructed from args if
+     * it is not present. Returns the slot index and whether an insertion
+     * took place.
+     */
+    template <typename... Args>
+    std::pair<size_t, bool>
+    findOrInsert(Addr addr, Args&&... args)
+    {
+        size_t idx = lookup(addr);
+        if (idx != numSlots())
+            return std::make_pair(idx, false);
+
+        if (freeValues.empty()) {
+            // Out of preallocated values: double the pool, and the index
+            // with it so it stays at most half full.
+            addChunk(poolSize);
+            resizeIndex(2 * numSlots());
+        }
+
+        idx = home(addr);
+        while (states[idx] == Full)
+            idx = (idx + 1) & mask;
+
+        Storage *storage = freeValues.back();
+        value_type *value = new (storage->bytes) value_type(
+            std::piecewise_construct, std::forward_as_tuple(addr),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        freeValues.pop_back();
+
+        keys[idx] = addr;
+        states[idx] = Full;
+        slots[idx] = std::launder(value);
+        ++numEntries;
+        return std::make_pair(idx, true);
+    }
+
+    void
+    eraseSlot(size_t idx)
+    {
+        assert(states[idx] == Full);
+        value_type *value = slots[idx];
+        value->~value_type();
+        freeValues.push_back(reinterpret_cast<Storage *>(value));
+        slots[idx] = nullptr;
+        --numEntries;
+
+        // A tombstone is only needed if a probe chain continues past
+        // this slot. Otherwise this slot, and any tombstones right before
+        // it, can go back to being empty.
+        if (states[(idx + 1) & mask] != Empty) {
+            states[idx] = Deleted;
+            return;
+        }
+        states[idx] = Empty;
+        idx = (idx - 1) & mask;
+        while (states[idx] == Deleted) {
+            states[idx] = Empty;
+            idx = (idx - 1) & mask;
+        }
+    }
+
+  public:
+    template <bool IsConst>
+    class IteratorBase
+    {
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename FlatAddrMap::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<IsConst, const value_type *,
+                                          value_type *>::type pointer;
+        typedef typename std::conditional<IsConst, const value_type &,
+                                          value_type &>::type reference;
+
+        IteratorBase() : map(nullptr), idx(0) {}
+        IteratorBase(const FlatAddrMap *_map, size_t _idx)
+            : map(_map), idx(_idx)
+        {
+            skipFree();
+        }
+
+        /** Allow conversion from iterator to const_iterator */
+        template <bool C = IsConst, typename = std::enable_if_t<C>>
+        IteratorBase(const IteratorBase<false> &other)
+            : map(other.map), idx(other.idx)
+        {}
+
+        reference operator*() const { return *map->slotValue(idx); }
+        pointer operator->() const { return map->slotValue(idx); }
+
+        IteratorBase &
+        operator++()
+        {
+            ++idx;
+            skipFree();
+            return *this;
+        }
+
+        IteratorBase
+        operator++(int)
+        {
+            IteratorBase tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool
+        operator==(const IteratorBase &other) const
+        {
+            return idx == other.idx;
+        }
+
+        bool
+        operator!=(const IteratorBase &other) const
+        {
+            return idx != other.idx;
+        }
+
+      private:
+        friend class FlatAddrMap;
+        friend class IteratorBase<!IsConst>;
+
+        void
+        skipFree()
+        {
+            while (idx < map->numSlots() && map->states[idx] != Full)
+                ++idx;
+        }
+
+        const FlatAddrMap *map;
+        size_t idx;
+    };
+
+    typedef IteratorBase<false> iterator;
+    typedef IteratorBase<true> const_iterator;
+
+    /**
+     * @param capacity Expected maximum number of live entries. The value
+     *        pool is preallocated for that many, and the index is sized
+     *        to at least twice that, rounded up to a power of two.
+     */
+    explicit FlatAddrMap(size_t capacity)
+        : poolSize(0), mask(0), hashShift(0), numEntries(0)
+    {
+        capacity = std::max<size_t>(4, capacity);
+        addChunk(capacity);
+        resizeIndex(size_t(1) << ceilLog2(2 * capacity));
+    }
+
+    ~FlatAddrMap()
+    {
+        clear();
+    }
+
+    FlatAddrMap(const FlatAddrMap &) = delete;
+    FlatAddrMap &operator=(const FlatAddrMap &) = delete;
+
+    size_t size() const { return numEntries; }
+    bool empty() const { return numEntries == 0; }
+    size_t numSlots() const { return keys.size(); }
+    /** Number of values storage is allocated for */
+    size_t capacity() const { return poolSize; }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, numSlots()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, numSlots()); }
+
+    iterator find(Addr addr) { return iterator(this, lookup(addr)); }
+
+    const_iterator
+    find(Addr addr) const
+    {
+        return const_iterator(this, lookup(addr));
+    }
+
+    size_t count(Addr addr) const { return lookup(addr) != numSlots(); }
+
+    /** Return the value at addr, default constructing it if needed */
+    VALUE &
+    operator[](Addr addr)
+    {
+        return slotValue(findOrInsert(addr).first)->second;
+    }
+
+    /** Construct a value for addr in place unless one is present */
+    template <typename... Args>
+    std::pair<iterator, bool>
+    emplace(Addr addr, Args&&... args)
+    {
+        auto res = findOrInsert(addr, std::forward<Args>(args)...);
+        return std::make_pair(iterator(this, res.first), res.second);
+    }
+
+    void
+    erase(iterator it)
+    {
+        assert(it.map == this && it.idx < numSlots());
+        eraseSlot(it.idx);
+    }
+
+    size_t
+    erase(Addr addr)
+    {
+        size_t idx = lookup(addr);
+        if (idx == numSlots())
+            return 0;
+        eraseSlot(idx);
+        return 1;
+    }
+
+    void
+    clear()
+    {
+        for (size_t idx = 0; idx < numSlots(); ++idx) {
+            if (states[idx] == Full)
+                eraseSlot(idx);
+        }
+        std::fill(states.begin(), states.end(), Empty);
+        numEntries = 0;
+    }
+};
+
+} // namespace ruby
+} // namespace gem5
+
+#endif // __MEM_RUBY_COMMON_FLATADDRMAP_HH__
@@ -0,0 +1,215 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <random>
+
+#include "mem/ruby/common/FlatAddrMap.hh"
+
+using namespace gem5;
+using namespace gem5::ruby;
+
+namespace
+{
+
+/** Counts live instances to check values are constructed and destroyed */
+struct Tracked
+{
+    static int live;
+    int val;
+
+    Tracked() : val(0) { ++live; }
+    explicit Tracked(int v) : val(v) { ++live; }
+    Tracked(const Tracked &other) = delete;
+    ~Tracked() { --live; }
+};
+
+int Tracked::live = 0;
+
+} // anonymous namespace
+
+/** Inserting, finding and erasing single entries */
+TEST(FlatAddrMapTest, InsertFindErase)
+{
+    FlatAddrMap<int> map(8);
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(0x40), map.end());
+
+    auto res = map.emplace(0x40, 1);
+    EXPECT_TRUE(res.second);
+    EXPECT_EQ(res.first->first, 0x40);
+    EXPECT_EQ(res.first->second, 1);
+
+    res = map.emplace(0x40, 2);
+    EXPECT_FALSE(res.second);
+    EXPECT_EQ(res.first->second, 1);
+
+    map[0x80] = 3;
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.count(0x80), 1);
+    EXPECT_EQ(map.find(0x80)->second, 3);
+
+    EXPECT_EQ(map.erase(0x40), 1);
+    EXPECT_EQ(map.erase(0x40), 0);
+    EXPECT_EQ(map.count(0x40), 0);
+    map.erase(map.find(0x80));
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.begin(), map.end());
+}
+
+/** The value pool and the index are sized from the expected capacity */
+TEST(FlatAddrMapTest, Sizing)
+{
+    FlatAddrMap<int> map(100);
+    EXPECT_EQ(map.capacity(), 100);
+    EXPECT_EQ(map.numSlots(), 256);
+}
+
+/** Inserting past the capacity grows the map and keeps values in place */
+TEST(FlatAddrMapTest, Growth)
+{
+    FlatAddrMap<int> map(4);
+    std::vector<int *> refs;
+    for (int i = 0; i < 100; ++i) {
+        auto res = map.emplace(Addr(i) << 6, i);
+        ASSERT_TRUE(res.second);
+        refs.push_back(&res.first->second);
+    }
+
+    EXPECT_EQ(map.size(), 100);
+    EXPECT_GE(map.capacity(), 100);
+    EXPECT_GE(map.numSlots(), 2 * map.capacity());
+    for (int i = 0; i < 100; ++i) {
+        auto it = map.find(Addr(i) << 6);
+        ASSERT_NE(it, map.end());
+        EXPECT_EQ(it->second, i);
+        EXPECT_EQ(&it->second, refs[i]);
+    }
+}
+
+/** Erased storage is reused instead of growing the map */
+TEST(FlatAddrMapTest, Reuse)
+{
+    FlatAddrMap<int> map(16);
+    const size_t slots = map.numSlots();
+    for (int round = 0; round < 1000; ++round) {
+        for (int i = 0; i < 16; ++i)
+            map.emplace(Addr(round * 16 + i) << 6, i);
+        EXPECT_EQ(map.size(), 16);
+        for (int i = 0; i < 16; ++i)
+            EXPECT_EQ(map.erase(Addr(round * 16 + i) << 6), 1);
+    }
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.capacity(), 16);
+    EXPECT_EQ(map.numSlots(), slots);
+}
+
+/** Values are constructed in place and destroyed on erase and clear */
+TEST(FlatAddrMapTest, Lifetime)
+{
+    Tracked::live = 0;
+    {
+        FlatAddrMap<Tracked> map(4);
+        for (int i = 0; i < 10; ++i)
+            map.emplace(Addr(i) << 6, i);
+        EXPECT_EQ(Tracked::live, 10);
+        map.erase(Addr(3) << 6);
+        EXPECT_EQ(Tracked::live, 9);
+        map[Addr(3) << 6].val = 3;
+        EXPECT_EQ(Tracked::live, 10);
+        map.clear();
+        EXPECT_EQ(Tracked::live, 0);
+        EXPECT_TRUE(map.empty());
+        for (int i = 0; i < 5; ++i)
+            map.emplace(Addr(i) << 6, i);
+        EXPECT_EQ(Tracked::live, 5);
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+/** Iteration visits every entry once, and erasing while iterating works */
+TEST(FlatAddrMapTest, Iteration)
+{
+    FlatAddrMap<int> map(32);
+    for (int i = 0; i < 32; ++i)
+        map[Addr(i) << 6] = i;
+
+    int sum = 0;
+    for (const auto &entry : map) {
+        EXPECT_EQ(entry.first, Addr(entry.second) << 6);
+        sum += entry.second;
+    }
+    EXPECT_EQ(sum, 31 * 32 / 2);
+
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        if (it->second % 2)
+            map.erase(it);
+    }
+    EXPECT_EQ(map.size(), 16);
+    for (const auto &entry : map)
+        EXPECT_EQ(entry.second % 2, 0);
+}
+
+/** Random operations give the same results as a std::map */
+TEST(FlatAddrMapTest, MatchesStdMap)
+{
+    std::mt19937_64 rng(1);
+    FlatAddrMap<uint64_t> map(8);
+    std::map<Addr, uint64_t> ref;
+
+    for (int i = 0; i < 100000; ++i) {
+        // Keep the key range small so probe chains collide and erase
+        // leaves tombstones behind.
+        Addr addr = (rng() % 64) << 6;
+        switch (rng() % 3) {
+          case 0:
+            map[addr] = i;
+            ref[addr] = i;
+            break;
+          case 1:
+            EXPECT_EQ(map.erase(addr), ref.erase(addr));
+            break;
+          default:
+            {
+                auto it = map.find(addr);
+                auto ref_it = ref.find(addr);
+                ASSERT_EQ(it == map.end(), ref_it == ref.end());
+                if (it != map.end())
+                    EXPECT_EQ(it->second, ref_it->second);
+            }
+        }
+        ASSERT_EQ(map.size(), ref.size());
+    }
+
+    size_t visited = 0;
+    for (const auto &entry : map) {
+        EXPECT_EQ(ref.at(entry.first), entry.second);
+        ++visited;
+    }
+    EXPECT_EQ(visited, ref.size());
+}
@@ -86,6 +86,8 @@ MessageBuffer::MessageBuffer(const Params &p)
 {
     m_msg_counter = 0;
     m_consumer = NULL;
+    m_consumer_in_port = -1;
+    m_in_port_ready = false;
     m_size_last_time_size_checked = 0;
     m_size_at_cycle_start = 0;
     m_stalled_at_cycle_start = 0;
@@ -293,6 +295,7 @@ MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
     assert(m_consumer != NULL);
     m_consumer->scheduleEventAbsolute(arrival_time);
     m_consumer->storeEventInfo(m_vnet_id);
+    updateInPortReady();
 }
 
 Tick
@@ -320,6 +323,7 @@ MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
 
     pop_heap(m_prio_heap.begin(), m_prio_heap.end(), std::greater<MsgPtr>());
     m_prio_heap.pop_back();
+    updateInPortReady();
     if (decrement_messages) {
         // Record how much time is passed since the message was enqueued
         m_stall_time += curTick() - message->getLastEnqueueTime();
@@ -354,6 +358,7 @@ void
 MessageBuffer::clear()
 {
     m_prio_heap.clear();
+    updateInPortReady();
 
     m_msg_counter = 0;
     m_time_last_time_enqueue = 0;
@@ -397,6 +402,7 @@ MessageBuffer::reanalyzeList(std::list<MsgPtr> &lt, Tick schdTick)
 
         lt.pop_front();
     }
+    updateInPortReady();
 }
 
 void
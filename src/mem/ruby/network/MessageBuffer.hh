@@ -115,6 +115,21 @@ class MessageBuffer : public SimObject
 
     Consumer* getConsumer() { return m_consumer; }
 
+    /**
+     * Identify this buffer as in-port @p port of its consumer. The consumer
+     * is then notified through Consumer::setInPortReady whenever the buffer
+     * becomes non-empty or is drained, e.g. by enqueues, dequeues, stalls
+     * and reanalysis of stalled messages.
+     */
+    void
+    setConsumerInPort(int port)
+    {
+        assert(m_consumer != NULL);
+        m_consumer_in_port = port;
+        m_in_port_ready = !m_prio_heap.empty();
+        m_consumer->setInPortReady(m_consumer_in_port, m_in_port_ready);
+    }
+
     bool getOrdered() { return m_strict_fifo; }
 
     //! Function for extracting the message at the head of the
@@ -195,6 +210,17 @@ class MessageBuffer : public SimObject
   private:
     void reanalyzeList(std::list<MsgPtr> &, Tick);
 
+    // Notify the consumer if the buffer became empty or non-empty
+    void
+    updateInPortReady()
+    {
+        bool ready = !m_prio_heap.empty();
+        if (m_consumer_in_port >= 0 && ready != m_in_port_ready) {
+            m_in_port_ready = ready;
+            m_consumer->setInPortReady(m_consumer_in_port, ready);
+        }
+    }
+
     uint32_t functionalAccess(Packet *pkt, bool is_read, WriteMask *mask);
 
   private:
@@ -203,6 +229,11 @@ class MessageBuffer : public SimObject
     Consumer* m_consumer;
     std::vector<MsgPtr> m_prio_heap;
 
+    //! In-port index of this buffer at its consumer, -1 if not tracked
+    int m_consumer_in_port;
+    //! Last readiness reported to the consumer
+    bool m_in_port_ready;
+
     std::function<void()> m_dequeue_callback;
 
     // use a std::map for the stalled messages as this container is
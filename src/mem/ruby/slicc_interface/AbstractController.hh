@@ -104,6 +104,7 @@ class AbstractController : public ClockedObject, public Consumer
 
     virtual void print(std::ostream & out) const = 0;
     virtual void wakeup() = 0;
+
     virtual void resetStats() = 0;
     virtual void regStats();
 
@@ -170,6 +171,23 @@ class AbstractController : public ClockedObject, public Consumer
 
     const AddrRangeList &getAddrRanges() const { return addrRanges; }
 
+    void
+    setInPortReady(int port, bool ready) override
+    {
+        assert(port >= 0 && port < 64);
+        if (ready)
+            m_ready_in_ports |= (1ULL << port);
+        else
+            m_ready_in_ports &= ~(1ULL << port);
+    }
+
+    //! True if the buffer feeding in-port @p port holds any messages
+    bool
+    isInPortReady(int port) const
+    {
+        return (m_ready_in_ports >> port) & 1;
+    }
+
   public:
     MachineID getMachineID() const { return m_machineID; }
     RequestorID getRequestorId() const { return m_id; }
@@ -358,6 +376,13 @@ class AbstractController : public ClockedObject, public Consumer
 
     unsigned int m_in_ports;
     unsigned int m_cur_in_port;
+
+    /**
+     * Bit i is set while the MessageBuffer registered as in-port i holds
+     * messages (see MessageBuffer::setConsumerInPort). The generated
+     * wakeup() only evaluates in_ports whose buffer bit is set.
+     */
+    uint64_t m_ready_in_ports;
     const int m_number_of_TBEs;
     const int m_transitions_per_cycle;
     const unsigned int m_buffer_size;
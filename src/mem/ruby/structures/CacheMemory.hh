@@ -178,9 +178,14 @@ class CacheMemory : public SimObject
 
     // The first index is the # of cache lines.
     // The second index is the the amount associativity.
-    std::unordered_map<Addr, int> m_tag_index;
     std::vector<std::vector<AbstractCacheEntry*> > m_cache;
 
+    // Line address held by each way, indexed by set * assoc + way, or
+    // MaxAddr if the way is unused. Tags are packed so that a lookup only
+    // scans the contiguous tags of one set rather than probing a global
+    // hash and then dereferencing the entry.
+    std::vector<Addr> m_tags;
+
     /** We use the replacement policies from the Classic memory system. */
     replacement_policy::Base *m_replacementPolicy_ptr;
 
@@ -42,9 +42,9 @@
 #define __MEM_RUBY_STRUCTURES_TBETABLE_HH__
 
 #include <iostream>
-#include <unordered_map>
 
 #include "mem/ruby/common/Address.hh"
+#include "mem/ruby/common/FlatAddrMap.hh"
 
 namespace gem5
 {
@@ -57,7 +57,7 @@ class TBETable
 {
   public:
     TBETable(int number_of_TBEs)
-        : m_number_of_TBEs(number_of_TBEs)
+        : m_map(number_of_TBEs), m_number_of_TBEs(number_of_TBEs)
     {
     }
 
@@ -82,7 +82,9 @@ class TBETable
     TBETable& operator=(const TBETable& obj);
 
     // Data Members (m_prefix)
-    std::unordered_map<Addr, ENTRY> m_map;
+    // TBEs are constructed in place in a table sized for m_number_of_TBEs,
+    // so allocating and deallocating them does not touch the heap
+    FlatAddrMap<ENTRY> m_map;
 
   private:
     int m_number_of_TBEs;
@@ -112,7 +114,7 @@ TBETable<ENTRY>::allocate(Addr address)
 {
     assert(!isPresent(address));
     assert(m_map.size() < m_number_of_TBEs);
-    m_map[address] = ENTRY();
+    m_map.emplace(address);
 }
 
 template<class ENTRY>
@@ -136,8 +138,10 @@ template<class ENTRY>
 inline ENTRY*
 TBETable<ENTRY>::lookup(Addr address)
 {
-  if (m_map.find(address) != m_map.end()) return &(m_map.find(address)->second);
-  return NULL;
+    auto it = m_map.find(address);
+    if (it != m_map.end())
+        return &(it->second);
+    return NULL;
 }
 
 
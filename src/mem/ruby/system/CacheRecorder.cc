@@ -29,6 +29,8 @@
 
 #include "mem/ruby/system/CacheRecorder.hh"
 
+#include <algorithm>
+
 #include "debug/RubyCacheTrace.hh"
 #include "mem/ruby/system/RubySystem.hh"
 #include "mem/ruby/system/Sequencer.hh"
@@ -50,18 +52,22 @@ TraceRecord::print(std::ostream& out) const
 CacheRecorder::CacheRecorder()
     : m_uncompressed_trace(NULL),
       m_uncompressed_trace_size(0),
-      m_block_size_bytes(RubySystem::getBlockSizeBytes())
+      m_block_size_bytes(RubySystem::getBlockSizeBytes()),
+      m_max_outstanding(1), m_outstanding(0), m_rec_bytes_issued(0)
 {
 }
 
 CacheRecorder::CacheRecorder(uint8_t* uncompressed_trace,
                              uint64_t uncompressed_trace_size,
                              std::vector<Sequencer*>& seq_map,
-                             uint64_t block_size_bytes)
+                             uint64_t block_size_bytes,
+                             unsigned max_outstanding)
     : m_uncompressed_trace(uncompressed_trace),
       m_uncompressed_trace_size(uncompressed_trace_size),
       m_seq_map(seq_map),  m_bytes_read(0), m_records_read(0),
-      m_records_flushed(0), m_block_size_bytes(block_size_bytes)
+      m_records_flushed(0), m_block_size_bytes(block_size_bytes),
+      m_max_outstanding(std::max(max_outstanding, 1u)), m_outstanding(0),
+      m_rec_bytes_issued(0)
 {
     if (m_uncompressed_trace != NULL) {
         if (m_block_size_bytes < RubySystem::getBlockSizeBytes()) {
@@ -108,14 +114,23 @@ CacheRecorder::enqueueNextFlushRequest()
 void
 CacheRecorder::enqueueNextFetchRequest()
 {
-    if (m_bytes_read < m_uncompressed_trace_size) {
+    while (m_bytes_read < m_uncompressed_trace_size &&
+           m_outstanding < m_max_outstanding) {
         TraceRecord* traceRecord = (TraceRecord*) (m_uncompressed_trace +
                                                                 m_bytes_read);
+        Addr line_addr = traceRecord->m_data_address;
 
-        DPRINTF(RubyCacheTrace, "Issuing %s\n", *traceRecord);
+        // Keep accesses to a line in trace order: wait for the earlier
+        // record to this line to complete before issuing the next one.
+        if (m_rec_bytes_issued == 0) {
+            if (m_lines_in_flight.count(line_addr))
+                return;
+            DPRINTF(RubyCacheTrace, "Issuing %s\n", *traceRecord);
+        }
 
-        for (int rec_bytes_read = 0; rec_bytes_read < m_block_size_bytes;
-                rec_bytes_read += RubySystem::getBlockSizeBytes()) {
+        while (m_rec_bytes_issued < m_block_size_bytes &&
+               m_outstanding < m_max_outstanding) {
+            uint64_t rec_bytes_read = m_rec_bytes_issued;
             RequestPtr req;
             MemCmd::Command requestType;
 
@@ -144,16 +159,49 @@ CacheRecorder::enqueueNextFetchRequest()
 
             Sequencer* m_sequencer_ptr = m_seq_map[traceRecord->m_cntrl_id];
             assert(m_sequencer_ptr != NULL);
-            m_sequencer_ptr->makeRequest(pkt);
+            if (m_sequencer_ptr->makeRequest(pkt) != RequestStatus_Issued) {
+                // The sequencer is full; retry once one of our requests
+                // has completed.
+                delete pkt;
+                panic_if(m_outstanding == 0,
+                         "Sequencer rejected cache warmup request for %#x\n",
+                         traceRecord->m_data_address + rec_bytes_read);
+                return;
+            }
+
+            m_outstanding++;
+            m_lines_in_flight[line_addr]++;
+            m_rec_bytes_issued += RubySystem::getBlockSizeBytes();
         }
 
+        if (m_rec_bytes_issued < m_block_size_bytes)
+            return;
+
+        m_rec_bytes_issued = 0;
         m_bytes_read += (sizeof(TraceRecord) + m_block_size_bytes);
         m_records_read++;
-    } else {
+    }
+
+    if (m_bytes_read >= m_uncompressed_trace_size && m_outstanding == 0) {
         DPRINTF(RubyCacheTrace, "Fetched all %d records\n", m_records_read);
     }
 }
 
+void
+CacheRecorder::fetchRequestComplete(Addr addr)
+{
+    Addr line_addr = addr & ~(Addr(m_block_size_bytes) - 1);
+    auto it = m_lines_in_flight.find(line_addr);
+    assert(it != m_lines_in_flight.end());
+    assert(m_outstanding > 0);
+
+    if (--it->second == 0)
+        m_lines_in_flight.erase(it);
+    m_outstanding--;
+
+    enqueueNextFetchRequest();
+}
+
 void
 CacheRecorder::addRecord(int cntrl, Addr data_addr, Addr pc_addr,
                          RubyRequestType type, Tick time, DataBlock& data)
@@ -180,21 +228,20 @@ CacheRecorder::aggregateRecords(uint8_t **buf, uint64_t total_size)
     uint64_t current_size = 0;
     int record_size = sizeof(TraceRecord) + m_block_size_bytes;
 
-    for (int i = 0; i < size; ++i) {
-        // Determine if we need to expand the buffer size
-        if (current_size + record_size > total_size) {
-            uint8_t* new_buf = new (std::nothrow) uint8_t[total_size * 2];
-            if (new_buf == NULL) {
-                fatal("Unable to allocate buffer of size %s\n",
-                      total_size * 2);
-            }
-            total_size = total_size * 2;
-            uint8_t* old_buf = *buf;
-            memcpy(new_buf, old_buf, current_size);
-            *buf = new_buf;
-            delete [] old_buf;
+    // Size the buffer for the whole trace up front rather than growing it
+    // (and copying it) repeatedly while aggregating.
+    uint64_t needed_size = uint64_t(size) * record_size;
+    if (needed_size > total_size) {
+        uint8_t* new_buf = new (std::nothrow) uint8_t[needed_size];
+        if (new_buf == NULL) {
+            fatal("Unable to allocate buffer of size %s\n", needed_size);
         }
+        delete [] *buf;
+        *buf = new_buf;
+        total_size = needed_size;
+    }
 
+    for (int i = 0; i < size; ++i) {
         // Copy the current record into the buffer
         memcpy(&((*buf)[current_size]), m_records[i], record_size);
         current_size += record_size;
@@ -35,6 +35,7 @@
 #ifndef __MEM_RUBY_SYSTEM_CACHERECORDER_HH__
 #define __MEM_RUBY_SYSTEM_CACHERECORDER_HH__
 
+#include <unordered_map>
 #include <vector>
 
 #include "base/types.hh"
@@ -79,7 +80,8 @@ class CacheRecorder
     CacheRecorder(uint8_t* uncompressed_trace,
                   uint64_t uncompressed_trace_size,
                   std::vector<Sequencer*>& SequencerMap,
-                  uint64_t block_size_bytes);
+                  uint64_t block_size_bytes,
+                  unsigned max_outstanding = 1);
     void addRecord(int cntrl, Addr data_addr, Addr pc_addr,
                    RubyRequestType type, Tick time, DataBlock& data);
 
@@ -98,12 +100,21 @@ class CacheRecorder
     /*!
      * Function for fetching warming up the memory and the caches. It goes
      * through the recorded contents of the caches, as available in the
-     * checkpoint and issues fetch requests. Except for the first one, a
-     * fetch request is issued only after the previous one has completed.
-     * It should be possible to use this with any protocol.
+     * checkpoint and issues fetch requests. Up to max_outstanding requests
+     * are kept in flight at once. Records are always issued in trace
+     * order, and a record is held back while an earlier record for the
+     * same line is still outstanding, so that every line sees its
+     * accesses in the same order as a one-at-a-time replay. It should be
+     * possible to use this with any protocol.
      */
     void enqueueNextFetchRequest();
 
+    /*!
+     * Called by the sequencer when a warmup request for addr has
+     * completed. Retires the request and issues further fetches.
+     */
+    void fetchRequestComplete(Addr addr);
+
   private:
     // Private copy constructor and assignment operator
     CacheRecorder(const CacheRecorder& obj);
@@ -117,6 +128,18 @@ class CacheRecorder
     uint64_t m_records_read;
     uint64_t m_records_flushed;
     uint64_t m_block_size_bytes;
+
+    /** Limit on warmup requests in flight across all sequencers. */
+    unsigned m_max_outstanding;
+    /** Warmup requests currently in flight. */
+    unsigned m_outstanding;
+    /**
+     * Sub-block of the current record to issue next, for traces recorded
+     * with a larger block size than the current one.
+     */
+    uint64_t m_rec_bytes_issued;
+    /** Outstanding warmup requests per recorded line address. */
+    std::unordered_map<Addr, unsigned> m_lines_in_flight;
 };
 
 inline bool
@@ -47,6 +47,7 @@
 #include <list>
 
 #include "base/compiler.hh"
+#include "base/cprintf.hh"
 #include "base/intmath.hh"
 #include "base/statistics.hh"
 #include "debug/RubyCacheTrace.hh"
@@ -76,10 +77,18 @@ bool RubySystem::m_warmup_enabled = false;
 unsigned RubySystem::m_systems_to_warmup = 0;
 bool RubySystem::m_cooldown_enabled = false;
 
+// zlib's default 8KiB stream buffer makes trace I/O syscall bound for
+// multi-gigabyte cache traces.
+static const unsigned TraceIOBufferSize = 1 << 20;
+
 RubySystem::RubySystem(const Params &p)
     : ClockedObject(p), m_access_backing_store(p.access_backing_store),
+      m_warmup_max_outstanding(p.warmup_max_outstanding),
+      m_cache_trace_compression(p.cache_trace_compression),
       m_cache_recorder(NULL)
 {
+    fatal_if(m_cache_trace_compression > 9,
+             "cache_trace_compression must be a zlib level (0-9)\n");
     m_randomization = p.randomization;
 
     m_block_size_bytes = p.block_size_bytes;
@@ -202,7 +211,8 @@ RubySystem::makeCacheRecorder(uint8_t *uncompressed_trace,
 
     // Create the CacheRecorder and record the cache trace
     m_cache_recorder = new CacheRecorder(uncompressed_trace, cache_trace_size,
-                                         sequencer_map, block_size_bytes);
+                                         sequencer_map, block_size_bytes,
+                                         m_warmup_max_outstanding);
 }
 
 void
@@ -280,7 +290,8 @@ RubySystem::memWriteback()
 
 void
 RubySystem::writeCompressedTrace(uint8_t *raw_data, std::string filename,
-                                 uint64_t uncompressed_trace_size)
+                                 uint64_t uncompressed_trace_size,
+                                 unsigned compression_level)
 {
     // Create the checkpoint file for the memory
     std::string thefile = CheckpointIn::dir() + "/" + filename.c_str();
@@ -291,10 +302,12 @@ RubySystem::writeCompressedTrace(uint8_t *raw_data, std::string filename,
         fatal("Can't open memory trace file '%s'\n", filename);
     }
 
-    gzFile compressedMemory = gzdopen(fd, "wb");
+    std::string mode = csprintf("wb%d", compression_level);
+    gzFile compressedMemory = gzdopen(fd, mode.c_str());
     if (compressedMemory == NULL)
         fatal("Insufficient memory to allocate compression state for %s\n",
               filename);
+    gzbuffer(compressedMemory, TraceIOBufferSize);
 
     if (gzwrite(compressedMemory, raw_data, uncompressed_trace_size) !=
         uncompressed_trace_size) {
@@ -328,7 +341,8 @@ RubySystem::serialize(CheckpointOut &cp) const
     uint64_t cache_trace_size = m_cache_recorder->aggregateRecords(&raw_data,
                                                                  4096);
     std::string cache_trace_file = name() + ".cache.gz";
-    writeCompressedTrace(raw_data, cache_trace_file, cache_trace_size);
+    writeCompressedTrace(raw_data, cache_trace_file, cache_trace_size,
+                         m_cache_trace_compression);
 
     SERIALIZE_SCALAR(cache_trace_file);
     SERIALIZE_SCALAR(cache_trace_size);
@@ -364,6 +378,7 @@ RubySystem::readCompressedTrace(std::string filename, uint8_t *&raw_data,
         fatal("Insufficient memory to allocate compression state for %s\n",
               filename);
     }
+    gzbuffer(compressedTrace, TraceIOBufferSize);
 
     raw_data = new uint8_t[uncompressed_trace_size];
     if (gzread(compressedTrace, raw_data, uncompressed_trace_size) <
@@ -129,7 +129,8 @@ class RubySystem : public ClockedObject
                                     uint8_t *&raw_data,
                                     uint64_t &uncompressed_trace_size);
     static void writeCompressedTrace(uint8_t *raw_data, std::string file,
-                                     uint64_t uncompressed_trace_size);
+                                     uint64_t uncompressed_trace_size,
+                                     unsigned compression_level);
 
     void processRubyEvent();
   private:
@@ -144,6 +145,8 @@ class RubySystem : public ClockedObject
     static bool m_cooldown_enabled;
     memory::SimpleMemory *m_phys_mem;
     const bool m_access_backing_store;
+    const unsigned m_warmup_max_outstanding;
+    const unsigned m_cache_trace_compression;
 
     //std::vector<Network *> m_networks;
     std::vector<std::unique_ptr<Network>> m_networks;
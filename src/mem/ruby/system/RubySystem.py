@@ -49,6 +49,14 @@ class RubySystem(ClockedObject):
     access_backing_store = Param.Bool(False, "Use phys_mem as the functional \
         store and only use ruby for timing.")
 
+    warmup_max_outstanding = Param.Unsigned(1, "Maximum number of cache \
+        trace requests in flight while warming up the caches from a \
+        checkpoint. Requests to the same line are always replayed in \
+        trace order.")
+    cache_trace_compression = Param.Unsigned(6, "zlib compression level \
+        (0-9) of the cache trace written to checkpoints; lower levels \
+        trade checkpoint size for speed")
+
     # Profiler related configuration variables
     hot_lines = Param.Bool(False, "")
     all_instructions = Param.Bool(False, "")
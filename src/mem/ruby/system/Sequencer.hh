@@ -42,10 +42,14 @@
 #define __MEM_RUBY_SYSTEM_SEQUENCER_HH__
 
 #include <iostream>
+#include <iterator>
 #include <list>
+#include <new>
 #include <unordered_map>
+#include <utility>
 
 #include "mem/ruby/common/Address.hh"
+#include "mem/ruby/common/FlatAddrMap.hh"
 #include "mem/ruby/protocol/MachineType.hh"
 #include "mem/ruby/protocol/RubyRequestType.hh"
 #include "mem/ruby/protocol/SequencerRequestType.hh"
@@ -83,6 +87,157 @@ struct SequencerRequest
 
 std::ostream& operator<<(std::ostream& out, const SequencerRequest& obj);
 
+/**
+ * FIFO of the requests outstanding for a single line. The first few
+ * requests are stored inline, so issuing a miss does not allocate; only
+ * requests aliasing an already crowded line spill over into a list.
+ */
+class SequencerRequestList
+{
+  public:
+    static constexpr int InlineRequests = 4;
+
+    class const_iterator
+    {
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef SequencerRequest value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const SequencerRequest *pointer;
+        typedef const SequencerRequest &reference;
+
+        const_iterator(const SequencerRequestList *_list, int _idx,
+                       std::list<SequencerRequest>::const_iterator _it)
+            : list(_list), idx(_idx), it(_it)
+        {}
+
+        reference
+        operator*() const
+        {
+            return idx < list->numInline ? list->inlineAt(idx) : *it;
+        }
+
+        pointer operator->() const { return &**this; }
+
+        const_iterator &
+        operator++()
+        {
+            if (idx >= list->numInline)
+                ++it;
+            ++idx;
+            return *this;
+        }
+
+        bool
+        operator==(const const_iterator &other) const
+        {
+            return idx == other.idx;
+        }
+
+        bool
+        operator!=(const const_iterator &other) const
+        {
+            return idx != other.idx;
+        }
+
+      private:
+        const SequencerRequestList *list;
+        int idx;
+        std::list<SequencerRequest>::const_iterator it;
+    };
+
+    SequencerRequestList() : head(0), numInline(0) {}
+    ~SequencerRequestList() { clear(); }
+
+    SequencerRequestList(const SequencerRequestList &) = delete;
+    SequencerRequestList &operator=(const SequencerRequestList &) = delete;
+
+    template <typename... Args>
+    void
+    emplace_back(Args&&... args)
+    {
+        // Requests only go inline while nothing has spilled over, so the
+        // inline requests are always older than the overflow ones
+        if (overflow.empty() && numInline < InlineRequests) {
+            new (slot((head + numInline) % InlineRequests))
+                SequencerRequest(std::forward<Args>(args)...);
+            ++numInline;
+        } else {
+            overflow.emplace_back(std::forward<Args>(args)...);
+        }
+    }
+
+    SequencerRequest &
+    front()
+    {
+        assert(!empty());
+        return numInline ? inlineAt(0) : overflow.front();
+    }
+
+    void
+    pop_front()
+    {
+        assert(!empty());
+        if (numInline) {
+            inlineAt(0).~SequencerRequest();
+            head = (head + 1) % InlineRequests;
+            --numInline;
+        } else {
+            overflow.pop_front();
+        }
+    }
+
+    void
+    clear()
+    {
+        while (numInline)
+            pop_front();
+        overflow.clear();
+    }
+
+    size_t size() const { return numInline + overflow.size(); }
+    bool empty() const { return numInline == 0 && overflow.empty(); }
+
+    const_iterator
+    begin() const
+    {
+        return const_iterator(this, 0, overflow.begin());
+    }
+
+    const_iterator
+    end() const
+    {
+        return const_iterator(this, size(), overflow.end());
+    }
+
+  private:
+    void *slot(int idx) { return storage[idx].bytes; }
+
+    SequencerRequest &
+    inlineAt(int idx)
+    {
+        return *std::launder(reinterpret_cast<SequencerRequest *>(
+            slot((head + idx) % InlineRequests)));
+    }
+
+    const SequencerRequest &
+    inlineAt(int idx) const
+    {
+        return const_cast<SequencerRequestList *>(this)->inlineAt(idx);
+    }
+
+    struct Storage
+    {
+        alignas(SequencerRequest)
+            unsigned char bytes[sizeof(SequencerRequest)];
+    };
+
+    Storage storage[InlineRequests];
+    int head;
+    int numInline;
+    std::list<SequencerRequest> overflow;
+};
+
 class Sequencer : public RubyPort
 {
   public:
@@ -220,8 +375,10 @@ class Sequencer : public RubyPort
     Sequencer& operator=(const Sequencer& obj);
 
   protected:
-    // RequestTable contains both read and write requests, handles aliasing
-    std::unordered_map<Addr, std::list<SequencerRequest>> m_RequestTable;
+    // RequestTable contains both read and write requests, handles aliasing.
+    // It is sized for max_outstanding_requests lines and its entries are
+    // built in place, so tracking a miss does not allocate.
+    FlatAddrMap<SequencerRequestList> m_RequestTable;
     // UnadressedRequestTable contains "unaddressed" requests,
     // guaranteed not to alias each other
     std::unordered_map<uint64_t, SequencerRequest> m_UnaddressedRequestTable;
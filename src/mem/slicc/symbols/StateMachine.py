@@ -224,6 +224,20 @@ class StateMachine(Symbol):
                 in_msg_bufs[buf_name].append(port)
         return port_to_buf_map, in_msg_bufs, msg_bufs
 
+    def getReadyPortMap(self):
+        # Assign a bit of the controller's ready in-port mask to each
+        # distinct MessageBuffer feeding an in_port. Other in_port sources
+        # (e.g. TimerTables) and buffers beyond the width of the mask are
+        # not tracked and are always polled by wakeup().
+        ready_bits = OrderedDict()
+        for port in self.in_ports:
+            if port.pairs.get("buffer_type") != "MessageBuffer":
+                continue
+            buf_name = "m_%s_ptr" % port.pairs["buffer_expr"].name
+            if buf_name not in ready_bits and len(ready_bits) < 64:
+                ready_bits[buf_name] = len(ready_bits)
+        return ready_bits
+
     def writeCodeFiles(self, path, includes):
         self.printControllerPython(path)
         self.printControllerHH(path)
@@ -694,9 +708,12 @@ $c_ident::init()
             code('${{prefetcher.code}}.setController(this);')
 
         code()
+        ready_bits = self.getReadyPortMap()
         for port in self.in_ports:
             # Set the queue consumers
             code('${{port.code}}.setConsumer(this);')
+        for buf_name, bit in ready_bits.items():
+            code('$buf_name->setConsumerInPort($bit);')
 
         # Initialize the transition profiling
         code()
@@ -1274,6 +1291,14 @@ $c_ident::functionalReadBuffers(PacketPtr& pkt, WriteMask &mask)
             code('#include "${{include_path}}"')
 
         port_to_buf_map, in_msg_bufs, msg_bufs = self.getBufferMaps(ident)
+        ready_bits = self.getReadyPortMap()
+
+        # When every in_port is fed by a tracked buffer, a fully busy
+        # controller only needs another wakeup if some buffer still holds
+        # messages; otherwise keep polling every cycle as before.
+        all_ports_tracked = all(
+            "m_%s_ptr" % port.pairs["buffer_expr"].name in ready_bits
+            for port in self.in_ports)
 
         code('''
 namespace gem5
@@ -1298,6 +1323,20 @@ ${ident}_Controller::wakeup()
         if (counter == m_transitions_per_cycle) {
             // Count how often we are fully utilized
             stats.fullyBusyCycles++;
+''')
+        if all_ports_tracked:
+            code('''
+
+            // Wakeup in another cycle and try again, unless every in_port
+            // buffer has been drained
+            if (m_ready_in_ports != 0) {
+                scheduleEvent(Cycles(1));
+            }
+            break;
+        }
+''')
+        else:
+            code('''
 
             // Wakeup in another cycle and try again
             scheduleEvent(Cycles(1));
@@ -1313,6 +1352,11 @@ ${ident}_Controller::wakeup()
         for port in self.in_ports:
             code.indent()
             code('// ${ident}InPort $port')
+            buf_name = "m_%s_ptr" % port.pairs["buffer_expr"].name
+            if buf_name in ready_bits:
+                # Skip ports whose buffer holds no messages
+                code('if (isInPortReady(${{ready_bits[buf_name]}})) {')
+                code.indent()
             if "rank" in port.pairs:
                 code('m_cur_in_port = ${{port.pairs["rank"]}};')
             else:
@@ -1329,6 +1373,9 @@ ${ident}_Controller::wakeup()
                 rejected[${{port_to_buf_map[port]}}]++;
             }
 ''')
+            if buf_name in ready_bits:
+                code.dedent()
+                code('}')
             code.dedent()
             code('')
 
@@ -43,10 +43,12 @@
 
 using namespace google::protobuf;
 
-ProtoOutputStream::ProtoOutputStream(const std::string& filename) :
+ProtoOutputStream::ProtoOutputStream(const std::string& filename,
+                                     bool async) :
     fileStream(filename.c_str(),
             std::ios::out | std::ios::binary | std::ios::trunc),
-    wrappedFileStream(NULL), gzipStream(NULL), zeroCopyStream(NULL)
+    wrappedFileStream(NULL), gzipStream(NULL), zeroCopyStream(NULL),
+    async(async), stopping(false)
 {
     if (!fileStream.good())
         panic("Could not open %s for writing\n", filename);
@@ -69,10 +71,25 @@ ProtoOutputStream::ProtoOutputStream(const std::string& filename) :
 
     // Note that each type of stream (packet, instruction etc) should
     // add its own header and perform the appropriate checks
+
+    if (async) {
+        chunk.reserve(asyncChunkSize);
+        writer = std::thread([this]() { writerLoop(); });
+    }
 }
 
 ProtoOutputStream::~ProtoOutputStream()
 {
+    if (async) {
+        submitChunk();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        writer.join();
+    }
+
     // As the compression is optional, see if the stream exists
     if (gzipStream != NULL)
         delete gzipStream;
@@ -83,6 +100,24 @@ ProtoOutputStream::~ProtoOutputStream()
 void
 ProtoOutputStream::write(const Message& msg)
 {
+    if (async) {
+        // Serialize into memory with the same framing as below, and
+        // leave the compression and file I/O to the writer thread.
+        {
+            io::StringOutputStream string_stream(&chunk);
+            io::CodedOutputStream coded_stream(&string_stream);
+#           if GOOGLE_PROTOBUF_VERSION < 3001000
+                coded_stream.WriteVarint32(msg.ByteSize());
+#           else
+                coded_stream.WriteVarint32(msg.ByteSizeLong());
+#           endif
+            msg.SerializeWithCachedSizes(&coded_stream);
+        }
+        if (chunk.size() >= asyncChunkSize)
+            submitChunk();
+        return;
+    }
+
     // Due to the byte limit of the coded stream we create it for
     // every single mesage (based on forum discussions around the size
     // limitation)
@@ -100,6 +135,48 @@ ProtoOutputStream::write(const Message& msg)
     msg.SerializeWithCachedSizes(&codedStream);
 }
 
+void
+ProtoOutputStream::submitChunk()
+{
+    if (chunk.empty())
+        return;
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        // Block rather than buffer without bound if the writer thread
+        // cannot keep up.
+        cv.wait(lock, [this]() { return pending.size() < asyncMaxPending; });
+        pending.push_back(std::move(chunk));
+    }
+    cv.notify_all();
+
+    chunk.clear();
+    chunk.reserve(asyncChunkSize);
+}
+
+void
+ProtoOutputStream::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        cv.wait(lock, [this]() { return stopping || !pending.empty(); });
+        if (pending.empty())
+            return;
+
+        std::string data = std::move(pending.front());
+        pending.pop_front();
+        lock.unlock();
+        cv.notify_all();
+
+        {
+            io::CodedOutputStream coded_stream(zeroCopyStream);
+            coded_stream.WriteRaw(data.data(), data.size());
+        }
+
+        lock.lock();
+    }
+}
+
 ProtoInputStream::ProtoInputStream(const std::string& filename) :
     fileStream(filename.c_str(), std::ios::in | std::ios::binary),
     fileName(filename), useGzip(false),
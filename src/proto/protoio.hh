@@ -49,7 +49,12 @@
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/message.h>
 
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
 
 /**
  * A ProtoStream provides the shared functionality of the input and
@@ -97,8 +102,10 @@ class ProtoOutputStream : public ProtoStream
      * ends with .gz then the file will be compressed accordinly.
      *
      * @param filename Path to the file to create or truncate
+     * @param async Serialize messages into memory and leave compressing
+     *              and writing them to a background thread
      */
-    ProtoOutputStream(const std::string& filename);
+    ProtoOutputStream(const std::string& filename, bool async = false);
 
     /**
      * Destruct the output stream, and also flush and close the
@@ -116,6 +123,20 @@ class ProtoOutputStream : public ProtoStream
 
   private:
 
+    /**
+     * Size in bytes at which a buffer of serialized messages is handed
+     * to the writer thread, and the number of such buffers that may be
+     * waiting before write() blocks.
+     */
+    static const size_t asyncChunkSize = 1 << 20;
+    static const size_t asyncMaxPending = 8;
+
+    /** Hand the current chunk to the writer thread. */
+    void submitChunk();
+
+    /** Writer thread main loop. */
+    void writerLoop();
+
     /// Underlying file output stream
     std::ofstream fileStream;
 
@@ -128,6 +149,19 @@ class ProtoOutputStream : public ProtoStream
     /// Top-level zero-copy stream, either with compression or not
     google::protobuf::io::ZeroCopyOutputStream* zeroCopyStream;
 
+    /// Whether messages are written by a background thread
+    const bool async;
+
+    /// Serialized messages not yet handed to the writer thread
+    std::string chunk;
+
+    /// Chunks waiting for the writer thread, protected by mutex
+    std::deque<std::string> pending;
+    bool stopping;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread writer;
+
 };
 
 /**
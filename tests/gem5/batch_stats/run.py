@@ -0,0 +1,123 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Runs a binary on two identical systems side by side, one of them with
+batch_stats enabled on its CPU, resetting the stats part way through, and
+checks that both systems report the same stats.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+import m5
+from m5.objects import *
+
+valid_cpu = {
+    "AtomicSimpleCPU": AtomicSimpleCPU,
+    "TimingSimpleCPU": TimingSimpleCPU,
+}
+
+parser = argparse.ArgumentParser()
+parser.add_argument("binary", type=str)
+parser.add_argument("--cpu", choices=valid_cpu.keys(),
+                    default="AtomicSimpleCPU")
+parser.add_argument("--reset-tick", type=int, default=1000000,
+                    help="tick to reset the stats at")
+
+args = parser.parse_args()
+
+
+def make_system(batch_stats):
+    system = System()
+
+    system.workload = SEWorkload.init_compatible(args.binary)
+
+    system.clk_domain = SrcClockDomain()
+    system.clk_domain.clock = "1GHz"
+    system.clk_domain.voltage_domain = VoltageDomain()
+
+    system.mem_mode = valid_cpu[args.cpu].memory_mode()
+    system.mem_ranges = [AddrRange("512MB")]
+    system.membus = SystemXBar()
+
+    system.cpu = valid_cpu[args.cpu](batch_stats=batch_stats)
+    system.cpu.icache_port = system.membus.cpu_side_ports
+    system.cpu.dcache_port = system.membus.cpu_side_ports
+    system.cpu.createInterruptController()
+    if m5.defines.buildEnv["TARGET_ISA"] == "x86":
+        system.cpu.interrupts[0].pio = system.membus.mem_side_ports
+        system.cpu.interrupts[0].int_requestor = \
+            system.membus.cpu_side_ports
+        system.cpu.interrupts[0].int_responder = \
+            system.membus.mem_side_ports
+
+    system.mem_ctrl = SimpleMemory(range=system.mem_ranges[0])
+    system.mem_ctrl.port = system.membus.mem_side_ports
+    system.system_port = system.membus.cpu_side_ports
+
+    system.cpu.workload = Process(cmd=[args.binary])
+    system.cpu.createThreads()
+    return system
+
+
+# system0 updates the stats for every instruction, system1 batches them.
+root = Root(full_system=False)
+root.system0 = make_system(False)
+root.system1 = make_system(True)
+m5.instantiate()
+
+exit_event = m5.simulate(args.reset_tick)
+if exit_event.getCause() != "simulate() limit reached":
+    print("Finished before the stats reset: {}".format(
+        exit_event.getCause()))
+    sys.exit(1)
+m5.stats.reset()
+
+exit_event = m5.simulate()
+if exit_event.getCause() != "exiting with last active thread context":
+    print("Unexpected exit: {}".format(exit_event.getCause()))
+    sys.exit(1)
+m5.stats.dump()
+
+stats = {"system0": {}, "system1": {}}
+with open(os.path.join(m5.options.outdir, "stats.txt")) as f:
+    for line in f:
+        match = re.match(r"(system[01])\.(\S+)\s+(.*?)\s*(#.*)?$", line)
+        if match:
+            stats[match.group(1)][match.group(2)] = match.group(3)
+
+differing = sorted(name for name in stats["system0"].keys() |
+                   stats["system1"].keys()
+                   if stats["system0"].get(name) !=
+                   stats["system1"].get(name))
+for name in differing:
+    print("{}: {} without batch_stats, {} with batch_stats".format(
+        name, stats["system0"].get(name), stats["system1"].get(name)))
+if differing or not stats["system0"]:
+    sys.exit(1)
+
+print("Compared {} stats with and without batch_stats".format(
+    len(stats["system0"])))
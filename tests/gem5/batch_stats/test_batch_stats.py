@@ -0,0 +1,49 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Checks that the simple CPUs report the same stats with batch_stats as
+without, including after a stats reset.
+"""
+
+import re
+
+from testlib import *
+
+binary = joinpath(config.base_dir, "tests", "test-progs", "hello", "bin",
+                  "x86", "linux", "hello")
+
+verifiers = (
+    verifier.MatchRegex(re.compile(r"^Compared \d+ stats with and without "
+                                   r"batch_stats$"), match_stderr=False),
+)
+
+for cpu in ("AtomicSimpleCPU", "TimingSimpleCPU"):
+    gem5_verify_config(
+        name="batch_stats_{}".format(cpu),
+        verifiers=verifiers,
+        fixtures=(),
+        config=joinpath(getcwd(), "run.py"),
+        config_args=["--cpu={}".format(cpu), binary],
+        valid_isas=(constants.vega_x86_tag,),
+    )
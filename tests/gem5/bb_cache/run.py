@@ -0,0 +1,111 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Runs a binary on two identical CPUs side by side, one of them with a cache
+of decoded basic blocks, and checks that both execute the same number of
+instructions and produce the same output.
+"""
+
+import argparse
+import filecmp
+import os
+import sys
+
+import m5
+from m5.objects import *
+
+valid_cpu = {
+    "AtomicSimpleCPU": AtomicSimpleCPU,
+    "NonCachingSimpleCPU": NonCachingSimpleCPU,
+}
+
+parser = argparse.ArgumentParser()
+parser.add_argument("binary", type=str)
+parser.add_argument("--cpu", choices=valid_cpu.keys(),
+                    default="AtomicSimpleCPU")
+parser.add_argument("--bb-cache-entries", type=int, default=256)
+parser.add_argument("--soft-tlb-entries", type=int, default=64,
+                    help="Soft TLB entries of the NonCachingSimpleCPUs")
+
+args = parser.parse_args()
+
+system = System()
+
+system.workload = SEWorkload.init_compatible(args.binary)
+
+system.clk_domain = SrcClockDomain()
+system.clk_domain.clock = "1GHz"
+system.clk_domain.voltage_domain = VoltageDomain()
+
+system.mem_mode = valid_cpu[args.cpu].memory_mode()
+system.mem_ranges = [AddrRange("512MB")]
+system.membus = SystemXBar()
+
+# cpu[0] fetches and decodes every instruction, cpu[1] replays cached
+# basic blocks.
+system.cpu = [valid_cpu[args.cpu](cpu_id=i) for i in range(2)]
+system.cpu[1].bb_cache_entries = args.bb_cache_entries
+outputs = []
+for i, cpu in enumerate(system.cpu):
+    if args.cpu == "NonCachingSimpleCPU":
+        cpu.soft_tlb_entries = args.soft_tlb_entries
+    cpu.icache_port = system.membus.cpu_side_ports
+    cpu.dcache_port = system.membus.cpu_side_ports
+    cpu.createInterruptController()
+    if m5.defines.buildEnv["TARGET_ISA"] == "x86":
+        cpu.interrupts[0].pio = system.membus.mem_side_ports
+        cpu.interrupts[0].int_requestor = system.membus.cpu_side_ports
+        cpu.interrupts[0].int_responder = system.membus.mem_side_ports
+
+    outputs.append("cpu{}.out".format(i))
+    process = Process(pid=100 + i, cmd=[args.binary], output=outputs[i])
+    cpu.workload = process
+    cpu.createThreads()
+
+system.mem_ctrl = SimpleMemory(range=system.mem_ranges[0])
+system.mem_ctrl.port = system.membus.mem_side_ports
+system.system_port = system.membus.cpu_side_ports
+
+root = Root(full_system=False, system=system)
+m5.instantiate()
+
+exit_event = m5.simulate()
+
+if exit_event.getCause() != "exiting with last active thread context":
+    print("Unexpected exit: {}".format(exit_event.getCause()))
+    sys.exit(1)
+
+insts = [cpu.totalInsts() for cpu in system.cpu]
+print("Instructions executed: {} and {} with cached basic blocks".format(
+    *insts))
+if insts[0] != insts[1]:
+    sys.exit(1)
+
+outputs = [os.path.join(m5.options.outdir, out) for out in outputs]
+if not filecmp.cmp(*outputs, shallow=False):
+    print("Output differs with cached basic blocks")
+    sys.exit(1)
+
+with open(outputs[0]) as f:
+    sys.stdout.write(f.read())
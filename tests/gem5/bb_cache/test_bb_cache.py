@@ -0,0 +1,67 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Checks that replaying cached basic blocks executes the same instructions
+as fetching and decoding them, including for code modified while cached.
+"""
+
+import re
+import sys
+
+from testlib import *
+from testlib.helper import log_call
+import testlib.log as log
+
+src_dir = joinpath(config.base_dir, "tests", "test-progs", "bb-cache", "src")
+binary = joinpath(src_dir, "bb-cache")
+
+class BbCacheProgram(Fixture):
+    """Builds the test program from source with the host's compiler."""
+
+    def __init__(self):
+        super().__init__(name="bb-cache-program")
+
+    def setup(self, testitem):
+        log_call(log.test_log, ["make", "-C", src_dir, "bb-cache"],
+                 time=None, stderr=sys.stderr)
+
+program = BbCacheProgram()
+
+verifiers = (
+    verifier.MatchRegex(re.compile(r"^Instructions executed: (\d+) and \1 "
+                                   r"with cached basic blocks$", re.M),
+                        match_stderr=False),
+    verifier.MatchRegex(re.compile(r"^replaced code: 42 \(expected 42\)$",
+                                   re.M), match_stderr=False),
+)
+
+for cpu in ("AtomicSimpleCPU", "NonCachingSimpleCPU"):
+    gem5_verify_config(
+        name="bb_cache_replay_{}".format(cpu),
+        verifiers=verifiers,
+        fixtures=(program,),
+        config=joinpath(getcwd(), "run.py"),
+        config_args=["--cpu={}".format(cpu), binary],
+        valid_isas=(constants.vega_x86_tag,),
+    )
@@ -0,0 +1,87 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Exercises a simulated CPU's cache of decoded basic blocks: a hot loop
+ * which replays the same blocks many times, and code which is rewritten
+ * while it is cached. The output only depends on the instructions
+ * executed, so it must not change with the cache enabled.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+typedef uint32_t (*func_t)(uint32_t);
+
+/* add $imm32, %edi; mov %edi, %eax; ret */
+static void
+emit(uint8_t *code, uint32_t imm)
+{
+    code[0] = 0x81;
+    code[1] = 0xc7;
+    memcpy(code + 2, &imm, sizeof(imm));
+    code[6] = 0x89;
+    code[7] = 0xf8;
+    code[8] = 0xc3;
+}
+
+int
+main(int argc, char *argv[])
+{
+    uint8_t *code = mmap(NULL, 4096, PROT_READ | PROT_WRITE | PROT_EXEC,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED) {
+        printf("mmap failed\n");
+        return 1;
+    }
+    func_t func = (func_t)code;
+
+    /* Rewrite the function every few calls, once it has been cached. */
+    uint64_t sum = 0, expected = 0;
+    for (uint32_t i = 0; i < 1000; i++) {
+        if (i % 10 == 0)
+            emit(code, i);
+        sum += func(i);
+        expected += i + i / 10 * 10;
+    }
+    printf("patched code: %llu (expected %llu)\n",
+           (unsigned long long)sum, (unsigned long long)expected);
+
+    /* Replace the function by one of a different length in place. */
+    code[0] = 0x8d;  /* lea 1(%rdi), %eax; ret */
+    code[1] = 0x47;
+    code[2] = 0x01;
+    code[3] = 0xc3;
+    printf("replaced code: %u (expected 42)\n", func(41));
+
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (uint32_t i = 0; i < 100000; i++)
+        hash = (hash ^ (i & 0xff)) * 0x100000001b3ULL;
+    printf("hash: %#llx\n", (unsigned long long)hash);
+
+    return sum != expected || func(41) != 42;
+}
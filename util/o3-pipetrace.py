@@ -0,0 +1,197 @@
+#! /usr/bin/env python3
+
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Convert a binary pipeline trace written by the O3 PipeTrace probe
+# listener (src/cpu/o3/probe/pipe_trace.hh) into the O3PipeView text
+# format read by o3-pipeview.py. Only the blocks that overlap the
+# requested tick or instruction range are decompressed, so a small region
+# can be extracted quickly from a very large trace.
+
+import argparse
+import array
+import struct
+import sys
+import zlib
+
+FILE_HEADER = struct.Struct('=8sIIQ')
+BLOCK_HEADER = struct.Struct('=6I4Q')
+MAGIC = b'gem5o3pt'
+VERSION = 1
+STAGES = ['decode', 'rename', 'dispatch', 'issue', 'complete']
+
+
+def read_strings(data, count, strings):
+    pos = 0
+    for _ in range(count):
+        (length,) = struct.unpack_from('=I', data, pos)
+        pos += 4
+        strings.append(data[pos:pos + length].decode('utf-8', 'replace'))
+        pos += length
+
+
+def column(data, pos, typecode, n):
+    col = array.array(typecode)
+    end = pos + n * col.itemsize
+    col.frombytes(data[pos:end])
+    return col, end
+
+
+def undelta(col):
+    total = 0
+    mask = (1 << 64) - 1
+    for i, d in enumerate(col):
+        total = (total + d) & mask
+        col[i] = total
+    return col
+
+
+def in_range(lo, hi, start, stop):
+    return hi >= start and (stop < 0 or lo <= stop)
+
+
+def convert(trace, out, tick_range, inst_range):
+    header = trace.read(FILE_HEADER.size)
+    if len(header) != FILE_HEADER.size:
+        sys.exit('Trace file is truncated')
+    magic, version, num_stages, _ = FILE_HEADER.unpack(header)
+    if magic != MAGIC:
+        sys.exit('Not a pipeline trace (bad magic)')
+    if version != VERSION or num_stages != len(STAGES) + 2:
+        sys.exit('Unsupported pipeline trace version %d' % version)
+
+    tick_start, tick_stop = tick_range
+    sn_start, sn_stop = inst_range
+    strings = []
+
+    while True:
+        raw = trace.read(BLOCK_HEADER.size)
+        if not raw:
+            break
+        if len(raw) != BLOCK_HEADER.size:
+            sys.exit('Trace file is truncated')
+        (n, num_strings, string_bytes, string_zbytes, record_zbytes, _,
+         min_tick, max_tick, min_sn, max_sn) = BLOCK_HEADER.unpack(raw)
+
+        # String ids are assigned in file order, so the string table of
+        # every block has to be read even when its records are skipped.
+        if num_strings:
+            data = zlib.decompress(trace.read(string_zbytes))
+            assert len(data) == string_bytes
+            read_strings(data, num_strings, strings)
+        else:
+            trace.seek(string_zbytes, 1)
+
+        # Instructions are recorded as they are destroyed, which is
+        # roughly in fetch order, so stop at the first block that starts
+        # after the end of the region.
+        if ((tick_stop >= 0 and min_tick > tick_stop) or
+                (sn_stop >= 0 and min_sn > sn_stop)):
+            break
+        if not (in_range(min_tick, max_tick, tick_start, tick_stop) and
+                in_range(min_sn, max_sn, sn_start, sn_stop)):
+            trace.seek(record_zbytes, 1)
+            continue
+
+        data = zlib.decompress(trace.read(record_zbytes))
+        pos = 0
+        fetch, pos = column(data, pos, 'Q', n)
+        seq, pos = column(data, pos, 'Q', n)
+        pc, pos = column(data, pos, 'Q', n)
+        disasm, pos = column(data, pos, 'I', n)
+        upc, pos = column(data, pos, 'H', n)
+        stages = []
+        for _ in range(num_stages):
+            col, pos = column(data, pos, 'i', n)
+            stages.append(col)
+        undelta(fetch)
+        undelta(seq)
+
+        lines = []
+        for i in range(n):
+            f = fetch[i]
+            if f < tick_start or (tick_stop >= 0 and f > tick_stop):
+                continue
+            if seq[i] < sn_start or (sn_stop >= 0 and seq[i] > sn_stop):
+                continue
+            lines.append('O3PipeView:fetch:%d:0x%08x:%d:%d:%s\n' %
+                         (f, pc[i], upc[i], seq[i], strings[disasm[i]]))
+            for name, col in zip(STAGES, stages):
+                lines.append('O3PipeView:%s:%d\n' %
+                             (name, 0 if col[i] == -1 else f + col[i]))
+            retire = stages[len(STAGES)][i]
+            store = stages[len(STAGES) + 1][i]
+            lines.append('O3PipeView:retire:%d:store:%d\n' %
+                         (0 if retire == -1 else f + retire,
+                          0 if store == -1 else f + store))
+        out.writelines(lines)
+
+
+def parse_range(parser, text):
+    try:
+        lo, hi = [int(i) for i in text.split(':')]
+    except ValueError:
+        parser.error('invalid range %s' % text)
+    if lo < 0 or (hi >= 0 and lo > hi):
+        parser.error('invalid range %s' % text)
+    return lo, hi
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        usage='%(prog)s [OPTION]... TRACE_FILE',
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+    parser.add_argument(
+        '-o',
+        dest='outfile',
+        default='-',
+        help="output file for the O3PipeView text trace, '-' for stdout")
+    parser.add_argument(
+        '-t',
+        dest='tick_range',
+        default='0:-1',
+        help="range of fetch ticks to convert (e.g., 10000:20000; -1 means "
+             "no upper limit)")
+    parser.add_argument(
+        '-i',
+        dest='inst_range',
+        default='0:-1',
+        help="range of instruction sequence numbers to convert")
+    parser.add_argument(
+        'tracefile')
+
+    args = parser.parse_args()
+    tick_range = parse_range(parser, args.tick_range)
+    inst_range = parse_range(parser, args.inst_range)
+
+    with open(args.tracefile, 'rb') as trace:
+        if args.outfile == '-':
+            convert(trace, sys.stdout, tick_range, inst_range)
+        else:
+            with open(args.outfile, 'w') as out:
+                convert(trace, out, tick_range, inst_range)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script converts a protobuf elastic data dependency trace into the
+# packed layout read by the Trace CPU (see src/cpu/trace/packed_trace.hh).
+# The Trace CPU replays either format; the packed one is mapped into memory
+# and read in place instead of being decoded record by record.
+#
+# The packed file holds a header, an array of fixed size records and an
+# array of 64-bit dependency sequence numbers. Each record points at its
+# order dependencies followed by its register dependencies in the latter.
+#
+# Usage: pack_inst_dep_trace.py <protobuf input> <packed output>
+
+import array
+import struct
+import sys
+
+import protolib
+
+# Import the packet proto definitions. If they are not found, attempt
+# to generate them automatically. This assumes that the script is
+# executed from the gem5 root.
+try:
+    import inst_dep_record_pb2
+except:
+    print("Did not find proto definition, attempting to generate")
+    from subprocess import call
+    error = call(['protoc', '--python_out=util', '--proto_path=src/proto',
+                  'src/proto/inst_dep_record.proto'])
+    if not error:
+        import inst_dep_record_pb2
+        print("Generated proto definitions for instruction dependency record")
+    else:
+        print("Failed to import proto definitions")
+        exit(-1)
+
+# These must match PackedDepTrace::Magic, Version, Header and Record
+MAGIC = b'G5PKDEP\0'
+VERSION = 1
+# magic, version, window size, tick freq, number of records, number of
+# dependencies, records offset, dependencies offset
+HEADER = struct.Struct('<8sIIQQQQQ')
+# seq num, phys addr, virt addr, pc, comp delay, dependency index, size,
+# flags, weight, type, number of order deps, number of register deps, pad
+RECORD = struct.Struct('<QQQQQQIIIBBBB')
+RECORD_OFFSET = 64
+MAX_DEPS = 255
+
+def main():
+    if len(sys.argv) != 3:
+        print("Usage: ", sys.argv[0], " <protobuf input> <packed output>")
+        exit(-1)
+
+    proto_in = protolib.openFileRd(sys.argv[1])
+
+    try:
+        packed_out = open(sys.argv[2], 'wb')
+    except IOError:
+        print("Failed to open ", sys.argv[2], " for writing")
+        exit(-1)
+
+    if proto_in.read(4) != b'gem5':
+        print("Unrecognized file")
+        exit(-1)
+
+    header = inst_dep_record_pb2.InstDepRecordHeader()
+    protolib.decodeMessage(proto_in, header)
+
+    print("Object id:", header.obj_id)
+    print("Tick frequency:", header.tick_freq)
+    print("Window size:", header.window_size)
+
+    records = bytearray()
+    deps = array.array('Q')
+    num_records = 0
+    packet = inst_dep_record_pb2.InstDepRecord()
+
+    while protolib.decodeMessage(proto_in, packet):
+        rob_deps = list(packet.rob_dep)
+        # Like the protobuf reader in the Trace CPU, omit a register
+        # dependency on an instruction that is also an order dependency.
+        reg_deps = [dep for dep in packet.reg_dep if dep not in rob_deps]
+
+        if len(rob_deps) > MAX_DEPS or len(reg_deps) > MAX_DEPS:
+            print("Seq. num", packet.seq_num, "has more than", MAX_DEPS,
+                  "dependencies of one kind")
+            exit(-1)
+
+        records += RECORD.pack(packet.seq_num, packet.p_addr, packet.v_addr,
+                               packet.pc, packet.comp_delay, len(deps),
+                               packet.size, packet.flags, packet.weight,
+                               packet.type, len(rob_deps), len(reg_deps), 0)
+        deps.extend(rob_deps)
+        deps.extend(reg_deps)
+        num_records += 1
+
+    deps_offset = RECORD_OFFSET + len(records)
+    packed_out.write(HEADER.pack(MAGIC, VERSION, header.window_size,
+                                 header.tick_freq, num_records, len(deps),
+                                 RECORD_OFFSET, deps_offset))
+    packed_out.write(bytes(RECORD_OFFSET - HEADER.size))
+    packed_out.write(records)
+    if sys.byteorder != 'little':
+        deps.byteswap()
+    packed_out.write(deps.tobytes())
+
+    print("Packed", num_records, "records with", len(deps), "dependencies")
+
+    proto_in.close()
+    packed_out.close()
+
+if __name__ == "__main__":
+    main()